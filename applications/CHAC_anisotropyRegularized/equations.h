@@ -52,7 +52,8 @@ void variableAttributeLoader::loadVariableAttributes(){
 // the index given at the top of this file.
 
 template <int dim, int degree>
-void customPDE<dim,degree>::residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+template <typename containerType>
+void customPDE<dim,degree>::residualRHS(containerType & variable_list,
 				 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
 
 // Concentration
@@ -141,6 +142,7 @@ variable_list.set_scalar_gradient_residual_term(2,rbiharmxV);
 // "this->currentFieldIndex".
 
 template <int dim, int degree>
-void customPDE<dim,degree>::residualLHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+template <typename containerType>
+void customPDE<dim,degree>::residualLHS(containerType & variable_list,
 		dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
 }
@@ -1,5 +1,16 @@
 // List of residual equations for the coupled Allen-Cahn example application
 
+// The formulation of the time stepping:
+//   0: all of the terms are explicit
+//   1: semi-implicit (IMEX), the gradient energy term is linear in n, so it is treated implicitly: it is given in
+//      residualLHS instead of residualRHS, and the new value of n is found with the same iterative solver as for the
+//      elliptic equations. The time step is then no longer limited by the element size (the time step can be
+//      increased to 1.0e-1 in parameters.in).
+//   2: operator splitting, the bulk driving force only depends on the value of n at each point, so it is a local
+//      reaction term: it is given in reactionRates instead of residualRHS, and is integrated at each DOF separately
+//      (Strang splitting, see "Local reaction tolerance" in parameters.in)
+#define ALLEN_CAHN_FORMULATION 0
+
 // =================================================================================
 // Set the attributes of the primary field variables
 // =================================================================================
@@ -9,12 +20,34 @@ void variableAttributeLoader::loadVariableAttributes(){
 	set_variable_type				(0,SCALAR);
 	set_variable_equation_type		(0,PARABOLIC);
 
+	#if (ALLEN_CAHN_FORMULATION == 1)
+	set_implicit_linear_terms		(0,true);
+
+	set_need_value					(0,true);
+	set_need_gradient				(0,false);
+	set_need_hessian				(0,false);
+
+	set_need_value_residual_term	(0,true);
+	set_need_gradient_residual_term	(0,false);
+
+	set_need_value_LHS				(0,true);
+	set_need_gradient_LHS			(0,true);
+	set_need_hessian_LHS			(0,false);
+
+	set_need_value_residual_term_LHS	(0,true);
+	set_need_gradient_residual_term_LHS	(0,true);
+	#else
+	#if (ALLEN_CAHN_FORMULATION == 2)
+	set_local_reaction_terms		(0,true);
+	#endif
+
 	set_need_value					(0,true);
 	set_need_gradient				(0,true);
 	set_need_hessian				(0,false);
 
 	set_need_value_residual_term	(0,true);
 	set_need_gradient_residual_term	(0,true);
+	#endif
 }
 
 // =================================================================================
@@ -27,28 +60,84 @@ void variableAttributeLoader::loadVariableAttributes(){
 // to variable_list. The index for each variable in this list corresponds to
 // the index given at the top of this file.
 
+// The residual equations are written as a template on the container type, so that the same equations are used for
+// the default double precision residuals, the optional single precision residuals ('Residual precision' in
+// parameters.in) and the tracing of the variable needs. Within this function, scalarvalueType and scalargradType use
+// the number type of the container.
 template <int dim, int degree>
-void customPDE<dim,degree>::residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
-				 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
+template <typename containerType>
+void customPDE<dim,degree>::residualRHSTemplate(containerType & variable_list,
+				 dealii::Point<dim, dealii::VectorizedArray<typename containerType::number> > q_point_loc) const {
+
+typedef typename containerType::number number;
+typedef dealii::VectorizedArray<number> scalarvalueType;
+typedef dealii::Tensor<1, dim, dealii::VectorizedArray<number> > scalargradType;
 
 // The order parameter and its derivatives 
 scalarvalueType n = variable_list.get_scalar_value(0);
+#if (ALLEN_CAHN_FORMULATION != 1)
 scalargradType nx = variable_list.get_scalar_gradient(0);
+#endif
 
 // Parameters in the residual equations and expressions for the residual equations
 // can be set here.
+#if (ALLEN_CAHN_FORMULATION == 2)
+// The bulk driving force is left out (see reactionRates below)
+scalarvalueType rnV = n;
+#else
 scalarvalueType fnV = (4.0*n*(n-1.0)*(n-0.5));
-scalarvalueType rnV = (n-constV(userInputs.dtValue*MnV)*fnV);
-scalargradType rnxV = (-constV(userInputs.dtValue*KnV*MnV)*nx);
+scalarvalueType rnV = (n-dealii::make_vectorized_array<number>(userInputs.dtValue*MnV)*fnV);
+#endif
 
 // Residuals for the equation to evolve the order parameter 
 variable_list.set_scalar_value_residual_term(0,rnV);
+
+// With the semi-implicit formulation the gradient energy term is in residualLHS
+#if (ALLEN_CAHN_FORMULATION != 1)
+scalargradType rnxV = (-dealii::make_vectorized_array<number>(userInputs.dtValue*KnV*MnV)*nx);
 variable_list.set_scalar_gradient_residual_term(0,rnxV);
+#endif
 
 }
 
+template <int dim, int degree>
+template <typename containerType>
+void customPDE<dim,degree>::residualRHS(containerType & variable_list,
+				 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
+	residualRHSTemplate(variable_list,q_point_loc);
+}
+
+template <int dim, int degree>
+void customPDE<dim,degree>::residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<float> > & variable_list,
+				 dealii::Point<dim, dealii::VectorizedArray<float> > q_point_loc) const {
+	residualRHSTemplate(variable_list,q_point_loc);
+}
+
 // =================================================================================
-// residualLHS (needed only if at least one equation is elliptic)
+// reactionRates (needed only if there are local reaction terms)
+// =================================================================================
+// This function calculates the rates of change from the local reaction terms of
+// the variables declared with "set_local_reaction_terms" above. It takes "values",
+// the values of the scalar variables at a batch of DOFs, and outputs the rates
+// to "rates" (both are indexed by the index given at the top of this file). The
+// reaction terms are integrated over each time step with an adaptive Runge-Kutta
+// method at each DOF, so they can't depend on the derivatives of the variables.
+
+template <int dim, int degree>
+void customPDE<dim,degree>::reactionRates(const std::vector<dealii::VectorizedArray<double> > & values,
+				 std::vector<dealii::VectorizedArray<double> > & rates) const {
+
+// The order parameter
+scalarvalueType n = values[0];
+
+// The bulk driving force
+scalarvalueType fnV = (4.0*n*(n-1.0)*(n-0.5));
+rates[0] = -constV(MnV)*fnV;
+
+}
+
+// =================================================================================
+// residualLHS (needed only if at least one equation is elliptic or has implicit linear terms)
 // =================================================================================
 // This function calculates the residual equations for the iterative solver for
 // elliptic equations.for each variable. It takes "variable_list" as an input,
@@ -60,9 +149,26 @@ variable_list.set_scalar_gradient_residual_term(0,rnxV);
 // the index given at the top of this file. If there are multiple elliptic equations,
 // conditional statements should be used to ensure that the correct residual is
 // being submitted. The index of the field being solved can be accessed by
-// "this->currentFieldIndex".
+// "this->currentFieldIndex". For an equation with implicit linear terms, it
+// applies the mass matrix plus the time step times the implicit terms to the value
+// of the variable being solved for, which is the new value of the variable.
 
 template <int dim, int degree>
-void customPDE<dim,degree>::residualLHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+template <typename containerType>
+void customPDE<dim,degree>::residualLHS(containerType & variable_list,
 		dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
+
+#if (ALLEN_CAHN_FORMULATION == 1)
+// The new value of the order parameter and its gradient
+scalarvalueType n = variable_list.get_scalar_value(0);
+scalargradType nx = variable_list.get_scalar_gradient(0);
+
+// Mass matrix term and the implicit gradient energy term
+scalarvalueType rnV = n;
+scalargradType rnxV = (constV(userInputs.dtValue*KnV*MnV)*nx);
+
+variable_list.set_scalar_value_residual_term(0,rnV);
+variable_list.set_scalar_gradient_residual_term(0,rnxV);
+#endif
+
 }
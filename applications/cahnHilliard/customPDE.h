@@ -11,12 +11,23 @@ private:
 
 	const userInputParameters<dim> userInputs;
 
-	// Pure virtual method in MatrixFreePDE
-	void residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+	// Pure virtual method in MatrixFreePDE (a template on the container type, see staticResidualDispatch.h)
+	template <typename containerType>
+	void residualRHS(containerType & variable_list,
 					 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const;
 
-	// Pure virtual method in MatrixFreePDE
-	void residualLHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+	// Virtual method in MatrixFreePDE, single precision version of residualRHS (used if 'Residual precision' is 'single')
+	void residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<float> > & variable_list,
+					 dealii::Point<dim, dealii::VectorizedArray<float> > q_point_loc) const;
+
+	// The residual equations, written once for both precisions (and for the tracing container)
+	template <typename containerType>
+	void residualRHSTemplate(containerType & variable_list,
+					 dealii::Point<dim, dealii::VectorizedArray<typename containerType::number> > q_point_loc) const;
+
+	// Pure virtual method in MatrixFreePDE (a template on the container type, see staticResidualDispatch.h)
+	template <typename containerType>
+	void residualLHS(containerType & variable_list,
 					 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const;
 
 	// Virtual method in MatrixFreePDE that we override if we need postprocessing
@@ -31,6 +42,10 @@ private:
 	double getNucleationProbability(variableValueContainer variable_value, double dV) const;
 	#endif
 
+	// Overrides of getRHS, getLHS and getPostProcessedFields in MatrixFreePDE that call the residual methods
+	// of this class directly, so they can be inlined into the quadrature point loops
+	#include "../../include/staticResidualDispatch.h"
+
 	// ================================================================
 	// Methods specific to this subclass
 	// ================================================================
@@ -41,9 +41,18 @@ void variableAttributeLoader::loadVariableAttributes(){
 // to variable_list. The index for each variable in this list corresponds to
 // the index given at the top of this file.
 
+// The residual equations are written as a template on the container type, so that the same equations are used for
+// the default double precision residuals, the optional single precision residuals ('Residual precision' in
+// parameters.in) and the tracing of the variable needs. Within this function, scalarvalueType and scalargradType use
+// the number type of the container.
 template <int dim, int degree>
-void customPDE<dim,degree>::residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
-				 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
+template <typename containerType>
+void customPDE<dim,degree>::residualRHSTemplate(containerType & variable_list,
+				 dealii::Point<dim, dealii::VectorizedArray<typename containerType::number> > q_point_loc) const {
+
+typedef typename containerType::number number;
+typedef dealii::VectorizedArray<number> scalarvalueType;
+typedef dealii::Tensor<1, dim, dealii::VectorizedArray<number> > scalargradType;
 
 // The concentration and its derivatives 
 scalarvalueType c = variable_list.get_scalar_value(0);
@@ -60,9 +69,9 @@ scalarvalueType fcV = 4.0*c*(c-1.0)*(c-0.5);
 
 // The residuals
 scalarvalueType rcV = c;
-scalargradType rcxV = constV(-McV*userInputs.dtValue)*mux;
+scalargradType rcxV = dealii::make_vectorized_array<number>(-McV*userInputs.dtValue)*mux;
 scalarvalueType rmuV = fcV;
-scalargradType rmuxV = constV(KcV)*cx;
+scalargradType rmuxV = dealii::make_vectorized_array<number>(KcV)*cx;
 
 // Residuals for the equation to evolve the concentration 
 variable_list.set_scalar_value_residual_term(0,rcV);
@@ -74,6 +83,19 @@ variable_list.set_scalar_gradient_residual_term(1,rmuxV);
 
 }
 
+template <int dim, int degree>
+template <typename containerType>
+void customPDE<dim,degree>::residualRHS(containerType & variable_list,
+				 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
+	residualRHSTemplate(variable_list,q_point_loc);
+}
+
+template <int dim, int degree>
+void customPDE<dim,degree>::residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<float> > & variable_list,
+				 dealii::Point<dim, dealii::VectorizedArray<float> > q_point_loc) const {
+	residualRHSTemplate(variable_list,q_point_loc);
+}
+
 // =================================================================================
 // residualLHS (needed only if at least one equation is elliptic)
 // =================================================================================
@@ -90,6 +112,7 @@ variable_list.set_scalar_gradient_residual_term(1,rmuxV);
 // "this->currentFieldIndex".
 
 template <int dim, int degree>
-void customPDE<dim,degree>::residualLHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+template <typename containerType>
+void customPDE<dim,degree>::residualLHS(containerType & variable_list,
 		dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
 }
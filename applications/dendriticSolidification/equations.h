@@ -16,6 +16,11 @@ void variableAttributeLoader::loadVariableAttributes(){
 	set_need_value_residual_term	(0,true);
 	set_need_gradient_residual_term	(0,true);
 
+	// The temperature diffuses much faster than the interface moves, so it can take several substeps in each time
+	// step (with the time step in parameters.in increased by the same factor). residualRHS skips the residuals of phi
+	// and mu in those substeps, so they only evaluate the temperature residual, for example:
+	// set_subcycling_steps		(0,4);
+
     // Variable 1
 	set_variable_name				(1,"phi");
 	set_variable_type				(1,SCALAR);
@@ -62,29 +67,23 @@ void variableAttributeLoader::loadVariableAttributes(){
 // the index given at the top of this file.
 
 template <int dim, int degree>
-void customPDE<dim,degree>::residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+template <typename containerType>
+void customPDE<dim,degree>::residualRHS(containerType & variable_list,
 				 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
 
 // The temperature and its derivatives
 scalarvalueType u = variable_list.get_scalar_value(0);
 scalargradType ux = variable_list.get_scalar_gradient(0);
 
-// The order parameter and its derivatives
-scalarvalueType phi = variable_list.get_scalar_value(1);
+// The gradient of the order parameter
 scalargradType phix = variable_list.get_scalar_gradient(1);
 
 // The order parameter chemical potential and its derivatives
 scalarvalueType mu = variable_list.get_scalar_value(2);
 
-// The coupling constant, determined from solvability theory
-double lambda = (D/0.6267/W0/W0);
-
-// Derivative of the free energy density with respect to phi
-scalarvalueType f_phi = -(phi-constV(lambda)*u*(constV(1.0)-phi*phi))*(constV(1.0)-phi*phi);
-
 // The azimuthal angle
 scalarvalueType theta;
-for (unsigned i=0; i< phi.n_array_elements;i++){
+for (unsigned i=0; i< theta.n_array_elements;i++){
 	theta[i] = std::atan2(phix[1][i],phix[0][i]);
 }
 
@@ -93,28 +92,39 @@ scalarvalueType W = constV(W0)*(constV(1.0)+constV(epsilonM)*std::cos(constV(mul
 scalarvalueType W_theta = constV(-W0)*(constV(epsilonM)*constV(mult)*std::sin(constV(mult)*(theta-constV(theta0))));
 scalarvalueType tau = W/constV(W0);
 
-// The anisotropy term that enters in to the residual equation for mu
-scalargradType aniso;
-aniso[0] = W*W*phix[0]-W*W_theta*phix[1];
-aniso[1] = W*W*phix[1]+W*W_theta*phix[0];
-
-// Define required residuals
+// Residuals for the equation to evolve the concentration
 scalarvalueType ruV = (u+constV(0.5)*mu*constV(userInputs.dtValue)/tau);
 scalargradType ruxV = (constV(-D*userInputs.dtValue)*ux);
-scalarvalueType rphiV = (phi+constV(userInputs.dtValue)*mu/tau);
-scalarvalueType rmuV = (-f_phi);
-scalargradType rmuxV = (-aniso);
-
-// Residuals for the equation to evolve the concentration
 variable_list.set_scalar_value_residual_term(0,ruV);
 variable_list.set_scalar_gradient_residual_term(0,ruxV);
 
-// Residuals for the equation to evolve the order parameter
-variable_list.set_scalar_value_residual_term(1,rphiV);
+// The residuals of phi and mu aren't needed in the substeps where only the temperature is updated (see
+// set_subcycling_steps above)
+if (this->residualNeeded(1) || this->residualNeeded(2)){
+	// The order parameter
+	scalarvalueType phi = variable_list.get_scalar_value(1);
+
+	// Residuals for the equation to evolve the order parameter
+	scalarvalueType rphiV = (phi+constV(userInputs.dtValue)*mu/tau);
+	variable_list.set_scalar_value_residual_term(1,rphiV);
+
+	// The coupling constant, determined from solvability theory
+	double lambda = (D/0.6267/W0/W0);
 
-// Residuals for the equation to evolve the order parameter chemical potential
-variable_list.set_scalar_value_residual_term(2,rmuV);
-variable_list.set_scalar_gradient_residual_term(2,rmuxV);
+	// Derivative of the free energy density with respect to phi
+	scalarvalueType f_phi = -(phi-constV(lambda)*u*(constV(1.0)-phi*phi))*(constV(1.0)-phi*phi);
+
+	// The anisotropy term that enters in to the residual equation for mu
+	scalargradType aniso;
+	aniso[0] = W*W*phix[0]-W*W_theta*phix[1];
+	aniso[1] = W*W*phix[1]+W*W_theta*phix[0];
+
+	// Residuals for the equation to evolve the order parameter chemical potential
+	scalarvalueType rmuV = (-f_phi);
+	scalargradType rmuxV = (-aniso);
+	variable_list.set_scalar_value_residual_term(2,rmuV);
+	variable_list.set_scalar_gradient_residual_term(2,rmuxV);
+}
 
 }
 
@@ -134,6 +144,7 @@ variable_list.set_scalar_gradient_residual_term(2,rmuxV);
 // "this->currentFieldIndex".
 
 template <int dim, int degree>
-void customPDE<dim,degree>::residualLHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+template <typename containerType>
+void customPDE<dim,degree>::residualLHS(containerType & variable_list,
 		dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
 }
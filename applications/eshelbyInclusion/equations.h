@@ -23,6 +23,8 @@ void variableAttributeLoader::loadVariableAttributes(){
 	set_need_value_residual_term_LHS(0,false);
 	set_need_gradient_residual_term_LHS	(0,true);
 
+	// The residual equations depend on the location of the quadrature points ("q_point_loc")
+	set_need_q_point_locations		(true);
 }
 
 // =================================================================================
@@ -36,7 +38,8 @@ void variableAttributeLoader::loadVariableAttributes(){
 // the index given at the top of this file.
 
 template <int dim, int degree>
-void customPDE<dim,degree>::residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+template <typename containerType>
+void customPDE<dim,degree>::residualRHS(containerType & variable_list,
 				 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
 
 //u
@@ -108,7 +111,8 @@ variable_list.set_vector_gradient_residual_term(0,Rux);
 // that the correct residual is being submitted. The index of the field being solved
 // can be accessed by "this->currentFieldIndex".
 template <int dim, int degree>
-void customPDE<dim,degree>::residualLHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+template <typename containerType>
+void customPDE<dim,degree>::residualLHS(containerType & variable_list,
 		dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
 
 //u
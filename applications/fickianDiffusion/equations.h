@@ -16,6 +16,8 @@ void variableAttributeLoader::loadVariableAttributes(){
 	set_need_value_residual_term	(0,true);
 	set_need_gradient_residual_term	(0,true);
 
+	// The residual equations depend on the location of the quadrature points ("q_point_loc")
+	set_need_q_point_locations		(true);
 }
 
 // =================================================================================
@@ -29,7 +31,8 @@ void variableAttributeLoader::loadVariableAttributes(){
 // the index given at the top of this file.
 
 template <int dim, int degree>
-void customPDE<dim,degree>::residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+template <typename containerType>
+void customPDE<dim,degree>::residualRHS(containerType & variable_list,
 				 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
 
 
@@ -86,6 +89,7 @@ variable_list.set_scalar_gradient_residual_term(0,rcxV);
 // "this->currentFieldIndex".
 
 template <int dim, int degree>
-void customPDE<dim,degree>::residualLHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+template <typename containerType>
+void customPDE<dim,degree>::residualLHS(containerType & variable_list,
 		dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
 }
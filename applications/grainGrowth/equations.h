@@ -137,7 +137,8 @@ void variableAttributeLoader::loadVariableAttributes(){
 // the index given at the top of this file.
 
 template <int dim, int degree>
-void customPDE<dim,degree>::residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+template <typename containerType>
+void customPDE<dim,degree>::residualRHS(containerType & variable_list,
 				 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
 
 
@@ -145,16 +146,12 @@ dealii::VectorizedArray<double> fnV = constV(0.0);
 scalarvalueType ni, nj;
 scalargradType nix;
 
-// In this application, create temporary variables for the residual terms. We cannot
-// call 'set_scalar_value_residual_term' and 'set_scalar_gradient_residual_term'in the
+// In this application, the residual terms are staged rather than set directly. We cannot
+// call 'set_scalar_value_residual_term' and 'set_scalar_gradient_residual_term' in the
 // for loop below because those functions write over the scalar value and scalar gradient
-// internal variables in 'variable_list' (for performance reasons). Therefore, we wait
-// to set the residual terms until all the residuals have been calculated.
-
-std::vector<scalarvalueType> value_residuals;
-value_residuals.resize(userInputs.number_of_variables);
-std::vector<scalargradType> gradient_residuals;
-gradient_residuals.resize(userInputs.number_of_variables);
+// internal variables in 'variable_list' (for performance reasons). The staged terms are
+// held in storage preallocated in 'variable_list' and are set by the call to
+// 'apply_staged_residuals' once all the residuals have been calculated.
 
 for (unsigned int i=0; i<userInputs.number_of_variables; i++){
 
@@ -167,14 +164,11 @@ for (unsigned int i=0; i<userInputs.number_of_variables; i++){
 			fnV += constV(2.0*alpha) * ni * nj*nj;
 		}
 	}
-	value_residuals[i] = ni-constV(userInputs.dtValue*MnV)*fnV;
-	gradient_residuals[i] = constV(-userInputs.dtValue*KnV*MnV)*nix;
+	variable_list.stage_scalar_value_residual_term(i,ni-constV(userInputs.dtValue*MnV)*fnV);
+	variable_list.stage_scalar_gradient_residual_term(i,constV(-userInputs.dtValue*KnV*MnV)*nix);
 }
 
-for (unsigned int i=0; i<userInputs.number_of_variables; i++){
-	variable_list.set_scalar_value_residual_term(i,value_residuals[i]);
-	variable_list.set_scalar_gradient_residual_term(i,gradient_residuals[i]);
-}
+variable_list.apply_staged_residuals();
 
 }
 
@@ -194,6 +188,7 @@ for (unsigned int i=0; i<userInputs.number_of_variables; i++){
 // "this->currentFieldIndex".
 
 template <int dim, int degree>
-void customPDE<dim,degree>::residualLHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+template <typename containerType>
+void customPDE<dim,degree>::residualLHS(containerType & variable_list,
 		dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
 }
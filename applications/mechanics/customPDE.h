@@ -12,12 +12,14 @@ private:
 
 	const userInputParameters<dim> userInputs;
 
-	// Pure virtual method in MatrixFreePDE
-	void residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+	// Pure virtual method in MatrixFreePDE (a template on the container type, see staticResidualDispatch.h)
+	template <typename containerType>
+	void residualRHS(containerType & variable_list,
 					 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const;
 
-	// Pure virtual method in MatrixFreePDE
-	void residualLHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+	// Pure virtual method in MatrixFreePDE (a template on the container type, see staticResidualDispatch.h)
+	template <typename containerType>
+	void residualLHS(containerType & variable_list,
 					 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const;
 
 	// Pure virtual method in MatrixFreePDE
@@ -36,6 +38,10 @@ private:
 	double getNucleationProbability(variableValueContainer variable_value, double dV) const;
 	#endif
 
+	// Overrides of getRHS, getLHS and getPostProcessedFields in MatrixFreePDE that call the residual methods
+	// of this class directly, so they can be inlined into the quadrature point loops
+	#include "../../include/staticResidualDispatch.h"
+
 	// ================================================================
 	// Methods specific to this subclass
 	// ================================================================
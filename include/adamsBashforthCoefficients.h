@@ -0,0 +1,26 @@
+// Coefficients of the explicit Adams-Bashforth methods with a constant time step
+#ifndef INCLUDE_ADAMSBASHFORTHCOEFFICIENTS_H_
+#define INCLUDE_ADAMSBASHFORTHCOEFFICIENTS_H_
+
+#include <vector>
+
+// Returns the weights of the current rate and the previous rates (newest first) for the Adams-Bashforth method of the
+// given order, u_{n+1} = u_n + dt*sum_j beta_j*f_{n-j}. Order one is forward Euler.
+inline std::vector<double> adamsBashforthCoefficients(const unsigned int order){
+    std::vector<double> beta;
+    if (order == 1){
+        beta.push_back(1.0);
+    }
+    else if (order == 2){
+        beta.push_back(3.0/2.0);
+        beta.push_back(-1.0/2.0);
+    }
+    else if (order == 3){
+        beta.push_back(23.0/12.0);
+        beta.push_back(-16.0/12.0);
+        beta.push_back(5.0/12.0);
+    }
+    return beta;
+}
+
+#endif
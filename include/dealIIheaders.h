@@ -11,6 +11,7 @@
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_gmres.h>
 #include <deal.II/lac/precondition.h>
 #include <deal.II/lac/constraint_matrix.h>
 #include <deal.II/fe/fe_system.h>
@@ -26,6 +27,7 @@
 #include <deal.II/numerics/data_out.h>
 #include <deal.II/numerics/vector_tools.h>
 #include <deal.II/lac/parallel_vector.h>
+#include <deal.II/lac/parallel_block_vector.h>
 #include <deal.II/matrix_free/matrix_free.h>
 #include <deal.II/matrix_free/fe_evaluation.h>
 #include <deal.II/base/config.h>
@@ -35,6 +37,19 @@
 #include <deal.II/numerics/error_estimator.h>
 #include <deal.II/distributed/grid_refinement.h>
 #include <deal.II/base/parameter_handler.h>
+#include <deal.II/base/thread_local_storage.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/lac/diagonal_matrix.h>
+// The geometric multigrid preconditioner uses the matrix-free multigrid interfaces of deal.II 9
+#if (DEAL_II_VERSION_MAJOR >= 9)
+#include <deal.II/multigrid/multigrid.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+#include <deal.II/multigrid/mg_tools.h>
+#include <deal.II/multigrid/mg_coarse.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_matrix.h>
+#endif
 
 #include <deal.II/grid/manifold_lib.h>
 
@@ -45,6 +60,7 @@
 //#include <tuple>
 
 #include <unordered_map>
+#include <memory>
 
 
 #endif // DEALIIHEADERS_H
@@ -0,0 +1,141 @@
+// Dense symmetric matrix functions for the projected initial guesses and the Krylov subspace recycling of the
+// ELLIPTIC solves
+#ifndef INCLUDE_DENSESYMMETRICFUNCTIONS_H_
+#define INCLUDE_DENSESYMMETRICFUNCTIONS_H_
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "krylovPhiFunctions.h"
+
+// Replaces the lower triangle of a symmetric positive definite matrix with its Cholesky factor L (A = L*L^T), the
+// upper triangle is set to zero. Returns false if the matrix isn't positive definite.
+inline bool denseCholesky(denseMatrix & A){
+    const unsigned int n = A.size();
+    for (unsigned int j=0; j<n; j++){
+        double d = A[j][j];
+        for (unsigned int k=0; k<j; k++){
+            d -= A[j][k]*A[j][k];
+        }
+        if (!(d > 0.0)){
+            return false;
+        }
+        A[j][j] = std::sqrt(d);
+        for (unsigned int i=j+1; i<n; i++){
+            double s = A[i][j];
+            for (unsigned int k=0; k<j; k++){
+                s -= A[i][k]*A[j][k];
+            }
+            A[i][j] = s/A[j][j];
+            A[j][i] = 0.0;
+        }
+    }
+    return true;
+}
+
+// Solves L*x = b (forward) or L^T*x = b (backward) in place for the Cholesky factor L from denseCholesky
+inline void denseCholeskyForward(const denseMatrix & L, std::vector<double> & x){
+    const unsigned int n = L.size();
+    for (unsigned int i=0; i<n; i++){
+        for (unsigned int k=0; k<i; k++){
+            x[i] -= L[i][k]*x[k];
+        }
+        x[i] /= L[i][i];
+    }
+}
+
+inline void denseCholeskyBackward(const denseMatrix & L, std::vector<double> & x){
+    const int n = L.size();
+    for (int i=n-1; i>=0; i--){
+        for (int k=i+1; k<n; k++){
+            x[i] -= L[k][i]*x[k];
+        }
+        x[i] /= L[i][i];
+    }
+}
+
+// Solves A*x = b for a symmetric positive definite A, given its Cholesky factor L
+inline std::vector<double> denseCholeskySolve(const denseMatrix & L, const std::vector<double> & b){
+    std::vector<double> x = b;
+    denseCholeskyForward(L, x);
+    denseCholeskyBackward(L, x);
+    return x;
+}
+
+// Eigenvalues (in ascending order) and orthonormal eigenvectors (the columns of eigenvectors) of a symmetric matrix,
+// with the cyclic Jacobi method. Only meant for the small matrices of the Galerkin projections.
+inline void denseSymmetricEigen(denseMatrix A, std::vector<double> & eigenvalues, denseMatrix & eigenvectors){
+    const unsigned int n = A.size();
+    denseMatrix V(n, std::vector<double>(n,0.0));
+    for (unsigned int i=0; i<n; i++){
+        V[i][i] = 1.0;
+    }
+
+    double norm = 0.0;
+    for (unsigned int i=0; i<n; i++){
+        for (unsigned int j=0; j<n; j++){
+            norm += A[i][j]*A[i][j];
+        }
+    }
+
+    const unsigned int max_sweeps = 100;
+    for (unsigned int sweep=0; sweep<max_sweeps; sweep++){
+        double off_diagonal = 0.0;
+        for (unsigned int p=0; p<n; p++){
+            for (unsigned int q=p+1; q<n; q++){
+                off_diagonal += A[p][q]*A[p][q];
+            }
+        }
+        if (off_diagonal <= 1.0e-30*norm){
+            break;
+        }
+
+        // Each rotation in the (p,q) plane zeroes A[p][q]
+        for (unsigned int p=0; p<n; p++){
+            for (unsigned int q=p+1; q<n; q++){
+                if (A[p][q] == 0.0){
+                    continue;
+                }
+                const double theta = (A[q][q] - A[p][p])/(2.0*A[p][q]);
+                const double t = (theta >= 0.0 ? 1.0 : -1.0)/(std::abs(theta) + std::sqrt(theta*theta + 1.0));
+                const double c = 1.0/std::sqrt(t*t + 1.0);
+                const double s = t*c;
+                for (unsigned int k=0; k<n; k++){
+                    const double a_kp = A[k][p];
+                    const double a_kq = A[k][q];
+                    A[k][p] = c*a_kp - s*a_kq;
+                    A[k][q] = s*a_kp + c*a_kq;
+                }
+                for (unsigned int k=0; k<n; k++){
+                    const double a_pk = A[p][k];
+                    const double a_qk = A[q][k];
+                    A[p][k] = c*a_pk - s*a_qk;
+                    A[q][k] = s*a_pk + c*a_qk;
+                }
+                for (unsigned int k=0; k<n; k++){
+                    const double v_kp = V[k][p];
+                    const double v_kq = V[k][q];
+                    V[k][p] = c*v_kp - s*v_kq;
+                    V[k][q] = s*v_kp + c*v_kq;
+                }
+            }
+        }
+    }
+
+    std::vector<std::pair<double,unsigned int> > order(n);
+    for (unsigned int i=0; i<n; i++){
+        order[i] = std::make_pair(A[i][i], i);
+    }
+    std::sort(order.begin(), order.end());
+
+    eigenvalues.resize(n);
+    eigenvectors.assign(n, std::vector<double>(n,0.0));
+    for (unsigned int j=0; j<n; j++){
+        eigenvalues[j] = order[j].first;
+        for (unsigned int i=0; i<n; i++){
+            eigenvectors[i][j] = V[i][order[j].second];
+        }
+    }
+}
+
+#endif
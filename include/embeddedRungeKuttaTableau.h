@@ -0,0 +1,79 @@
+// Class holding the Butcher tableau of an embedded explicit Runge-Kutta pair, used for the adaptive time stepping of
+// the PARABOLIC fields
+#ifndef INCLUDE_EMBEDDEDRUNGEKUTTATABLEAU_H_
+#define INCLUDE_EMBEDDEDRUNGEKUTTATABLEAU_H_
+
+#include <vector>
+#include "varTypeEnums.h"
+
+class embeddedRungeKuttaTableau
+{
+public:
+    // Constructors
+    embeddedRungeKuttaTableau();
+    embeddedRungeKuttaTableau(timeIntegrationScheme scheme);
+
+    unsigned int num_stages;
+
+    // Order of the embedded (lower order) solution, which sets the exponent in the step size controller
+    unsigned int embedded_order;
+
+    // Coefficients of the stages (a), the weights of the solution that is kept (b), the weights of the embedded solution
+    // used for the error estimate (b_hat) and the stage times (c). Both pairs below have the "first same as last"
+    // property: the last stage is evaluated at the new solution (the last row of a is b), so its rate is the first
+    // stage rate of the next step.
+    std::vector<std::vector<double> > a;
+    std::vector<double> b;
+    std::vector<double> b_hat;
+    std::vector<double> c;
+};
+
+inline embeddedRungeKuttaTableau::embeddedRungeKuttaTableau(){
+    num_stages = 0;
+    embedded_order = 0;
+}
+
+inline embeddedRungeKuttaTableau::embeddedRungeKuttaTableau(timeIntegrationScheme scheme){
+
+    if (scheme == BOGACKI_SHAMPINE_32){
+        // Bogacki-Shampine 3(2) pair
+        num_stages = 4;
+        embedded_order = 2;
+        a.assign(num_stages,std::vector<double>(num_stages,0.0));
+        a[1][0] = 1.0/2.0;
+        a[2][1] = 3.0/4.0;
+        a[3][0] = 2.0/9.0; a[3][1] = 1.0/3.0; a[3][2] = 4.0/9.0;
+
+        double b_temp[] = {2.0/9.0, 1.0/3.0, 4.0/9.0, 0.0};
+        double b_hat_temp[] = {7.0/24.0, 1.0/4.0, 1.0/3.0, 1.0/8.0};
+        double c_temp[] = {0.0, 1.0/2.0, 3.0/4.0, 1.0};
+        b.assign(b_temp,b_temp+num_stages);
+        b_hat.assign(b_hat_temp,b_hat_temp+num_stages);
+        c.assign(c_temp,c_temp+num_stages);
+    }
+    else if (scheme == DORMAND_PRINCE_54){
+        // Dormand-Prince 5(4) pair
+        num_stages = 7;
+        embedded_order = 4;
+        a.assign(num_stages,std::vector<double>(num_stages,0.0));
+        a[1][0] = 1.0/5.0;
+        a[2][0] = 3.0/40.0; a[2][1] = 9.0/40.0;
+        a[3][0] = 44.0/45.0; a[3][1] = -56.0/15.0; a[3][2] = 32.0/9.0;
+        a[4][0] = 19372.0/6561.0; a[4][1] = -25360.0/2187.0; a[4][2] = 64448.0/6561.0; a[4][3] = -212.0/729.0;
+        a[5][0] = 9017.0/3168.0; a[5][1] = -355.0/33.0; a[5][2] = 46732.0/5247.0; a[5][3] = 49.0/176.0; a[5][4] = -5103.0/18656.0;
+        a[6][0] = 35.0/384.0; a[6][2] = 500.0/1113.0; a[6][3] = 125.0/192.0; a[6][4] = -2187.0/6784.0; a[6][5] = 11.0/84.0;
+
+        double b_temp[] = {35.0/384.0, 0.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0, 11.0/84.0, 0.0};
+        double b_hat_temp[] = {5179.0/57600.0, 0.0, 7571.0/16695.0, 393.0/640.0, -92097.0/339200.0, 187.0/2100.0, 1.0/40.0};
+        double c_temp[] = {0.0, 1.0/5.0, 3.0/10.0, 4.0/5.0, 8.0/9.0, 1.0, 1.0};
+        b.assign(b_temp,b_temp+num_stages);
+        b_hat.assign(b_hat_temp,b_hat_temp+num_stages);
+        c.assign(c_temp,c_temp+num_stages);
+    }
+    else {
+        num_stages = 0;
+        embedded_order = 0;
+    }
+}
+
+#endif
@@ -0,0 +1,144 @@
+// Dense matrix functions for the Krylov approximations in the exponential time differencing (ETD) schemes
+#ifndef INCLUDE_KRYLOVPHIFUNCTIONS_H_
+#define INCLUDE_KRYLOVPHIFUNCTIONS_H_
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+typedef std::vector<std::vector<double> > denseMatrix;
+
+inline denseMatrix denseMatrixProduct(const denseMatrix & a, const denseMatrix & b){
+    const unsigned int n = a.size();
+    denseMatrix c(n, std::vector<double>(n,0.0));
+    for (unsigned int i=0; i<n; i++){
+        for (unsigned int k=0; k<n; k++){
+            if (a[i][k] == 0.0){
+                continue;
+            }
+            for (unsigned int j=0; j<n; j++){
+                c[i][j] += a[i][k]*b[k][j];
+            }
+        }
+    }
+    return c;
+}
+
+// Returns exp(A) for a small dense matrix, with the [6/6] Pade approximation and scaling and squaring
+inline denseMatrix denseMatrixExponential(const denseMatrix & A){
+    const unsigned int n = A.size();
+
+    // Scale the matrix so that its infinity norm is at most 1/2
+    double norm = 0.0;
+    for (unsigned int i=0; i<n; i++){
+        double row_sum = 0.0;
+        for (unsigned int j=0; j<n; j++){
+            row_sum += std::abs(A[i][j]);
+        }
+        norm = std::max(norm, row_sum);
+    }
+    int num_squarings = 0;
+    if (norm > 0.5){
+        num_squarings = std::max(0, (int)std::ceil(std::log2(norm/0.5)));
+    }
+    const double scale = std::pow(2.0, -num_squarings);
+
+    denseMatrix X(n, std::vector<double>(n,0.0));
+    for (unsigned int i=0; i<n; i++){
+        for (unsigned int j=0; j<n; j++){
+            X[i][j] = scale*A[i][j];
+        }
+    }
+
+    // Numerator N = sum_k c_k X^k and denominator D = sum_k (-1)^k c_k X^k of the Pade approximation
+    const unsigned int q = 6;
+    denseMatrix N(n, std::vector<double>(n,0.0));
+    denseMatrix D(n, std::vector<double>(n,0.0));
+    denseMatrix power(n, std::vector<double>(n,0.0));
+    for (unsigned int i=0; i<n; i++){
+        N[i][i] = 1.0;
+        D[i][i] = 1.0;
+        power[i][i] = 1.0;
+    }
+    double c = 1.0;
+    for (unsigned int k=1; k<=q; k++){
+        c *= (double)(q-k+1)/(double)(k*(2*q-k+1));
+        power = denseMatrixProduct(power, X);
+        const double sign = (k%2 == 0) ? 1.0 : -1.0;
+        for (unsigned int i=0; i<n; i++){
+            for (unsigned int j=0; j<n; j++){
+                N[i][j] += c*power[i][j];
+                D[i][j] += sign*c*power[i][j];
+            }
+        }
+    }
+
+    // Solve D*E = N with Gaussian elimination with partial pivoting
+    for (unsigned int col=0; col<n; col++){
+        unsigned int pivot = col;
+        for (unsigned int i=col+1; i<n; i++){
+            if (std::abs(D[i][col]) > std::abs(D[pivot][col])){
+                pivot = i;
+            }
+        }
+        std::swap(D[col], D[pivot]);
+        std::swap(N[col], N[pivot]);
+        for (unsigned int i=col+1; i<n; i++){
+            const double factor = D[i][col]/D[col][col];
+            if (factor == 0.0){
+                continue;
+            }
+            for (unsigned int j=col; j<n; j++){
+                D[i][j] -= factor*D[col][j];
+            }
+            for (unsigned int j=0; j<n; j++){
+                N[i][j] -= factor*N[col][j];
+            }
+        }
+    }
+    denseMatrix E(n, std::vector<double>(n,0.0));
+    for (int i=n-1; i>=0; i--){
+        for (unsigned int j=0; j<n; j++){
+            double value = N[i][j];
+            for (unsigned int k=i+1; k<n; k++){
+                value -= D[i][k]*E[k][j];
+            }
+            E[i][j] = value/D[i][i];
+        }
+    }
+
+    // Undo the scaling
+    for (int s=0; s<num_squarings; s++){
+        E = denseMatrixProduct(E, E);
+    }
+    return E;
+}
+
+// Returns phi_k(B)*e_1 for k = 1,...,num_phi, where phi_1(z) = (exp(z)-1)/z, phi_{k+1}(z) = (phi_k(z)-1/k!)/z and B is
+// the (small) square matrix given. They are the last columns of the exponential of the augmented matrix
+// [[B, e_1, 0], [0, 0, I], [0, 0, 0]] (with num_phi extra rows and columns), so no division by B is needed.
+inline std::vector<std::vector<double> > phiFunctionsTimesFirstUnitVector(const denseMatrix & B, const unsigned int num_phi){
+    const unsigned int m = B.size();
+    denseMatrix augmented(m+num_phi, std::vector<double>(m+num_phi,0.0));
+    for (unsigned int i=0; i<m; i++){
+        for (unsigned int j=0; j<m; j++){
+            augmented[i][j] = B[i][j];
+        }
+    }
+    augmented[0][m] = 1.0;
+    for (unsigned int k=1; k<num_phi; k++){
+        augmented[m+k-1][m+k] = 1.0;
+    }
+
+    const denseMatrix exp_augmented = denseMatrixExponential(augmented);
+
+    std::vector<std::vector<double> > phi(num_phi, std::vector<double>(m,0.0));
+    for (unsigned int k=0; k<num_phi; k++){
+        for (unsigned int i=0; i<m; i++){
+            phi[k][i] = exp_augmented[i][m+k];
+        }
+    }
+    return phi;
+}
+
+#endif
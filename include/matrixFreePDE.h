@@ -17,6 +17,11 @@
 #include "nucleus.h"
 #include "variableValueContainer.h"
 #include "variableContainer.h"
+#include "variableContainerTrace.h"
+#include "embeddedRungeKuttaTableau.h"
+#include "adamsBashforthCoefficients.h"
+#include "krylovPhiFunctions.h"
+#include "recycledSolverCG.h"
 
 ////define data types
 #ifndef scalarType
@@ -25,6 +30,7 @@ typedef dealii::VectorizedArray<double> scalarType;
 #ifndef vectorType
 typedef dealii::parallel::distributed::Vector<double> vectorType;
 #endif
+typedef dealii::parallel::distributed::BlockVector<double> blockVectorType;
 
 //macro for constants
 #define constV(a) make_vectorized_array(a)
@@ -87,6 +93,9 @@ class MatrixFreePDE:public Subscriptor
 
   void buildFields();
 
+  // MPI communicator for the spatial problem: MPI_COMM_WORLD, or the processes of one time slice with Parareal
+  MPI_Comm mpi_communicator;
+
   // Parallel message stream
   ConditionalOStream  pcout;
 
@@ -112,6 +121,271 @@ class MatrixFreePDE:public Subscriptor
    * and also invokes the corresponding solvers: Explicit solver for Parabolic problems, Implicit (matrix-free) solver for Elliptic problems.
    */
   virtual void solveIncrement ();
+
+  /*Method for the explicit update of a parabolic field, done in a single pass over the residual and solution vectors, which are then swapped. Returns the l2 norm of the new solution.*/
+  double explicitUpdate(const unsigned int fieldIndex);
+  double explicitUpdateSinglePrecision(const unsigned int fieldIndex);
+  /*Local indices and values of the locally owned DOFs with Dirichlet BCs for each field, used in explicitUpdate.*/
+  std::vector<std::vector<std::pair<unsigned int,double> > > localDirichletValues;
+  /*For each field, whether each locally owned DOF is free, i.e. neither constrained to other DOFs (hanging nodes, periodic slaves) nor set by a Dirichlet BC. Set with localDirichletValues and used to leave the fixed DOFs out of the error and convergence norms.*/
+  std::vector<std::vector<bool> > localFreeDofs;
+  void setLocalDirichletValues();
+  /*Flags for residual vectors that were already zeroed by explicitUpdate, so computeRHS doesn't have to zero them again.*/
+  std::vector<bool> residualIsZeroed;
+
+  /*Method to compute the rate of change of each PARABOLIC field at the current solution and time, (invM*R-u)/dtValue, where R is the residual from residualRHS (which is written for a forward Euler step of size dtValue). This lets the time integration schemes other than forward Euler take steps of any size.*/
+  void computeRates(std::vector<vectorType*> & rates);
+  /*Method to (re)initialize the vectors used by the time integration schemes for the current mesh, used in init() and reinit().*/
+  void initTimeIntegrationVectors();
+  /*Time loop with time steps chosen during the simulation (from an embedded Runge-Kutta pair, or the automatic forward Euler time step), used instead of the fixed time step loop in solve(). Output and checkpoints are scheduled by simulated time.*/
+  void solveAdaptiveTimeSteps();
+  /*Method to take one step of the embedded Runge-Kutta pair, returns the norm of the estimated error scaled by the tolerance (the step should be rejected if it is larger than one).*/
+  double embeddedRungeKuttaStep(const double dt);
+  embeddedRungeKuttaTableau rkTableau;
+  /*Rates of the PARABOLIC fields for each stage (indexed by stage, then by field, NULL for non-PARABOLIC fields) and the solution at the start of the step.*/
+  std::vector<std::vector<vectorType*> > rkStageRates;
+  std::vector<vectorType*> rkSolutionOld;
+  /*Whether rkStageRates[0] holds the rate at the current solution, left there by the last stage of the previous step.*/
+  bool rkFirstStageRateValid;
+  /*The time step proposed for the next adaptive step.*/
+  double adaptiveTimeStep;
+  /*Method to estimate the largest stable forward Euler time step, 2/|lambda_max|, with a power iteration on the Jacobian of the rates (applied with finite differences of computeRates), used in init() and reinit() if "Automatic time step" is set.*/
+  void estimateStableTimeStep();
+  /*The largest stable forward Euler time step from the last call to estimateStableTimeStep.*/
+  double stableTimeStep;
+  /*The forward Euler time step used with "Automatic time step", a fraction of stableTimeStep.*/
+  double automaticTimeStep() const;
+  /*Method for the semi-implicit (IMEX) update of a parabolic field whose linear terms are given in residualLHS ("set_implicit_linear_terms" in equations.h), solved with CG using vmult. Returns the l2 norm of the new solution.*/
+  double semiImplicitUpdate(const unsigned int fieldIndex);
+  /*Method for the Adams-Bashforth update of a parabolic field, used instead of explicitUpdate by the multistep schemes. The rate is computed from the residual and stored in rateHistory, then combined with the stored rates from the previous steps in the same pass. Returns the l2 norm of the new solution.*/
+  double multistepUpdate(const unsigned int fieldIndex);
+  /*Rates of the PARABOLIC fields from the current and previous time steps for the multistep schemes (indexed by age, newest first, then by field, NULL for non-PARABOLIC fields). They are transferred to the new mesh with the solution in refineGrid() and reinit().*/
+  std::vector<std::vector<vectorType*> > rateHistory;
+  /*Number of previous time steps with a rate in rateHistory, the order is lower until enough rates are stored.*/
+  unsigned int numStoredRates;
+  /*The Adams-Bashforth coefficients for each order up to the order of the scheme.*/
+  std::vector<std::vector<double> > multistepCoefficients;
+  /*Method to get the vectors of the time integration schemes that are transferred to the new mesh with the solution of a field in refineGrid() and reinit() (the rates of the multistep schemes, the previous solution for BDF2 and the solution at the start of the steady state window).*/
+  std::vector<vectorType*> transferredHistoryVectors(const unsigned int fieldIndex);
+  /*Method for a time step of the implicit backward differentiation formula (BDF) schemes, which solves for all of the fields together with Jacobian-free Newton-Krylov iterations, used instead of the field by field updates in solveIncrement().*/
+  void bdfUpdate();
+  /*Method to evaluate the nonlinear residual of the BDF step, u - history - gamma*dt*f(u), at the Newton iterate in bdfSolution (the rates are left in bdfRates). Returns the l2 norm of the residual.*/
+  double bdfResidual(const blockVectorType & history, blockVectorType & residual);
+  /*Method to apply the Jacobian of the nonlinear residual of the BDF step at bdfSolution, with a finite difference of computeRates.*/
+  void applyBDFJacobian(blockVectorType & dst, const blockVectorType & src);
+  /*The Jacobian of the nonlinear residual of the BDF step, the operator for the GMRES solves of the Newton iterations.*/
+  class bdfJacobian
+  {
+  public:
+      bdfJacobian(MatrixFreePDE<dim,degree> & _pde) : pde(_pde) {}
+      void vmult(blockVectorType & dst, const blockVectorType & src) const { pde.applyBDFJacobian(dst,src); }
+  private:
+      MatrixFreePDE<dim,degree> & pde;
+  };
+  /*The current Newton iterate of the BDF step and the rates there (with one block for each field), and its l2 norm.*/
+  blockVectorType bdfSolution;
+  blockVectorType bdfRates;
+  double bdfSolutionNorm;
+  /*The coefficient of the rates in the nonlinear residual of the BDF step, gamma*dt.*/
+  double bdfRateScale;
+  /*The solution from the previous time step for BDF2 (NULL for the other schemes), transferred to the new mesh with the solution, and whether it has been set (the first step is taken with BDF1).*/
+  std::vector<vectorType*> bdfSolutionOld;
+  bool bdfSolutionOldValid;
+  /*Method for a time step of the exponential time differencing (ETD) schemes, where the linear terms from residualLHS are integrated exactly with Krylov approximations of their phi-functions and the other terms from residualRHS explicitly, used instead of the field by field updates in solveIncrement().*/
+  void etdUpdate();
+  /*Method to apply the linear operator of a field with implicit linear terms, L*v = (v - invM*vmult(v))/dtValue, which is zero at the Dirichlet and constrained DOFs.*/
+  void applyETDLinearOperator(const unsigned int fieldIndex, vectorType & dst, const vectorType & src);
+  /*Method to approximate dtValue*phi_k(dtValue*L)*b for a field with implicit linear terms with the Arnoldi process. Returns the number of Krylov vectors used.*/
+  unsigned int krylovPhiProduct(const unsigned int fieldIndex, const unsigned int k, const vectorType & b, vectorType & result);
+  /*The Krylov basis vectors for krylovPhiProduct, kept between calls.*/
+  std::vector<vectorType*> krylovBasis;
+  /*Method to find the time step class of each DOF and the cell batches needed for each class for local time stepping, used in initTimeIntegrationVectors() after each change of the mesh.*/
+  void initLocalTimeStepping();
+  /*Method for a forward Euler time step with local time stepping, used instead of the field by field updates in solveIncrement(). Only the DOFs whose class is due at the current increment are updated, and only the residuals of the cell batches they need are evaluated.*/
+  void localTimeSteppingUpdate();
+  /*Time step class of each locally owned DOF of each field for local time stepping. A DOF of class c takes a step of 2^c*dtValue every 2^c increments, the class is set by the finest cell the DOF (or a DOF constrained to it) belongs to.*/
+  std::vector<std::vector<unsigned char> > ltsDofClass;
+  /*Ranges of cell batches with a DOF of class c or lower, for each class c. These are the cells whose residuals are needed when the DOFs up to class c are updated.*/
+  std::vector<std::vector<std::pair<unsigned int,unsigned int> > > ltsCellRanges;
+  /*Method for the explicit update of a field with subcycling steps, a forward Euler step of dtValue divided by its number of substeps. Returns the l2 norm of the new solution.*/
+  double subcycledUpdate(const unsigned int fieldIndex);
+  /*Method for the remaining substeps of the fields with subcycling steps (multirate time stepping), after the first one in solveIncrement(). Only the residuals of the fields being updated in a substep are integrated, selected with rhsFieldSubset. If residualRHS skips the residuals of the other fields (see residualNeeded), the substeps also only read and evaluate the fields that the subcycled residuals use (see initSubcycleVariableNeeds).*/
+  void solveSubcycles();
+  /*The fields whose residuals are integrated in computeRHS() (all of them if empty).*/
+  std::vector<bool> rhsFieldSubset;
+  /*Whether residualRHS has to set the residual of a field in the current evaluation. It is only false during the substeps of multirate time stepping, for the fields that aren't being updated, so residualRHS can skip their terms.*/
+  bool residualNeeded(const unsigned int index) const {return rhsFieldSubset.empty() || rhsFieldSubset[index];};
+  /*Method to trace residualRHS with only the residuals of the subcycled fields needed and, if it doesn't set the residuals of the other fields, build the variable attributes for the substeps, with only the values/derivatives the subcycled residuals use. Called after traceVariableNeeds.*/
+  void initSubcycleVariableNeeds();
+  /*The variable attributes for the RHS containers of the substeps (empty if the substeps use the full attributes) and whether computeRHS() uses them.*/
+  std::vector<variable_info> varInfoListRHSSubcycle;
+  bool rhsUsesSubcycleContainers;
+  /*Ratio of the current time step to dtValue (the time step the residuals are written for), used in explicitUpdate, multistepUpdate and bdfUpdate. It is one except with an automatic time step, in the coarse propagator of Parareal and after a blow-up with blow-up recovery.*/
+  double explicitStepRatio;
+  /*Method to get the communicator for the spatial problem, used in the constructor. With Parareal, MPI_COMM_WORLD is split into one communicator for each time slice, with consecutive ranks in the same slice.*/
+  static MPI_Comm pararealCommunicator(const userInputParameters<dim> & inputs);
+  /*Time loop for parallel-in-time integration with Parareal, used instead of the time loop in solve(). Each time slice is solved by its own group of processes with the fine propagator (the usual time steps), and the slices are coupled by the sequential coarse propagator (larger BDF1 or forward Euler time steps).*/
+  void solveParareal();
+  /*Method to propagate the solution in solutionSet over the time steps after first_increment up to last_increment, with the fine or the coarse propagator for Parareal. Output is only written by the fine propagator if write_output is set.*/
+  void pararealPropagate(const unsigned int first_increment, const unsigned int last_increment, const bool coarse, const bool write_output);
+  /*Methods to copy the locally owned values of all of the fields between solutionSet and a single vector, the state exchanged between time slices.*/
+  void getPararealState(std::vector<double> & state) const;
+  void setPararealState(const std::vector<double> & state);
+  /*Method for the local reaction part of the Strang splitting in solveIncrement(), where the terms from reactionRates are integrated over a time step of dt at each DOF separately. The default implementation calls reactionRates through the virtual function table; a model can override it (see staticResidualDispatch.h) to have the call resolved at compile time.*/
+  virtual void integrateLocalReactions(const double dt);
+  /*DOF loop body for integrateLocalReactions (defined in matrixFreePDE_cellLoops.h), templated on the reaction functor in the same way as the cell loops.*/
+  template <typename reactionFunctor>
+  void localReactionLoop(const double dt, const reactionFunctor & reaction);
+  /*The step size proposed for each batch of DOFs at the end of the last call to localReactionLoop, the first step size tried in the next call.*/
+  std::vector<double> reactionStepSizes;
+  /*Method to solve a time increment with blow-up recovery, used in solve() instead of solveIncrement() if "Blow-up recovery snapshots" is set. The increment is taken as substeps of the reduced time step, and if the solution blows up, the last snapshot is restored (setting currentIncrement back) and the time step is reduced. Returns false if a snapshot was restored.*/
+  bool solveRecoverableIncrement();
+  /*Method to save a snapshot of the solution after the given increment in the snapshot ring, replacing the oldest one if it is full.*/
+  void saveRecoverySnapshot(const unsigned int completed_increment, const double completed_time);
+  /*Method to restore the newest snapshot (after discarding it if drop_newest is set, to go further back). Returns false if there is none.*/
+  bool restoreRecoverySnapshot(const bool drop_newest);
+  /*The ring of snapshots of the solution for blow-up recovery (indexed by slot, then by field) and the increment and time of each slot. It is emptied in initTimeIntegrationVectors() after each change of the mesh.*/
+  std::vector<std::vector<vectorType*> > recoverySnapshots;
+  std::vector<unsigned int> recoverySnapshotIncrement;
+  std::vector<double> recoverySnapshotTime;
+  unsigned int numRecoverySnapshots;
+  unsigned int newestRecoverySnapshot;
+  /*The number of times the time step is currently reduced after a blow-up, and the number of increments since the last change.*/
+  unsigned int recoveryStepReductions;
+  unsigned int recoveryStepsSinceChange;
+  /*Set by solveIncrement() (in the explicit, BDF and subcycled updates) instead of stopping the simulation when a field blows up with blow-up recovery.*/
+  bool solutionBlowUp;
+  /*Method to check the steady state criterion at the end of an increment, used in the time loops if "Steady state tolerance" is set. The change of each field since the start of the current window of increments, divided by the elapsed time, is compared with the tolerance. Returns true if the time loop should stop (the final solution is written first). With the increase_time_step action, steadyStateStepRatio is increased instead.*/
+  bool checkSteadyState();
+  /*The solution at the start of the current steady state window, the increment and time there, and whether it is set.*/
+  std::vector<vectorType*> steadyStateSolutionOld;
+  unsigned int steadyStateWindowIncrement;
+  double steadyStateWindowTime;
+  bool steadyStateWindowValid;
+  /*Ratio of the time step to dtValue in the fixed time step loop, larger than one after a steady state with the increase_time_step action.*/
+  double steadyStateStepRatio;
+  #if (DEAL_II_VERSION_MAJOR >= 9)
+  /*Methods for the geometric multigrid (GMG) preconditioner of the ELLIPTIC fields, used if "Linear solver preconditioner" is set to GMG. setupMultigrid builds the level DOF constraints, the transfers between the levels and the matrix free objects of the levels for the current mesh (in setupMatrixFreeObjects()), and updateMultigridPreconditioner builds the level operators, the Chebyshev smoothers and the V-cycle for the current field if they are out of date (see invalidatePreconditionerDiagonal), before each of its solves.*/
+  void setupMultigrid();
+  void updateMultigridPreconditioner();
+  void clearMultigrid();
+  /*Method to apply the LHS operator of the current field on a multigrid level, adding the result to dst if add is true. The rows and columns of the DOFs at the refinement edge (where the level borders finer cells) and on the Dirichlet boundaries are those of the identity.*/
+  void applyLevelLHS(const unsigned int level, vectorType & dst, const vectorType & src, const bool add) const;
+  /*Method to apply the coupling of the refinement edge DOFs to the other DOFs of a multigrid level, from the other DOFs to the edge rows (to_edge) or the other way around, adding the result to dst if add is true.*/
+  void applyLevelInterface(const unsigned int level, vectorType & dst, const vectorType & src, const bool to_edge, const bool add) const;
+  /*Cell loop over a multigrid level with residualLHS, from mgLevelSrc to mgLevelDst.*/
+  void levelCellLoop(const unsigned int level) const;
+  /*Method to compute the inverse of the diagonal of the LHS operator of the current field on a multigrid level.*/
+  void computeLevelInverseDiagonal(const unsigned int level, vectorType & inverse_diagonal) const;
+  /*Method to apply one V-cycle of the multigrid preconditioner, the result is zero at the constrained and Dirichlet DOFs.*/
+  void applyMultigridPreconditioner(vectorType & dst, const vectorType & src) const;
+  /*The LHS operator on a multigrid level, the level matrix of the V-cycle and the operator of the smoothers.*/
+  class mgLevelOperator : public Subscriptor
+  {
+  public:
+      mgLevelOperator() : pde(NULL), level(0) {}
+      void initialize(const MatrixFreePDE<dim,degree> * _pde, const unsigned int _level) { pde = _pde; level = _level; }
+      void vmult(vectorType & dst, const vectorType & src) const { pde->applyLevelLHS(level,dst,src,false); }
+      // residualLHS is symmetric for the ELLIPTIC fields (they are solved with CG)
+      void Tvmult(vectorType & dst, const vectorType & src) const { vmult(dst,src); }
+      void vmult_add(vectorType & dst, const vectorType & src) const { pde->applyLevelLHS(level,dst,src,true); }
+      void Tvmult_add(vectorType & dst, const vectorType & src) const { vmult_add(dst,src); }
+      types::global_dof_index m() const { return pde->dofHandlersSet[pde->currentFieldIndex]->n_dofs(level); }
+      types::global_dof_index n() const { return m(); }
+      void initialize_dof_vector(vectorType & vec) const { pde->mgMatrixFree[level]->initialize_dof_vector(vec,pde->currentFieldIndex); }
+      // Only needed to compile PreconditionChebyshev, which is always given the inverse diagonal
+      double el(const types::global_dof_index, const types::global_dof_index) const { Assert(false, ExcNotImplemented()); return 0.0; }
+  private:
+      const MatrixFreePDE<dim,degree> * pde;
+      unsigned int level;
+  };
+  /*The coupling across the refinement edge of a multigrid level (the edge matrices of the V-cycle), with vmult to the edge rows and Tvmult from them.*/
+  class mgInterfaceOperator : public Subscriptor
+  {
+  public:
+      mgInterfaceOperator() : pde(NULL), level(0) {}
+      void initialize(const MatrixFreePDE<dim,degree> * _pde, const unsigned int _level) { pde = _pde; level = _level; }
+      void vmult(vectorType & dst, const vectorType & src) const { pde->applyLevelInterface(level,dst,src,true,false); }
+      void Tvmult(vectorType & dst, const vectorType & src) const { pde->applyLevelInterface(level,dst,src,false,false); }
+      void vmult_add(vectorType & dst, const vectorType & src) const { pde->applyLevelInterface(level,dst,src,true,true); }
+      void Tvmult_add(vectorType & dst, const vectorType & src) const { pde->applyLevelInterface(level,dst,src,false,true); }
+      types::global_dof_index m() const { return pde->dofHandlersSet[pde->currentFieldIndex]->n_dofs(level); }
+      types::global_dof_index n() const { return m(); }
+      void initialize_dof_vector(vectorType & vec) const { pde->mgMatrixFree[level]->initialize_dof_vector(vec,pde->currentFieldIndex); }
+  private:
+      const MatrixFreePDE<dim,degree> * pde;
+      unsigned int level;
+  };
+  /*The multigrid preconditioner, as passed to the CG solver of the ELLIPTIC fields.*/
+  class gmgPreconditioner
+  {
+  public:
+      gmgPreconditioner(const MatrixFreePDE<dim,degree> & _pde) : pde(_pde) {}
+      void vmult(vectorType & dst, const vectorType & src) const { pde.applyMultigridPreconditioner(dst,src); }
+  private:
+      const MatrixFreePDE<dim,degree> & pde;
+  };
+  /*The level DOFs with zero Dirichlet BCs and the transfer between the levels for each field, and the matrix free object of each level. The level matrix free objects have no constraints, the constrained DOFs are handled by the level operators.*/
+  std::vector<std::shared_ptr<MGConstrainedDoFs> > mgConstrainedDoFs;
+  std::vector<std::shared_ptr<MGTransferMatrixFree<dim,double> > > mgTransfers;
+  std::vector<std::shared_ptr<MatrixFree<dim,double> > > mgMatrixFree;
+  /*Local indices of the locally owned DOFs of the current field on each level at the refinement edge or a Dirichlet boundary, and of those only at the refinement edge.*/
+  std::vector<std::vector<unsigned int> > mgConstrainedIndices, mgEdgeIndices;
+  /*Work vectors for the level operators, with the ghost DOFs of the level matrix free objects.*/
+  mutable MGLevelObject<vectorType> mgLevelSrc, mgLevelDst;
+  /*The V-cycle: the level operators, the Chebyshev smoothers preconditioned by the inverse diagonal (iterated to convergence on the coarsest level) and the preconditioner that applies it to vectors of the active mesh.*/
+  typedef PreconditionChebyshev<mgLevelOperator,vectorType> mgSmootherType;
+  MGLevelObject<mgLevelOperator> mgLevelOperators;
+  MGLevelObject<mgInterfaceOperator> mgInterfaceOperators;
+  mg::Matrix<vectorType> mgMatrix, mgInterfaceMatrix;
+  MGSmootherPrecondition<mgLevelOperator,mgSmootherType,vectorType> mgSmoother;
+  MGCoarseGridApplySmoother<vectorType> mgCoarse;
+  std::shared_ptr<Multigrid<vectorType> > mgMultigrid;
+  std::shared_ptr<PreconditionMG<dim,vectorType,MGTransferMatrixFree<dim,double> > > mgPreconditioner;
+  #endif
+  /*Per-thread LHS containers for each multigrid level (see threadLocalContainersLHS), the copies of the fields read by residualLHS on each level (indexed by level, then by field, NULL for the fields it doesn't read), interpolated from the solution before each solve, and the level of the current cell loop. They are read by the LHS cell loops, so they are declared for any version of deal.II (and stay empty without GMG).*/
+  std::vector<std::shared_ptr<dealii::Threads::ThreadLocalStorage<std::shared_ptr<variableContainer<dim,degree,dealii::VectorizedArray<double> > > > > > mgThreadLocalContainersLHS;
+  std::vector<std::vector<vectorType*> > mgLevelSolutionSet;
+  mutable unsigned int mgCurrentLevel;
+  /*The field the V-cycle of the multigrid preconditioner was last built for.*/
+  unsigned int mgPreconditionerFieldIndex;
+  /*Methods for the Jacobi and Chebyshev preconditioners of the ELLIPTIC fields, used if "Linear solver preconditioner" is set to Jacobi or Chebyshev. updateDiagonalPreconditioner computes the inverse diagonal of the LHS operator of the current field (and resets the eigenvalue estimates of its Chebyshev preconditioner) if it is out of date, before each of its solves.*/
+  void updateDiagonalPreconditioner();
+  void computeLHSInverseDiagonal(vectorType & inverse_diagonal) const;
+  /*Method to mark the preconditioner diagonals (and the V-cycle of the multigrid preconditioner) as out of date, so they are recomputed before the next solve of each field. They are always out of date after the mesh changes, a model whose residualLHS coefficients change at known times can call this from an override of solveIncrement (or set "Recompute preconditioner diagonal every solve").*/
+  void invalidatePreconditionerDiagonal();
+  /*The LHS operator of the current field on the active mesh (vmult), as the operator of the Chebyshev preconditioner.*/
+  class lhsOperator : public Subscriptor
+  {
+  public:
+      lhsOperator() : pde(NULL) {}
+      void initialize(const MatrixFreePDE<dim,degree> * _pde) { pde = _pde; }
+      void vmult(vectorType & dst, const vectorType & src) const { pde->vmult(dst,src); }
+      types::global_dof_index m() const { return pde->dofHandlersSet[pde->currentFieldIndex]->n_dofs(); }
+      types::global_dof_index n() const { return m(); }
+      void initialize_dof_vector(vectorType & vec) const { pde->matrixFreeObject.initialize_dof_vector(vec,pde->currentFieldIndex); }
+      // Only needed to compile PreconditionChebyshev, which is always given the inverse diagonal
+      double el(const types::global_dof_index, const types::global_dof_index) const { Assert(false, ExcNotImplemented()); return 0.0; }
+  private:
+      const MatrixFreePDE<dim,degree> * pde;
+  };
+  lhsOperator activeLHSOperator;
+  /*The inverse diagonal of the LHS operator of each field (NULL until the field is first solved), its Chebyshev preconditioner, and whether the diagonal is up to date.*/
+  std::vector<std::shared_ptr<DiagonalMatrix<vectorType> > > lhsInverseDiagonal;
+  #if (DEAL_II_VERSION_MAJOR >= 9)
+  typedef PreconditionChebyshev<lhsOperator,vectorType> chebyshevPreconditionerType;
+  std::vector<std::shared_ptr<chebyshevPreconditionerType> > chebyshevPreconditioners;
+  #endif
+  std::vector<bool> lhsDiagonalValid;
+  /*Methods for the initial guess of the solves of the ELLIPTIC fields. ellipticInitialGuess sets the solution increment from the previous solutions of the field (to zero with the default "Elliptic initial guess"), storeEllipticSolution adds the new solution to them after each solve, and resetEllipticSolveHistory drops them when the mesh changes or an older solution is restored.*/
+  void ellipticInitialGuess(const unsigned int fieldIndex, vectorType & dU);
+  void storeEllipticSolution(const unsigned int fieldIndex);
+  void resetEllipticSolveHistory();
+  /*The previous solutions of each ELLIPTIC field, set to zero at the Dirichlet and constrained DOFs (where the increment is zero), in a ring with the newest at newestEllipticSolution, and the number stored.*/
+  std::vector<std::vector<std::shared_ptr<vectorType> > > ellipticSolutionHistory;
+  std::vector<unsigned int> newestEllipticSolution, numEllipticSolutions;
+  /*The Krylov vectors of each ELLIPTIC field that are recycled between its solves by SolverRecycledCG, if "Recycled Krylov vectors" is set.*/
+  std::vector<std::vector<std::shared_ptr<vectorType> > > recycledKrylovVectors;
   /* Method to write solution fields to vtu and pvtu (parallel) files.
   *
   * This method can be enabled/disabled by setting the flag writeOutput to true/false. Also,
@@ -148,6 +422,14 @@ class MatrixFreePDE:public Subscriptor
   std::vector<IndexSet*>               locally_relevant_dofsSet_nonconst;
   /*Vector all the solution vectors in the problem. In a multi-field problem, each primal field has a solution vector associated with it.*/
   std::vector<vectorType*>             solutionSet;
+  /*Single precision copies of the solution vectors for the fields selected by "Fields stored in single precision" in the parameters file (NULL for the other fields). During time stepping these hold the current solution for those fields and are read (with conversion to double) in the residual evaluation, the corresponding entries of solutionSet are only updated by syncSinglePrecisionFields.*/
+  std::vector<parallel::distributed::Vector<float>*> solutionSetFloat;
+  /*Flags for the fields where solutionSetFloat was updated since the last call to syncSinglePrecisionFields.*/
+  std::vector<bool> doubleSolutionOutdated;
+  /*Whether cellLoopRHS reads the fields stored in single precision from solutionSetFloat instead of from src. It is only set by computeRHS, which evaluates the residuals at the current solution.*/
+  bool rhsReadsSinglePrecisionFields;
+  void initSinglePrecisionFields();
+  void syncSinglePrecisionFields();
   /*Vector all the residual (RHS) vectors in the problem. In a multi-field problem, each primal field has a residual vector associated with it.*/
   std::vector<vectorType*>             residualSet;
   /*Vector of parallel solution transfer objects. This is used only when adaptive meshing is enabled.*/
@@ -163,6 +445,15 @@ class MatrixFreePDE:public Subscriptor
    *Refer to deal.ii documentation of MatrixFree<dim> class for details.
    */
   MatrixFree<dim,double>               matrixFreeObject;
+  /*Single precision version of matrixFreeObject, only initialized when the RHS residuals are evaluated in single precision (see "Residual precision" in the parameters file).*/
+  MatrixFree<dim,float>                matrixFreeObjectFloat;
+  /*Method to set up matrixFreeObject (and matrixFreeObjectFloat, if needed) for the current mesh, used in init() and reinit().*/
+  void setupMatrixFreeObjects();
+  /*Methods to find which values/derivatives and residual terms residualRHS and residualLHS use by running them once with tracing containers. Mismatches with the attributes in equations.h are reported, and if "Infer variable needs from residuals" is set the traced needs replace the declared ones.*/
+  void traceVariableNeeds();
+  void applyTracedVariableNeeds(std::vector<variable_info> & varInfoList,
+		  const variableContainerTrace<dim,degree> & trace,
+		  const std::string residual_name, bool every_field_integrated);
   /*Vector to store the inverse of the mass matrix diagonal. Due to the choice of spectral elements with Guass-Lobatto quadrature, the mass matrix is diagonal.*/
   vectorType                           invM;
   /*Vector to store the solution increment. This is a temporary vector used during implicit solves of the Elliptic fields.*/
@@ -186,29 +477,98 @@ class MatrixFreePDE:public Subscriptor
   void computeRHS();
 
   //virtual methods to be implemented in the derived class
-  /*Method to calculate LHS(implicit solve)*/
-  void getLHS(const MatrixFree<dim,double> &data,
+  /*Method to calculate LHS(implicit solve). The default implementation calls residualLHS through the virtual function table at every quadrature point; a model can override it (see staticResidualDispatch.h) to have the call resolved at compile time.*/
+  virtual void getLHS(const MatrixFree<dim,double> &data,
 		      vectorType &dst,
 		      const vectorType &src,
 		      const std::pair<unsigned int,unsigned int> &cell_range) const;
-  /*Method to calculate RHS (implicit/explicit). This is an abstract method, so every model which inherits MatrixFreePDE<dim> has to implement this method.*/
-  void getRHS (const MatrixFree<dim,double> &data,
+  /*Method to calculate the diagonal of the LHS operator (src isn't used). The default implementation calls residualLHS through the virtual function table, like getLHS.*/
+  virtual void getLHSDiagonal(const MatrixFree<dim,double> &data,
+			      vectorType &dst,
+			      const vectorType &src,
+			      const std::pair<unsigned int,unsigned int> &cell_range) const;
+  /*Method to calculate RHS (implicit/explicit). The default implementation calls residualRHS through the virtual function table at every quadrature point; a model can override it (see staticResidualDispatch.h) to have the call resolved at compile time.*/
+  virtual void getRHS (const MatrixFree<dim,double> &data,
 		       std::vector<vectorType*> &dst,
 		       const std::vector<vectorType*> &src,
 		       const std::pair<unsigned int,unsigned int> &cell_range) const;
+  /*Single precision version of getRHS, used when "Residual precision" is set to "single". It reads and writes the same (double precision) vectors.*/
+  virtual void getRHS (const MatrixFree<dim,float> &data,
+		       std::vector<vectorType*> &dst,
+		       const std::vector<vectorType*> &src,
+		       const std::pair<unsigned int,unsigned int> &cell_range) const;
+
+  /*Cell loop bodies shared by getRHS, getLHS and getPostProcessedFields (defined in matrixFreePDE_cellLoops.h). They are templated on the residual functor, so when the functor makes a non-virtual call to the residual method of the concrete model the compiler can inline it into the quadrature point loop.*/
+  template <typename number, typename residualFunctor>
+  void cellLoopRHS(const MatrixFree<dim,number> &data,
+		       std::vector<vectorType*> &dst,
+		       const std::vector<vectorType*> &src,
+		       const std::pair<unsigned int,unsigned int> &cell_range,
+		       const residualFunctor & residual) const;
+
+  template <typename residualFunctor>
+  void cellLoopLHS(const MatrixFree<dim,double> &data,
+		       vectorType &dst,
+		       const vectorType &src,
+		       const std::pair<unsigned int,unsigned int> &cell_range,
+		       const residualFunctor & residual) const;
+
+  /*Cell loop body for the diagonal of the LHS operator, from the residual of the unit vector of each DOF of a cell in turn.*/
+  template <typename residualFunctor>
+  void cellLoopLHSDiagonal(const MatrixFree<dim,double> &data,
+		       vectorType &dst,
+		       const vectorType &src,
+		       const std::pair<unsigned int,unsigned int> &cell_range,
+		       const residualFunctor & residual) const;
+
+  template <typename residualFunctor>
+  void cellLoopPostProcessedFields(const MatrixFree<dim,double> &data,
+		       std::vector<vectorType*> &dst,
+		       const std::vector<vectorType*> &src,
+		       const std::pair<unsigned int,unsigned int> &cell_range,
+		       const residualFunctor & residual);
+
+  /*Per-thread containers used by the cell loops. They are built the first time a thread works on a cell range and then reused across cell ranges, time steps and solver iterations. They hold references to matrixFreeObject, so they must be cleared (clearThreadLocalContainers) whenever it is reinitialized.*/
+  typedef std::shared_ptr<variableContainer<dim,degree,dealii::VectorizedArray<double> > > variableContainerPtr;
+  mutable dealii::Threads::ThreadLocalStorage<variableContainerPtr> threadLocalContainersRHS, threadLocalContainersLHS;
+  mutable dealii::Threads::ThreadLocalStorage<variableContainerPtr> threadLocalContainersPPBase, threadLocalContainersPP;
+  mutable dealii::Threads::ThreadLocalStorage<std::shared_ptr<dealii::FEEvaluation<dim,degree,degree+1,1,double> > > threadLocalIntegralEvaluators;
+  typedef std::shared_ptr<variableContainer<dim,degree,dealii::VectorizedArray<float> > > variableContainerFloatPtr;
+  mutable dealii::Threads::ThreadLocalStorage<variableContainerFloatPtr> threadLocalContainersRHSFloat;
+  // The RHS containers for the substeps of multirate time stepping, built with varInfoListRHSSubcycle
+  mutable dealii::Threads::ThreadLocalStorage<variableContainerPtr> threadLocalContainersRHSSubcycle;
+  mutable dealii::Threads::ThreadLocalStorage<variableContainerFloatPtr> threadLocalContainersRHSSubcycleFloat;
+  // Access to the RHS containers for a given number type, used by cellLoopRHS
+  dealii::Threads::ThreadLocalStorage<variableContainerPtr> & getThreadLocalContainersRHS(const double) const {return (rhsUsesSubcycleContainers ? threadLocalContainersRHSSubcycle : threadLocalContainersRHS);};
+  dealii::Threads::ThreadLocalStorage<variableContainerFloatPtr> & getThreadLocalContainersRHS(const float) const {return (rhsUsesSubcycleContainers ? threadLocalContainersRHSSubcycleFloat : threadLocalContainersRHSFloat);};
+  void clearThreadLocalContainers();
 
   virtual void residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
   		  	  	  	  	  	  	  	  	  	  	  	  	  dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const=0;
 
+  /*Single precision version of residualRHS. Models that support "Residual precision" set to "single" override this, the default implementation gives an error.*/
+  virtual void residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<float> > & variable_list,
+  														  dealii::Point<dim, dealii::VectorizedArray<float> > q_point_loc) const;
+
   virtual void residualLHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
   														  dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const=0;
 
+  /*Versions of residualRHS and residualLHS that run the residual methods with a tracing container (see traceVariableNeeds). They return false if the model can't be traced, which is the default (models that include staticResidualDispatch.h override them).*/
+  virtual bool traceResidualRHS(variableContainerTrace<dim,degree> & variable_list,
+  														  dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const;
+  virtual bool traceResidualLHS(variableContainerTrace<dim,degree> & variable_list,
+  														  dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const;
+
+  /*Local reaction terms of the PARABOLIC equations declared with "set_local_reaction_terms" in equations.h. Given the values of the scalar fields at a batch of DOFs, it sets the rates of change of the fields with local reaction terms (both are indexed by the field index). Models with local reaction terms override this, the default implementation gives an error.*/
+  virtual void reactionRates(const std::vector<dealii::VectorizedArray<double> > & values,
+                             std::vector<dealii::VectorizedArray<double> > & rates) const;
+
   virtual void postProcessedFields(const variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
                                                               variableContainer<dim,degree,dealii::VectorizedArray<double> > & pp_variable_list,
                                                               const dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {};
   void computePostProcessedFields(std::vector<vectorType*> &postProcessedSet);
 
-  void getPostProcessedFields(const dealii::MatrixFree<dim,double> &data,
+  virtual void getPostProcessedFields(const dealii::MatrixFree<dim,double> &data,
                                                                                       std::vector<vectorType*> &dst,
                                                                                       const std::vector<vectorType*> &src,
                                                                                       const std::pair<unsigned int,unsigned int> &cell_range);
@@ -309,4 +669,7 @@ class MatrixFreePDE:public Subscriptor
 
 };
 
+// Definitions of the templated cell loops
+#include "matrixFreePDE_cellLoops.h"
+
 #endif
@@ -0,0 +1,402 @@
+// Templated cell loop bodies for the MatrixFreePDE class (and the DOF loop for the local reaction terms)
+// These are kept in a header (rather than in src/matrixfree) so that they can be instantiated with the concrete
+// residual functor of each application, which lets the compiler inline the residual into the quadrature point loop.
+
+#ifndef MATRIXFREEPDE_CELLLOOPS_H
+#define MATRIXFREEPDE_CELLLOOPS_H
+
+template <int dim, int degree>
+template <typename number, typename residualFunctor>
+void MatrixFreePDE<dim,degree>::cellLoopRHS(const MatrixFree<dim,number> &data,
+                                            std::vector<vectorType*> &dst,
+                                            const std::vector<vectorType*> &src,
+                                            const std::pair<unsigned int,unsigned int> &cell_range,
+                                            const residualFunctor & residual) const {
+
+    // Get the container for this thread, building it if this is the first cell range the thread has worked on
+    std::shared_ptr<variableContainer<dim,degree,dealii::VectorizedArray<number> > > & variable_list_ptr = getThreadLocalContainersRHS(number()).get();
+    if (!variable_list_ptr){
+        variable_list_ptr.reset(new variableContainer<dim,degree,dealii::VectorizedArray<number> >(data,(rhsUsesSubcycleContainers ? varInfoListRHSSubcycle : userInputs.varInfoListRHS)));
+    }
+    variableContainer<dim,degree,dealii::VectorizedArray<number> > & variable_list = *variable_list_ptr;
+
+    //loop over cells
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell){
+
+        // Initialize, read DOFs, and set evaulation flags for each variable
+        // When evaluating at the current solution, fields stored in single precision are read from solutionSetFloat
+        if (rhsReadsSinglePrecisionFields){
+            variable_list.reinit_and_eval(src, solutionSetFloat, cell);
+        }
+        else {
+            variable_list.reinit_and_eval(src, cell);
+        }
+
+        unsigned int num_q_points = variable_list.get_num_q_points();
+
+        // The quadrature point locations are only available if the application asked for them, otherwise the
+        // residual methods get the origin
+        dealii::Point<dim, dealii::VectorizedArray<number> > q_point_loc;
+        for (unsigned int d=0; d<dim; d++){
+            q_point_loc(d) = 0.0;
+        }
+
+        //loop over quadrature points
+        for (unsigned int q=0; q<num_q_points; ++q){
+            variable_list.q_point = q;
+
+            if (userInputs.need_q_point_locations){
+                q_point_loc = variable_list.get_q_point_location();
+            }
+
+            // Calculate the residuals
+            residual(variable_list,q_point_loc);
+        }
+
+        // Only the residuals of the selected fields are integrated during the substeps of multirate time stepping
+        variable_list.integrate_and_distribute(dst, rhsFieldSubset.empty() ? NULL : &rhsFieldSubset);
+    }
+}
+
+template <int dim, int degree>
+template <typename residualFunctor>
+void MatrixFreePDE<dim,degree>::cellLoopLHS(const MatrixFree<dim,double> &data,
+                                            vectorType &dst,
+                                            const vectorType &src,
+                                            const std::pair<unsigned int,unsigned int> &cell_range,
+                                            const residualFunctor & residual) const {
+
+    // On a multigrid level, the container for this thread and the other fields are those of the level
+    const bool on_level = (&data != &matrixFreeObject);
+    static const std::vector<dealii::parallel::distributed::Vector<float>*> no_float_vectors;
+    const std::vector<vectorType*> & lhs_solution = (on_level ? mgLevelSolutionSet[mgCurrentLevel] : solutionSet);
+    const std::vector<dealii::parallel::distributed::Vector<float>*> & lhs_solution_float = (on_level ? no_float_vectors : solutionSetFloat);
+
+    // Get the container for this thread, building it if this is the first cell range the thread has worked on
+    variableContainerPtr & variable_list_ptr = (on_level ? mgThreadLocalContainersLHS[mgCurrentLevel]->get() : threadLocalContainersLHS.get());
+    if (!variable_list_ptr){
+        variable_list_ptr.reset(new variableContainer<dim,degree,dealii::VectorizedArray<double> >(data,userInputs.varInfoListLHS));
+    }
+    variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list = *variable_list_ptr;
+
+    //loop over cells
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell){
+
+        // Initialize, read DOFs, and set evaulation flags for each variable
+        variable_list.reinit_and_eval_LHS(src,lhs_solution,lhs_solution_float,cell,currentFieldIndex);
+
+        unsigned int num_q_points = variable_list.get_num_q_points();
+
+        // The quadrature point locations are only available if the application asked for them, otherwise the
+        // residual methods get the origin
+        dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc;
+        for (unsigned int d=0; d<dim; d++){
+            q_point_loc(d) = 0.0;
+        }
+
+        //loop over quadrature points
+        for (unsigned int q=0; q<num_q_points; ++q){
+            variable_list.q_point = q;
+
+            if (userInputs.need_q_point_locations){
+                q_point_loc = variable_list.get_q_point_location();
+            }
+
+            // Calculate the residuals
+            residual(variable_list,q_point_loc);
+        }
+
+        // Integrate the residuals and distribute from local to global
+        variable_list.integrate_and_distribute_LHS(dst,currentFieldIndex);
+    }
+}
+
+// The diagonal entries of the cell matrix are found one DOF at a time, by evaluating residualLHS for the unit vector of
+// that DOF (the other fields are read once per cell). This costs dofs_per_cell operator evaluations per cell, the same
+// as a single application of the operator for each DOF of a cell, and doesn't need the cell matrix to be assembled.
+template <int dim, int degree>
+template <typename residualFunctor>
+void MatrixFreePDE<dim,degree>::cellLoopLHSDiagonal(const MatrixFree<dim,double> &data,
+                                                    vectorType &dst,
+                                                    const vectorType &,
+                                                    const std::pair<unsigned int,unsigned int> &cell_range,
+                                                    const residualFunctor & residual) const {
+
+    // On a multigrid level, the container for this thread and the other fields are those of the level
+    const bool on_level = (&data != &matrixFreeObject);
+    static const std::vector<dealii::parallel::distributed::Vector<float>*> no_float_vectors;
+    const std::vector<vectorType*> & lhs_solution = (on_level ? mgLevelSolutionSet[mgCurrentLevel] : solutionSet);
+    const std::vector<dealii::parallel::distributed::Vector<float>*> & lhs_solution_float = (on_level ? no_float_vectors : solutionSetFloat);
+
+    // Get the container for this thread, building it if this is the first cell range the thread has worked on
+    variableContainerPtr & variable_list_ptr = (on_level ? mgThreadLocalContainersLHS[mgCurrentLevel]->get() : threadLocalContainersLHS.get());
+    if (!variable_list_ptr){
+        variable_list_ptr.reset(new variableContainer<dim,degree,dealii::VectorizedArray<double> >(data,userInputs.varInfoListLHS));
+    }
+    variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list = *variable_list_ptr;
+
+    const unsigned int dofs_per_cell = variable_list.get_dofs_per_cell(currentFieldIndex);
+    dealii::AlignedVector<dealii::VectorizedArray<double> > diagonal(dofs_per_cell);
+
+    // The quadrature point locations are only available if the application asked for them, otherwise the
+    // residual methods get the origin
+    dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc;
+    for (unsigned int d=0; d<dim; d++){
+        q_point_loc(d) = 0.0;
+    }
+
+    //loop over cells
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell){
+
+        // Initialize, read DOFs, and set evaulation flags for the other variables
+        variable_list.reinit_LHS_unit_vector(lhs_solution,lhs_solution_float,cell,currentFieldIndex);
+
+        unsigned int num_q_points = variable_list.get_num_q_points();
+
+        for (unsigned int i=0; i<dofs_per_cell; ++i){
+            variable_list.eval_LHS_unit_vector(currentFieldIndex,i);
+
+            //loop over quadrature points
+            for (unsigned int q=0; q<num_q_points; ++q){
+                variable_list.q_point = q;
+
+                if (userInputs.need_q_point_locations){
+                    q_point_loc = variable_list.get_q_point_location();
+                }
+
+                // Calculate the residuals
+                residual(variable_list,q_point_loc);
+            }
+
+            diagonal[i] = variable_list.integrate_LHS_unit_vector(currentFieldIndex,i);
+        }
+
+        // Distribute the diagonal entries from local to global
+        variable_list.distribute_LHS_diagonal(dst,currentFieldIndex,diagonal);
+    }
+}
+
+template <int dim, int degree>
+template <typename residualFunctor>
+void MatrixFreePDE<dim,degree>::cellLoopPostProcessedFields(const MatrixFree<dim,double> &data,
+                                                            std::vector<vectorType*> &dst,
+                                                            const std::vector<vectorType*> &src,
+                                                            const std::pair<unsigned int,unsigned int> &cell_range,
+                                                            const residualFunctor & residual) {
+
+    // Get the containers for this thread, building them if this is the first cell range the thread has worked on
+    variableContainerPtr & variable_list_ptr = threadLocalContainersPPBase.get();
+    variableContainerPtr & pp_variable_list_ptr = threadLocalContainersPP.get();
+    if (!variable_list_ptr){
+        variable_list_ptr.reset(new variableContainer<dim,degree,dealii::VectorizedArray<double> >(data,userInputs.pp_baseVarInfoList));
+        pp_variable_list_ptr.reset(new variableContainer<dim,degree,dealii::VectorizedArray<double> >(data,userInputs.pp_varInfoList,0));
+    }
+    variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list = *variable_list_ptr;
+    variableContainer<dim,degree,dealii::VectorizedArray<double> > & pp_variable_list = *pp_variable_list_ptr;
+
+    //loop over cells
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell){
+
+        // Initialize, read DOFs, and set evaulation flags for each variable
+        variable_list.reinit_and_eval(src, cell);
+        pp_variable_list.reinit(cell);
+
+        unsigned int num_q_points = variable_list.get_num_q_points();
+
+        // The quadrature point locations are only available if the application asked for them, otherwise the
+        // residual methods get the origin
+        dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc;
+        for (unsigned int d=0; d<dim; d++){
+            q_point_loc(d) = 0.0;
+        }
+
+        //loop over quadrature points
+        for (unsigned int q=0; q<num_q_points; ++q){
+            variable_list.q_point = q;
+            pp_variable_list.q_point = q;
+
+            if (userInputs.need_q_point_locations){
+                q_point_loc = variable_list.get_q_point_location();
+            }
+
+            // Calculate the residuals
+            residual(variable_list,pp_variable_list,q_point_loc);
+        }
+
+        pp_variable_list.integrate_and_distribute(dst);
+    }
+}
+
+// Integrate the local reaction terms over a time step of dt at each locally owned DOF, with the values of the scalar
+// fields at that DOF held fixed except for the fields with local reaction terms. No values from other DOFs are needed,
+// so there is no communication. The DOFs are taken in batches of the SIMD width, and each batch is integrated with
+// the Bogacki-Shampine 3(2) pair with its own adaptive step size (from the largest scaled error estimate in the batch),
+// so stiff reactions in a few places only take small steps there. The scalar fields all have the same local DOFs.
+template <int dim, int degree>
+template <typename reactionFunctor>
+void MatrixFreePDE<dim,degree>::localReactionLoop(const double dt, const reactionFunctor & reaction){
+
+    typedef dealii::VectorizedArray<double> batchType;
+    const unsigned int n_lanes = batchType::n_array_elements;
+    const unsigned int num_fields = fields.size();
+
+    std::vector<unsigned int> scalar_fields, reaction_fields;
+    for (unsigned int fieldIndex=0; fieldIndex<num_fields; fieldIndex++){
+        if (fields[fieldIndex].type == SCALAR){
+            scalar_fields.push_back(fieldIndex);
+        }
+        if (userInputs.var_local_reaction_terms[fieldIndex]){
+            reaction_fields.push_back(fieldIndex);
+        }
+    }
+
+    const unsigned int local_size = solutionSet[reaction_fields[0]]->local_size();
+    const unsigned int num_batches = (local_size + n_lanes - 1)/n_lanes;
+    if (reactionStepSizes.size() != num_batches){
+        reactionStepSizes.assign(num_batches, dt);
+    }
+
+    const embeddedRungeKuttaTableau tableau(BOGACKI_SHAMPINE_32);
+    const unsigned int num_stages = tableau.num_stages;
+
+    // Factors for the step size controller, as for the adaptive time stepping of the whole simulation
+    const double safety_factor = 0.9;
+    const double max_increase = 5.0;
+    const double max_decrease = 0.2;
+    const double controller_exponent = -1.0/(tableau.embedded_order+1.0);
+    const double time_tolerance = 1.0e-10*dt;
+    const double tolerance = userInputs.reaction_tolerance;
+
+    // Storage for the values and the stage rates of a batch, allocated once for all of the batches
+    batchType zero = dealii::make_vectorized_array(0.0);
+    std::vector<batchType> values(num_fields,zero), stage_values(num_fields,zero), new_values(num_fields,zero);
+    std::vector<std::vector<batchType> > stage_rates(num_stages, std::vector<batchType>(num_fields,zero));
+
+    unsigned int local_steps = 0, local_max_steps = 0, local_rejected_steps = 0;
+
+    for (unsigned int batch=0; batch<num_batches; batch++){
+        const unsigned int first_dof = batch*n_lanes;
+        const unsigned int num_filled_lanes = std::min(n_lanes, local_size-first_dof);
+
+        // The unused lanes of the last batch repeat the last DOF, so they don't change the error estimate
+        for (unsigned int i=0; i<scalar_fields.size(); i++){
+            const vectorType & solution = *solutionSet[scalar_fields[i]];
+            for (unsigned int lane=0; lane<n_lanes; lane++){
+                values[scalar_fields[i]][lane] = solution.local_element(first_dof + std::min(lane, num_filled_lanes-1));
+            }
+            stage_values[scalar_fields[i]] = values[scalar_fields[i]];
+        }
+
+        double t = 0.0;
+        double next_step_size = std::min(reactionStepSizes[batch], dt);
+        bool first_stage_rate_valid = false;
+        unsigned int batch_steps = 0;
+
+        while (t < dt - time_tolerance){
+            const double h = std::min(next_step_size, dt - t);
+
+            // The last stage of an accepted step is at the new values (the pair is FSAL), so its rate is reused
+            if (!first_stage_rate_valid){
+                reaction(values, stage_rates[0]);
+            }
+            for (unsigned int stage=1; stage<num_stages; stage++){
+                for (unsigned int i=0; i<reaction_fields.size(); i++){
+                    const unsigned int f = reaction_fields[i];
+                    stage_values[f] = values[f];
+                    for (unsigned int j=0; j<stage; j++){
+                        if (tableau.a[stage][j] != 0.0){
+                            stage_values[f] += (h*tableau.a[stage][j])*stage_rates[j][f];
+                        }
+                    }
+                }
+                reaction(stage_values, stage_rates[stage]);
+            }
+
+            // Largest error estimate in the batch, scaled by the tolerance
+            double error_norm = 0.0;
+            for (unsigned int i=0; i<reaction_fields.size(); i++){
+                const unsigned int f = reaction_fields[i];
+                batchType error = zero;
+                new_values[f] = values[f];
+                for (unsigned int j=0; j<num_stages; j++){
+                    new_values[f] += (h*tableau.b[j])*stage_rates[j][f];
+                    error += (h*(tableau.b[j]-tableau.b_hat[j]))*stage_rates[j][f];
+                }
+                for (unsigned int lane=0; lane<n_lanes; lane++){
+                    const double scale = tolerance*(1.0 + std::max(std::abs(values[f][lane]),std::abs(new_values[f][lane])));
+                    const double scaled_error = std::abs(error[lane])/scale;
+                    // Written so that a NaN rejects the step
+                    if (!(scaled_error <= error_norm)){
+                        error_norm = scaled_error;
+                    }
+                }
+            }
+
+            if (error_norm <= 1.0){
+                t += h;
+                for (unsigned int i=0; i<reaction_fields.size(); i++){
+                    values[reaction_fields[i]] = new_values[reaction_fields[i]];
+                }
+                std::swap(stage_rates[0],stage_rates[num_stages-1]);
+                first_stage_rate_valid = true;
+                batch_steps++;
+
+                // A step that was shortened to reach the end of the time step doesn't shrink the proposed step size
+                const double proposed_step_size = h*std::min(max_increase, safety_factor*std::pow(std::max(error_norm,1.0e-10),controller_exponent));
+                next_step_size = (h < next_step_size) ? std::max(next_step_size, proposed_step_size) : proposed_step_size;
+            }
+            else {
+                local_rejected_steps++;
+                if (numbers::is_finite(error_norm)){
+                    next_step_size = h*std::max(max_decrease, safety_factor*std::pow(error_norm,controller_exponent));
+                }
+                else {
+                    next_step_size = h*max_decrease;
+                }
+
+                if (next_step_size < time_tolerance){
+                    char buffer[200];
+                    sprintf(buffer, "ERROR: the step size for the local reaction terms fell below %12.6e without meeting the error tolerance. exiting.\n\n", time_tolerance);
+                    std::cerr << buffer;
+                    exit(-1);
+                }
+            }
+        }
+
+        reactionStepSizes[batch] = next_step_size;
+        local_steps += batch_steps;
+        local_max_steps = std::max(local_max_steps, batch_steps);
+
+        for (unsigned int i=0; i<reaction_fields.size(); i++){
+            vectorType & solution = *solutionSet[reaction_fields[i]];
+            for (unsigned int lane=0; lane<num_filled_lanes; lane++){
+                solution.local_element(first_dof + lane) = values[reaction_fields[i]][lane];
+            }
+        }
+    }
+
+    // Set the Dirichlet values again
+    for (unsigned int i=0; i<reaction_fields.size(); i++){
+        const unsigned int f = reaction_fields[i];
+        for (unsigned int k=0; k<localDirichletValues[f].size(); ++k){
+            solutionSet[f]->local_element(localDirichletValues[f][k].first) = localDirichletValues[f][k].second;
+        }
+        solutionSet[f]->update_ghost_values();
+    }
+
+    if (currentIncrement%userInputs.skip_print_steps==0){
+        const double total_steps = Utilities::MPI::sum((double)local_steps, mpi_communicator);
+        const double total_batches = Utilities::MPI::sum((double)num_batches, mpi_communicator);
+        const unsigned int max_steps = Utilities::MPI::max(local_max_steps, mpi_communicator);
+        const unsigned int rejected_steps = Utilities::MPI::sum(local_rejected_steps, mpi_communicator);
+        char buffer[200];
+        sprintf(buffer, "local reactions [dt = %10.4e]: steps per DOF batch: average %6.2f, maximum %u, rejected steps: %u\n", \
+        dt,                                 \
+        total_steps/std::max(total_batches,1.0), \
+        max_steps,                          \
+        rejected_steps);
+        pcout<<buffer;
+    }
+}
+
+#endif
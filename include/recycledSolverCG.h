@@ -0,0 +1,255 @@
+// Conjugate gradient solver that recycles a Krylov subspace between the solves of an ELLIPTIC field
+#ifndef INCLUDE_RECYCLEDSOLVERCG_H_
+#define INCLUDE_RECYCLEDSOLVERCG_H_
+
+#include <vector>
+#include <memory>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include "denseSymmetricFunctions.h"
+
+/*
+ * Deflated preconditioned CG (Saad, Yeung, Erhel and Guyomarc'h, SIAM J. Sci. Comput. 21, 2000). The search directions
+ * are kept A-orthogonal to a small subspace W = span{w_1,...,w_k}, which is solved exactly with the Galerkin projection
+ * W*(W^T*A*W)^-1*W^T, so the eigenvalues of A whose eigenvectors are (approximately) in W no longer slow down the
+ * iterations. After each solve W is replaced by the Ritz vectors for the k smallest eigenvalues of A on the span of the
+ * old W and the first 2k search directions of the solve, so it improves from one solve to the next as long as the
+ * operator changes slowly. W is kept by the caller between solves, and is empty for the first one.
+ *
+ * With no recycled vectors allowed (max_recycled = 0) this is SolverCG.
+ */
+template <typename VectorType>
+class SolverRecycledCG
+{
+public:
+    SolverRecycledCG(dealii::SolverControl & _control, std::vector<std::shared_ptr<VectorType> > & _recycled, const unsigned int _max_recycled)
+        : control(_control), recycled(_recycled), max_recycled(_max_recycled) {}
+
+    template <typename MatrixType, typename PreconditionerType>
+    void solve(const MatrixType & A, VectorType & x, const VectorType & b, const PreconditionerType & preconditioner);
+
+private:
+    // Solves (W^T*A*W)*mu = basis^T*v (with the basis W or A*W) with the Cholesky factor of W^T*A*W
+    std::vector<double> coarseSolve(const std::vector<const VectorType*> & basis, const VectorType & v) const;
+
+    // Replaces W with the Ritz vectors from the span of the old W and the search directions
+    void updateRecycledVectors(const std::vector<VectorType> & directions, const std::vector<double> & direction_energies);
+
+    dealii::SolverControl & control;
+    std::vector<std::shared_ptr<VectorType> > & recycled;
+    const unsigned int max_recycled;
+
+    // W^T*A*W and its Cholesky factor for the current solve
+    denseMatrix coarse_matrix, coarse_factor;
+};
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void SolverRecycledCG<VectorType>::solve(const MatrixType & A, VectorType & x, const VectorType & b, const PreconditionerType & preconditioner){
+
+    if (max_recycled == 0){
+        dealii::SolverCG<VectorType> solver(control);
+        solver.solve(A, x, b, preconditioner);
+        return;
+    }
+
+    // A*W for the current operator (its coefficients may have changed since the last solve). If W^T*A*W isn't positive
+    // definite any more, the recycled vectors are dropped.
+    std::vector<VectorType> AW(recycled.size());
+    for (unsigned int j=0; j<recycled.size(); j++){
+        AW[j].reinit(x);
+        A.vmult(AW[j], *recycled[j]);
+    }
+    coarse_matrix.assign(recycled.size(), std::vector<double>(recycled.size(),0.0));
+    for (unsigned int i=0; i<recycled.size(); i++){
+        for (unsigned int j=0; j<=i; j++){
+            coarse_matrix[i][j] = 0.5*((*recycled[i])*AW[j] + (*recycled[j])*AW[i]);
+            coarse_matrix[j][i] = coarse_matrix[i][j];
+        }
+    }
+    coarse_factor = coarse_matrix;
+    if (!denseCholesky(coarse_factor)){
+        recycled.clear();
+        AW.clear();
+        coarse_matrix.clear();
+        coarse_factor.clear();
+    }
+    const unsigned int k = recycled.size();
+    std::vector<const VectorType*> W_ptrs(k), AW_ptrs(k);
+    for (unsigned int j=0; j<k; j++){
+        W_ptrs[j] = recycled[j].get();
+        AW_ptrs[j] = &AW[j];
+    }
+
+    VectorType r, z, p, q;
+    r.reinit(x);
+    z.reinit(x);
+    p.reinit(x);
+    q.reinit(x);
+
+    // Initial residual, with the error in W removed from the initial guess
+    A.vmult(r, x);
+    r.sadd(-1.0, 1.0, b);
+    if (k > 0){
+        const std::vector<double> mu = coarseSolve(W_ptrs, r);
+        for (unsigned int j=0; j<k; j++){
+            x.add(mu[j], *recycled[j]);
+            r.add(-mu[j], AW[j]);
+        }
+    }
+
+    const unsigned int num_directions = 2*max_recycled;
+    std::vector<VectorType> directions;
+    std::vector<double> direction_energies;
+
+    unsigned int iteration = 0;
+    dealii::SolverControl::State state = control.check(iteration, r.l2_norm());
+    if (state == dealii::SolverControl::iterate){
+        preconditioner.vmult(z, r);
+        p = z;
+        if (k > 0){
+            const std::vector<double> mu = coarseSolve(AW_ptrs, z);
+            for (unsigned int j=0; j<k; j++){
+                p.add(-mu[j], *recycled[j]);
+            }
+        }
+        double rz = r*z;
+
+        while (state == dealii::SolverControl::iterate){
+            iteration++;
+            A.vmult(q, p);
+            const double pq = p*q;
+            if (directions.size() < num_directions && pq > 0.0){
+                directions.push_back(p);
+                direction_energies.push_back(pq);
+            }
+
+            const double alpha = rz/pq;
+            x.add(alpha, p);
+            r.add(-alpha, q);
+
+            state = control.check(iteration, r.l2_norm());
+            if (state != dealii::SolverControl::iterate){
+                break;
+            }
+
+            preconditioner.vmult(z, r);
+            const double rz_new = r*z;
+            const double beta = rz_new/rz;
+            rz = rz_new;
+            p.sadd(beta, 1.0, z);
+            if (k > 0){
+                const std::vector<double> mu = coarseSolve(AW_ptrs, z);
+                for (unsigned int j=0; j<k; j++){
+                    p.add(-mu[j], *recycled[j]);
+                }
+            }
+        }
+    }
+
+    // The subspace is updated even if the solve didn't converge, its search directions are still useful
+    updateRecycledVectors(directions, direction_energies);
+
+    AssertThrow(state == dealii::SolverControl::success, dealii::SolverControl::NoConvergence(control.last_step(), control.last_value()));
+}
+
+template <typename VectorType>
+std::vector<double> SolverRecycledCG<VectorType>::coarseSolve(const std::vector<const VectorType*> & basis, const VectorType & v) const {
+    std::vector<double> rhs(basis.size());
+    for (unsigned int j=0; j<basis.size(); j++){
+        rhs[j] = (*basis[j])*v;
+    }
+    return denseCholeskySolve(coarse_factor, rhs);
+}
+
+// Rayleigh-Ritz for Z = [W, P] with the search directions P: the eigenvectors y of Z^T*A*Z*y = theta*Z^T*Z*y for the
+// smallest theta give the new w = Z*y. The search directions are A-orthogonal to each other and to W, so Z^T*A*Z is
+// block diagonal with W^T*A*W and the energies p^T*A*p, and only Z^T*Z needs inner products. With the Cholesky factor
+// L of Z^T*A*Z the problem becomes the symmetric eigenproblem of L^-1*Z^T*Z*L^-T for the largest 1/theta, and the new
+// vectors are A-orthonormal.
+template <typename VectorType>
+void SolverRecycledCG<VectorType>::updateRecycledVectors(const std::vector<VectorType> & directions, const std::vector<double> & direction_energies){
+
+    const unsigned int k = recycled.size();
+    const unsigned int n = k + directions.size();
+    if (n == 0){
+        return;
+    }
+
+    std::vector<const VectorType*> Z(n);
+    for (unsigned int j=0; j<k; j++){
+        Z[j] = recycled[j].get();
+    }
+    for (unsigned int j=k; j<n; j++){
+        Z[j] = &directions[j-k];
+    }
+
+    denseMatrix L(n, std::vector<double>(n,0.0));
+    for (unsigned int i=0; i<k; i++){
+        for (unsigned int j=0; j<k; j++){
+            L[i][j] = coarse_matrix[i][j];
+        }
+    }
+    for (unsigned int j=k; j<n; j++){
+        L[j][j] = direction_energies[j-k];
+    }
+    if (!denseCholesky(L)){
+        return;
+    }
+
+    denseMatrix G(n, std::vector<double>(n,0.0));
+    for (unsigned int i=0; i<n; i++){
+        for (unsigned int j=0; j<=i; j++){
+            G[i][j] = (*Z[i])*(*Z[j]);
+            G[j][i] = G[i][j];
+        }
+    }
+
+    // C = L^-1*G*L^-T, one column at a time (G and C are symmetric)
+    denseMatrix C(n, std::vector<double>(n,0.0));
+    for (unsigned int j=0; j<n; j++){
+        denseCholeskyForward(L, G[j]);
+    }
+    for (unsigned int i=0; i<n; i++){
+        std::vector<double> row(n);
+        for (unsigned int j=0; j<n; j++){
+            row[j] = G[j][i];
+        }
+        denseCholeskyForward(L, row);
+        for (unsigned int j=0; j<n; j++){
+            C[i][j] = row[j];
+        }
+    }
+    for (unsigned int i=0; i<n; i++){
+        for (unsigned int j=0; j<i; j++){
+            C[i][j] = C[j][i] = 0.5*(C[i][j] + C[j][i]);
+        }
+    }
+
+    std::vector<double> eigenvalues;
+    denseMatrix eigenvectors;
+    denseSymmetricEigen(C, eigenvalues, eigenvectors);
+
+    std::vector<std::shared_ptr<VectorType> > new_recycled;
+    for (unsigned int m=0; m<std::min(max_recycled, n); m++){
+        const unsigned int index = n-1-m;
+        if (!(eigenvalues[index] > 0.0)){
+            break;
+        }
+        std::vector<double> y(n);
+        for (unsigned int i=0; i<n; i++){
+            y[i] = eigenvectors[i][index];
+        }
+        denseCholeskyBackward(L, y);
+
+        std::shared_ptr<VectorType> w(new VectorType);
+        w->reinit(*Z[0]);
+        for (unsigned int i=0; i<n; i++){
+            w->add(y[i], *Z[i]);
+        }
+        new_recycled.push_back(w);
+    }
+    recycled.swap(new_recycled);
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include "varTypeEnums.h"
 
 std::vector<bool> sortIndexEntryPairList(const std::vector<std::pair<unsigned int,bool> > unsorted_pair_list, unsigned int number_of_variables, bool default_value);
+std::vector<unsigned int> sortIndexEntryPairList(const std::vector<std::pair<unsigned int,unsigned int> > unsorted_pair_list, unsigned int number_of_variables, unsigned int default_value);
 std::vector<std::string> sortIndexEntryPairList(const std::vector<std::pair<unsigned int,std::string> > unsorted_pair_list, unsigned int number_of_variables, std::string default_value);
 std::vector<fieldType> sortIndexEntryPairList(const std::vector<std::pair<unsigned int,fieldType> > unsorted_pair_list, unsigned int number_of_variables, fieldType default_value);
 std::vector<PDEType> sortIndexEntryPairList(const std::vector<std::pair<unsigned int,PDEType> > unsorted_pair_list, unsigned int number_of_variables, PDEType default_value);
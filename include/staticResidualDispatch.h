@@ -0,0 +1,105 @@
+// Statically dispatched cell loops for a model class derived from MatrixFreePDE
+//
+// This file is meant to be included inside the declaration of the 'customPDE' class of an application (in the same
+// way as typeDefs.h), after the declarations of residualRHS, residualLHS and postProcessedFields. It overrides the
+// virtual getRHS (double and single precision)/getLHS/getLHSDiagonal/getPostProcessedFields/integrateLocalReactions methods of
+// MatrixFreePDE with versions that call the residual methods of customPDE through a qualified name. The calls are then
+// resolved at compile time, so the residual can be inlined into the quadrature point loop instead of being called
+// through the virtual function table at every quadrature point.
+//
+// residualRHS and residualLHS are declared in customPDE as templates on the container type. The overrides of the
+// virtual residual methods of MatrixFreePDE below call them with a variableContainer, and the overrides of
+// traceResidualRHS/traceResidualLHS call them with the variableContainerTrace used by traceVariableNeeds.
+
+void residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+				 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
+	this->template residualRHS<variableContainer<dim,degree,dealii::VectorizedArray<double> > >(variable_list,q_point_loc);
+}
+
+void residualLHS(variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+				 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
+	this->template residualLHS<variableContainer<dim,degree,dealii::VectorizedArray<double> > >(variable_list,q_point_loc);
+}
+
+bool traceResidualRHS(variableContainerTrace<dim,degree> & variable_list,
+				 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
+	this->template residualRHS<variableContainerTrace<dim,degree> >(variable_list,q_point_loc);
+	return true;
+}
+
+bool traceResidualLHS(variableContainerTrace<dim,degree> & variable_list,
+				 dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
+	this->template residualLHS<variableContainerTrace<dim,degree> >(variable_list,q_point_loc);
+	return true;
+}
+
+void getRHS(const dealii::MatrixFree<dim,double> &data,
+			std::vector<dealii::parallel::distributed::Vector<double>*> &dst,
+			const std::vector<dealii::parallel::distributed::Vector<double>*> &src,
+			const std::pair<unsigned int,unsigned int> &cell_range) const {
+	this->cellLoopRHS(data,dst,src,cell_range,
+		[this](variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+			   const dealii::Point<dim, dealii::VectorizedArray<double> > & q_point_loc){
+			customPDE::residualRHS(variable_list,q_point_loc);
+		});
+}
+
+// Make the single precision residualRHS of MatrixFreePDE visible, so the call below resolves to it (and gives an error)
+// if this application doesn't provide its own single precision version
+using MatrixFreePDE<dim,degree>::residualRHS;
+
+void getRHS(const dealii::MatrixFree<dim,float> &data,
+			std::vector<dealii::parallel::distributed::Vector<double>*> &dst,
+			const std::vector<dealii::parallel::distributed::Vector<double>*> &src,
+			const std::pair<unsigned int,unsigned int> &cell_range) const {
+	this->cellLoopRHS(data,dst,src,cell_range,
+		[this](variableContainer<dim,degree,dealii::VectorizedArray<float> > & variable_list,
+			   const dealii::Point<dim, dealii::VectorizedArray<float> > & q_point_loc){
+			customPDE::residualRHS(variable_list,q_point_loc);
+		});
+}
+
+void getLHS(const dealii::MatrixFree<dim,double> &data,
+			dealii::parallel::distributed::Vector<double> &dst,
+			const dealii::parallel::distributed::Vector<double> &src,
+			const std::pair<unsigned int,unsigned int> &cell_range) const {
+	this->cellLoopLHS(data,dst,src,cell_range,
+		[this](variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+			   const dealii::Point<dim, dealii::VectorizedArray<double> > & q_point_loc){
+			customPDE::residualLHS(variable_list,q_point_loc);
+		});
+}
+
+void getLHSDiagonal(const dealii::MatrixFree<dim,double> &data,
+			dealii::parallel::distributed::Vector<double> &dst,
+			const dealii::parallel::distributed::Vector<double> &src,
+			const std::pair<unsigned int,unsigned int> &cell_range) const {
+	this->cellLoopLHSDiagonal(data,dst,src,cell_range,
+		[this](variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+			   const dealii::Point<dim, dealii::VectorizedArray<double> > & q_point_loc){
+			customPDE::residualLHS(variable_list,q_point_loc);
+		});
+}
+
+// Applications without local reaction terms get the reactionRates of MatrixFreePDE here, which is never called
+void integrateLocalReactions(const double dt){
+	this->localReactionLoop(dt,
+		[this](const std::vector<dealii::VectorizedArray<double> > & values,
+			   std::vector<dealii::VectorizedArray<double> > & rates){
+			customPDE::reactionRates(values,rates);
+		});
+}
+
+#ifdef POSTPROCESS_FILE_EXISTS
+void getPostProcessedFields(const dealii::MatrixFree<dim,double> &data,
+			std::vector<dealii::parallel::distributed::Vector<double>*> &dst,
+			const std::vector<dealii::parallel::distributed::Vector<double>*> &src,
+			const std::pair<unsigned int,unsigned int> &cell_range) {
+	this->cellLoopPostProcessedFields(data,dst,src,cell_range,
+		[this](const variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+			   variableContainer<dim,degree,dealii::VectorizedArray<double> > & pp_variable_list,
+			   const dealii::Point<dim, dealii::VectorizedArray<double> > & q_point_loc){
+			customPDE::postProcessedFields(variable_list,pp_variable_list,q_point_loc);
+		});
+}
+#endif
@@ -77,12 +77,68 @@ public:
 	double finalTime;
 	unsigned int totalIncrements;
 
+	// Time integration scheme for the PARABOLIC fields. For the adaptive schemes, dtValue is the initial time step and
+	// the output and checkpoint increments are converted to simulated times using dtValue.
+	timeIntegrationScheme time_integration_scheme;
+	bool adaptive_time_stepping;
+	// Number of steps of the multistep (Adams-Bashforth) schemes, zero for the other schemes
+	unsigned int multistep_order;
+	double time_integration_tolerance;
+	double max_dt;
+	// Order of the implicit backward differentiation formula, zero for the other schemes, and the parameters of the
+	// Newton iterations that solve for each time step
+	unsigned int bdf_order;
+	double newton_tolerance;
+	unsigned int max_newton_iterations;
+	// Order of the exponential time differencing scheme, zero for the other schemes, and the parameters of the Krylov
+	// approximations of the phi-functions of the linear terms
+	unsigned int etd_order;
+	unsigned int krylov_max_dimension;
+	double krylov_tolerance;
+
+	// Whether the time step is set from an estimate of the largest stable forward Euler time step (dtValue is then only
+	// the time step the residuals are written for, and the unit for the output and checkpoint increments)
+	bool automatic_time_step;
+	double time_step_safety_factor;
+
+	// Number of time step sizes for local time stepping, each twice the next smaller one (one for a global time step)
+	unsigned int local_time_stepping_levels;
+
+	// Whether the RHS residuals are evaluated in single precision
+	bool single_precision_residual;
+
+	// Whether each field is stored in single precision during time stepping
+	std::vector<bool> var_single_precision_storage;
+
+	// Whether the value/gradient/hessian needs are taken from a trace of the residual methods instead of equations.h
+	bool infer_variable_needs;
+
 	// Elliptic solver parameters
 	std::string solver_type;
 	bool abs_tol;
 	double solver_tolerance;
 	unsigned int max_solver_iterations;
 
+	// Preconditioner for the linear solver of the ELLIPTIC fields, and the degree and the eigenvalue range of the
+	// Chebyshev smoothers of the geometric multigrid preconditioner
+	linearPreconditioner linear_preconditioner;
+	unsigned int mg_smoother_degree;
+	double mg_smoothing_range;
+
+	// Degree and eigenvalue range of the Chebyshev preconditioner, the number of CG iterations for the eigenvalue
+	// estimates of the Chebyshev preconditioner and smoothers, and whether the diagonal of the Jacobi and Chebyshev
+	// preconditioners is recomputed before every solve
+	unsigned int chebyshev_degree;
+	double chebyshev_smoothing_range;
+	unsigned int eigenvalue_estimate_iterations;
+	bool recompute_preconditioner_diagonal;
+
+	// Initial guess for the solves of the ELLIPTIC fields and the number of previous solutions it uses, and the number
+	// of Krylov vectors recycled between the solves
+	ellipticInitialGuess elliptic_initial_guess;
+	unsigned int initial_guess_history_size;
+	unsigned int recycled_krylov_vectors;
+
 	// Variable inputs
 	unsigned int number_of_variables;
 
@@ -93,6 +149,50 @@ public:
 	// Variables needed to calculate the RHS
 	std::vector<variable_info> varInfoListRHS;
 
+	// Whether the residual methods use the quadrature point locations (otherwise they aren't computed or stored)
+	bool need_q_point_locations;
+
+	// Whether the linear terms of each PARABOLIC equation are treated implicitly, and whether any of them are
+	bool imex_time_integration;
+	std::vector<bool> var_implicit_linear_terms;
+
+	// Number of substeps of each PARABOLIC field in each time step for multirate time stepping, and the largest number
+	unsigned int max_subcycling_steps;
+	std::vector<unsigned int> var_subcycling_steps;
+
+	// Whether each PARABOLIC equation has local reaction terms that are split from the rest of the equation, whether
+	// any of them do, and the tolerance for the adaptive integration of the reaction terms at each DOF
+	bool local_reaction_splitting;
+	std::vector<bool> var_local_reaction_terms;
+	double reaction_tolerance;
+
+	// Parallel-in-time integration with Parareal: the number of time slices (one if it isn't used), the time step of the
+	// coarse propagator as a multiple of dtValue, whether the coarse propagator is BDF1 (otherwise forward Euler), and
+	// the convergence criteria
+	unsigned int parareal_time_slices;
+	unsigned int parareal_coarse_factor;
+	bool parareal_coarse_bdf;
+	double parareal_tolerance;
+	unsigned int max_parareal_iterations;
+
+	// Recovery from a blow-up of the solution: the number of snapshots of the solution kept in memory (zero if it isn't
+	// used), the number of increments between them, the factor the time step is divided by after each blow-up, the
+	// maximum number of reductions, and the number of increments before a reduced time step is increased again
+	unsigned int blowup_recovery_snapshots;
+	unsigned int blowup_snapshot_interval;
+	unsigned int blowup_step_reduction_factor;
+	unsigned int max_blowup_step_reductions;
+	unsigned int blowup_steps_before_increase;
+
+	// Steady state termination: the tolerance on the time-averaged rate of change of each field (zero if it isn't
+	// used), the number of increments it is averaged over, whether the max norm is used (otherwise the l2 norm), and
+	// whether the time step is increased by the factor at a steady state instead of stopping the simulation
+	double steady_state_tolerance;
+	unsigned int steady_state_interval;
+	bool steady_state_linfty_norm;
+	bool steady_state_increase_time_step;
+	double steady_state_step_factor;
+
 	// Variables needed to calculate the LHS
 	unsigned int num_var_LHS;
 	std::vector<variable_info> varInfoListLHS;
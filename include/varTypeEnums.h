@@ -3,5 +3,8 @@
 
 enum fieldType {SCALAR, VECTOR};
 enum PDEType {PARABOLIC, ELLIPTIC};
+enum timeIntegrationScheme {FORWARD_EULER, BOGACKI_SHAMPINE_32, DORMAND_PRINCE_54, ADAMS_BASHFORTH_2, ADAMS_BASHFORTH_3, BACKWARD_DIFFERENTIATION_1, BACKWARD_DIFFERENTIATION_2, EXPONENTIAL_EULER, EXPONENTIAL_RUNGE_KUTTA_2};
+enum linearPreconditioner {IDENTITY_PRECONDITIONER, JACOBI_PRECONDITIONER, CHEBYSHEV_PRECONDITIONER, GMG_PRECONDITIONER};
+enum ellipticInitialGuess {ZERO_INITIAL_GUESS, EXTRAPOLATED_INITIAL_GUESS, PROJECTED_INITIAL_GUESS};
 
 #endif
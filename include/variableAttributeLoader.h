@@ -39,6 +39,22 @@ public:
 
     void set_output_integral(unsigned int index, bool);
 
+    // Method to declare that the linear terms of a PARABOLIC equation are treated implicitly (they are left out of
+    // residualRHS and given in residualLHS instead, as for an ELLIPTIC equation)
+    void set_implicit_linear_terms(unsigned int index, bool);
+
+    // Method to set the number of substeps a PARABOLIC field takes in each time step (for fields that change faster
+    // than the others). residualRHS is still evaluated for all of the fields in each extra substep, only the residuals
+    // of the subcycled fields are integrated, so a substep costs about as much as a full time step.
+    void set_subcycling_steps(unsigned int index, unsigned int);
+
+    // Method to declare that a PARABOLIC equation has local reaction terms (terms that only depend on the values of the
+    // fields at the same point), which are left out of residualRHS and given in reactionRates instead
+    void set_local_reaction_terms(unsigned int index, bool);
+
+    // Method to declare that the residual methods use the quadrature point locations ("q_point_loc")
+    void set_need_q_point_locations(bool);
+
 
     // Variable inputs (v2.0)
     std::vector<std::pair<unsigned int, std::string> > var_name_list;
@@ -60,12 +76,17 @@ public:
     std::vector<std::pair<unsigned int, bool> > need_hessian_list_PP;
     std::vector<std::pair<unsigned int, bool> > need_value_list_nucleation;
     std::vector<std::pair<unsigned int, bool> > nucleating_variable_list;
+    std::vector<std::pair<unsigned int, bool> > implicit_linear_terms_list;
+    std::vector<std::pair<unsigned int, unsigned int> > subcycling_steps_list;
+    std::vector<std::pair<unsigned int, bool> > local_reaction_terms_list;
 
     std::vector<std::pair<unsigned int, std::string> > var_name_list_PP;
     std::vector<std::pair<unsigned int, fieldType> > var_type_list_PP;
     std::vector<std::pair<unsigned int, bool> > output_integral_list;
     std::vector<std::pair<unsigned int, bool> > need_value_residual_list_PP;
     std::vector<std::pair<unsigned int, bool> > need_gradient_residual_list_PP;
+
+    bool need_q_point_locations;
 };
 
 
@@ -4,20 +4,42 @@
 
 #include "userInputParameters.h"
 
+// Helper to get the underlying number type (double or float) of a VectorizedArray
+template <typename T>
+struct vectorizedArrayNumber;
+
+template <typename Number>
+struct vectorizedArrayNumber<dealii::VectorizedArray<Number> >
+{
+    typedef Number type;
+};
+
 template <int dim, int degree, typename T>
 class variableContainer
 {
 public:
     #include "typeDefs.h"
 
+    // The number type used for the FEEvaluation objects and the MatrixFree object (the solution and residual vectors are always double)
+    typedef typename vectorizedArrayNumber<T>::type number;
+
+    // Vector type for fields that are stored in single precision (the FEEvaluation objects convert them on read)
+    typedef dealii::parallel::distributed::Vector<float> floatVectorType;
+
     // Constructors
 
     // Standard contructor, used for most situations
-    variableContainer(const dealii::MatrixFree<dim,double> &data, std::vector<variable_info> _varInfoList);
+    variableContainer(const dealii::MatrixFree<dim,number> &data, std::vector<variable_info> _varInfoList);
     // Nonstandard constructor, used when only one index of "data" should be used, use with care!
-    variableContainer(const dealii::MatrixFree<dim,double> &data, std::vector<variable_info> _varInfoList, unsigned int fixed_index);
+    variableContainer(const dealii::MatrixFree<dim,number> &data, std::vector<variable_info> _varInfoList, unsigned int fixed_index);
+
+    // The lookup tables below point into scalar_vars and vector_vars, so the container can't be copied
+    variableContainer(const variableContainer &) = delete;
+    variableContainer & operator=(const variableContainer &) = delete;
 
     // Methods to get the value/grad/hess in the residual method (this is how the user gets these values in equations.h)
+    // These are defined inline below so they can be inlined into the residual methods. The check that the requested
+    // value/grad/hess was marked as needed is only done in debug mode.
     T get_scalar_value(unsigned int global_variable_index) const;
     dealii::Tensor<1, dim, T > get_scalar_gradient(unsigned int global_variable_index) const;
     dealii::Tensor<2, dim, T > get_scalar_hessian(unsigned int global_variable_index) const;
@@ -31,20 +53,42 @@ public:
     void set_vector_value_residual_term(unsigned int global_variable_index, dealii::Tensor<1, dim, T > val);
     void set_vector_gradient_residual_term(unsigned int global_variable_index, dealii::Tensor<2, dim, T > grad);
 
-    // Hold-over from previous version that caches the residual terms instead of over-writing what's in vector_vars.
-    // This approach was abandoned because it caused a 20% decrease in speed.
-    // Method to apply the residuals stored in the temporary vectors to the FEEvaluation objects
-    //void apply_residuals();
+    // Methods to stage the value residual and the gradient residual without over-writing the values in scalar_vars and
+    // vector_vars. This lets the residual method read all of the fields before any residuals are written. The staged
+    // terms are held in storage that is allocated once in the constructor, and are passed to the FEEvaluation objects
+    // by a call to apply_staged_residuals() at the end of the residual method.
+    void stage_scalar_value_residual_term(unsigned int global_variable_index, const T & val);
+    void stage_scalar_gradient_residual_term(unsigned int global_variable_index, const dealii::Tensor<1, dim, T > & grad);
+    void stage_vector_value_residual_term(unsigned int global_variable_index, const dealii::Tensor<1, dim, T > & val);
+    void stage_vector_gradient_residual_term(unsigned int global_variable_index, const dealii::Tensor<2, dim, T > & grad);
+
+    // Method to apply the residuals staged since the last call to the FEEvaluation objects (each residual term should be
+    // staged at most once per quadrature point)
+    void apply_staged_residuals();
 
     // Initialize, read DOFs, and set evaulation flags for each variable
     void reinit_and_eval(const std::vector<vectorType*> &src, unsigned int cell);
     void reinit_and_eval_LHS(const vectorType &src, const std::vector<vectorType*> solutionSet, unsigned int cell, unsigned int var_being_solved);
 
+    // Variants where the DOF values of variable i are read from src_float[i] instead, if that entry isn't NULL (used for fields stored in single precision)
+    void reinit_and_eval(const std::vector<vectorType*> &src, const std::vector<floatVectorType*> &src_float, unsigned int cell);
+    void reinit_and_eval_LHS(const vectorType &src, const std::vector<vectorType*> &solutionSet, const std::vector<floatVectorType*> &solutionSet_float, unsigned int cell, unsigned int var_being_solved);
+
+    // Methods for the diagonal of the LHS operator, one unit vector of the variable being solved at a time: initialize
+    // and read the other variables for the cell, set and evaluate the unit vector of a DOF, integrate and return the
+    // entry for the same DOF, and distribute the diagonal entries of the cell from local to global
+    void reinit_LHS_unit_vector(const std::vector<vectorType*> &solutionSet, const std::vector<floatVectorType*> &solutionSet_float, unsigned int cell, unsigned int var_being_solved);
+    void eval_LHS_unit_vector(unsigned int var_being_solved, unsigned int dof);
+    T integrate_LHS_unit_vector(unsigned int var_being_solved, unsigned int dof);
+    void distribute_LHS_diagonal(vectorType &dst, unsigned int var_being_solved, const dealii::AlignedVector<T> &diagonal);
+    unsigned int get_dofs_per_cell(unsigned int global_variable_index) const;
+
     // Only initialize the FEEvaluation object for each variable (used for post-processing)
     void reinit(unsigned int cell);
 
-    // Integrate the residuals and distribute from local to global
-    void integrate_and_distribute(std::vector<vectorType*> &dst);
+    // Integrate the residuals and distribute from local to global (only for the variables flagged in "var_subset", if
+    // it is given)
+    void integrate_and_distribute(std::vector<vectorType*> &dst, const std::vector<bool> * var_subset = NULL);
     void integrate_and_distribute_LHS(vectorType &dst, unsigned int var_being_solved);
 
     // The quadrature point index, a method to get the number of quadrature points per cell, and a method to get the xyz coordinates for the quadrature point
@@ -60,23 +104,178 @@ private:
     unsigned int num_var;
 
     // Vectors of the actual FEEvaluation objects for each active variable, split into scalar variables and vector variables for type reasons
-    std::vector<dealii::FEEvaluation<dim,degree,degree+1,1,double> > scalar_vars;
-    std::vector<dealii::FEEvaluation<dim,degree,degree+1,dim,double> > vector_vars;
+    std::vector<dealii::FEEvaluation<dim,degree,degree+1,1,number> > scalar_vars;
+    std::vector<dealii::FEEvaluation<dim,degree,degree+1,dim,number> > vector_vars;
 
     // Object containing some information about each variable (indices, whether the val/grad/hess is needed, etc)
     std::vector<variable_info> varInfoList;
 
-    // Vectors to hold the residuals temporarily until they are applied to scalar_vars and vector_vars
-    // These are needed so that the "set" calls don't over-write the values in scalar_vars and vector_vars until after the call to residualRHS/residualLHS/postProcessedFields
+    // Whether the quadrature points coincide with the nodes of the element (true for the default Gauss-Lobatto elements
+    // and quadrature). If so, the value at each quadrature point is just the nodal value, so the value interpolation in
+    // evaluate() and integrate() can be skipped and the values are read/written directly from/to the DOF values.
+    bool collocation;
+    bool check_collocation(const dealii::MatrixFree<dim,number> &data) const;
+
+    // Method to integrate a value residual for a collocated element, which only has to copy the submitted values into the DOF values
+    template <typename FEEvaluationType>
+    void integrate_values_collocation(FEEvaluationType & var) const;
+
+    // Lookup tables from the global variable index directly to the FEEvaluation object for that variable (NULL if the
+    // variable isn't needed or is of the other type), so the accessors don't have to go through varInfoList
+    std::vector<dealii::FEEvaluation<dim,degree,degree+1,1,number>*> scalar_var_ptr;
+    std::vector<dealii::FEEvaluation<dim,degree,degree+1,dim,number>*> vector_var_ptr;
+
+    // Shared body of reinit_and_eval_LHS and reinit_LHS_unit_vector (src is NULL for the latter)
+    void reinit_and_eval_LHS(const vectorType *src, const std::vector<vectorType*> &solutionSet, const std::vector<floatVectorType*> &solutionSet_float, unsigned int cell, unsigned int var_being_solved);
+
+    // Method to fill the lookup tables, called at the end of the constructors
+    void setup_lookup_tables();
+
+    // Vectors to hold the staged residuals until they are applied to scalar_vars and vector_vars
+    // The index vectors give the slot of each variable in the storage vectors (-1 if it has no residual of that type).
+    // The storage vectors are sized in the constructors and the lists of staged variables have their capacity reserved
+    // there, so staging and applying the residuals doesn't allocate any memory.
     std::vector<int> scalar_value_index;
     std::vector<int> scalar_gradient_index;
     std::vector<int> vector_value_index;
     std::vector<int> vector_gradient_index;
 
-    std::vector<T> scalar_value;
-    std::vector<dealii::Tensor<1, dim, T > > scalar_gradient;
-    std::vector<dealii::Tensor<1, dim, T > > vector_value;
-    std::vector<dealii::Tensor<2, dim, T > > vector_gradient;
+    dealii::AlignedVector<T> scalar_value;
+    dealii::AlignedVector<dealii::Tensor<1, dim, T > > scalar_gradient;
+    dealii::AlignedVector<dealii::Tensor<1, dim, T > > vector_value;
+    dealii::AlignedVector<dealii::Tensor<2, dim, T > > vector_gradient;
+
+    std::vector<unsigned int> staged_scalar_values;
+    std::vector<unsigned int> staged_scalar_gradients;
+    std::vector<unsigned int> staged_vector_values;
+    std::vector<unsigned int> staged_vector_gradients;
 };
 
+// Inline definitions of the access methods for the residual methods
+template <int dim, int degree, typename T>
+inline T variableContainer<dim,degree,T>::get_scalar_value(unsigned int global_variable_index) const
+{
+    Assert(varInfoList[global_variable_index].need_value, dealii::ExcMessage("PRISMS-PF Error: Attempted access of a variable value that was not marked as needed in 'parameters.in'. Double-check the indices in user functions where a variable value is requested."));
+    if (collocation){
+        return scalar_var_ptr[global_variable_index]->get_dof_value(q_point);
+    }
+    return scalar_var_ptr[global_variable_index]->get_value(q_point);
+}
+
+template <int dim, int degree, typename T>
+inline dealii::Tensor<1, dim, T > variableContainer<dim,degree,T>::get_scalar_gradient(unsigned int global_variable_index) const
+{
+    Assert(varInfoList[global_variable_index].need_gradient, dealii::ExcMessage("PRISMS-PF Error: Attempted access of a variable gradient that was not marked as needed in 'parameters.in'. Double-check the indices in user functions where a variable gradient is requested."));
+    return scalar_var_ptr[global_variable_index]->get_gradient(q_point);
+}
+
+template <int dim, int degree, typename T>
+inline dealii::Tensor<2, dim, T > variableContainer<dim,degree,T>::get_scalar_hessian(unsigned int global_variable_index) const
+{
+    Assert(varInfoList[global_variable_index].need_hessian, dealii::ExcMessage("PRISMS-PF Error: Attempted access of a variable hessian that was not marked as needed in 'parameters.in'. Double-check the indices in user functions where a variable hessian is requested."));
+    return scalar_var_ptr[global_variable_index]->get_hessian(q_point);
+}
+
+template <int dim, int degree, typename T>
+inline dealii::Tensor<1, dim, T > variableContainer<dim,degree,T>::get_vector_value(unsigned int global_variable_index) const
+{
+    Assert(varInfoList[global_variable_index].need_value, dealii::ExcMessage("PRISMS-PF Error: Attempted access of a variable value that was not marked as needed in 'parameters.in'. Double-check the indices in user functions where a variable value is requested."));
+    if (collocation){
+        return vector_var_ptr[global_variable_index]->get_dof_value(q_point);
+    }
+    return vector_var_ptr[global_variable_index]->get_value(q_point);
+}
+
+template <int dim, int degree, typename T>
+inline dealii::Tensor<2, dim, T > variableContainer<dim,degree,T>::get_vector_gradient(unsigned int global_variable_index) const
+{
+    Assert(varInfoList[global_variable_index].need_gradient, dealii::ExcMessage("PRISMS-PF Error: Attempted access of a variable gradient that was not marked as needed in 'parameters.in'. Double-check the indices in user functions where a variable gradient is requested."));
+    return vector_var_ptr[global_variable_index]->get_gradient(q_point);
+}
+
+template <int dim, int degree, typename T>
+inline dealii::Tensor<3, dim, T > variableContainer<dim,degree,T>::get_vector_hessian(unsigned int global_variable_index) const
+{
+    Assert(varInfoList[global_variable_index].need_hessian, dealii::ExcMessage("PRISMS-PF Error: Attempted access of a variable hessian that was not marked as needed in 'parameters.in'. Double-check the indices in user functions where a variable hessian is requested."));
+    return vector_var_ptr[global_variable_index]->get_hessian(q_point);
+}
+
+template <int dim, int degree, typename T>
+inline void variableContainer<dim,degree,T>::set_scalar_value_residual_term(unsigned int global_variable_index, T val){
+    scalar_var_ptr[global_variable_index]->submit_value(val,q_point);
+}
+
+template <int dim, int degree, typename T>
+inline void variableContainer<dim,degree,T>::set_scalar_gradient_residual_term(unsigned int global_variable_index, dealii::Tensor<1, dim, T > grad){
+    scalar_var_ptr[global_variable_index]->submit_gradient(grad,q_point);
+}
+
+template <int dim, int degree, typename T>
+inline void variableContainer<dim,degree,T>::set_vector_value_residual_term(unsigned int global_variable_index, dealii::Tensor<1, dim, T > val){
+    vector_var_ptr[global_variable_index]->submit_value(val,q_point);
+}
+
+template <int dim, int degree, typename T>
+inline void variableContainer<dim,degree,T>::set_vector_gradient_residual_term(unsigned int global_variable_index, dealii::Tensor<2, dim, T > grad){
+    vector_var_ptr[global_variable_index]->submit_gradient(grad,q_point);
+}
+
+template <int dim, int degree, typename T>
+inline void variableContainer<dim,degree,T>::stage_scalar_value_residual_term(unsigned int global_variable_index, const T & val){
+    Assert(scalar_value_index[global_variable_index] >= 0, dealii::ExcMessage("PRISMS-PF Error: Attempted to stage a value residual term for a variable without a value residual. Double-check the indices in user functions where a residual term is staged."));
+    scalar_value[scalar_value_index[global_variable_index]] = val;
+    Assert(staged_scalar_values.size() < scalar_value.size(), dealii::ExcMessage("PRISMS-PF Error: A residual term was staged more than once before the call to apply_staged_residuals()."));
+    staged_scalar_values.push_back(global_variable_index);
+}
+
+template <int dim, int degree, typename T>
+inline void variableContainer<dim,degree,T>::stage_scalar_gradient_residual_term(unsigned int global_variable_index, const dealii::Tensor<1, dim, T > & grad){
+    Assert(scalar_gradient_index[global_variable_index] >= 0, dealii::ExcMessage("PRISMS-PF Error: Attempted to stage a gradient residual term for a variable without a gradient residual. Double-check the indices in user functions where a residual term is staged."));
+    scalar_gradient[scalar_gradient_index[global_variable_index]] = grad;
+    Assert(staged_scalar_gradients.size() < scalar_gradient.size(), dealii::ExcMessage("PRISMS-PF Error: A residual term was staged more than once before the call to apply_staged_residuals()."));
+    staged_scalar_gradients.push_back(global_variable_index);
+}
+
+template <int dim, int degree, typename T>
+inline void variableContainer<dim,degree,T>::stage_vector_value_residual_term(unsigned int global_variable_index, const dealii::Tensor<1, dim, T > & val){
+    Assert(vector_value_index[global_variable_index] >= 0, dealii::ExcMessage("PRISMS-PF Error: Attempted to stage a value residual term for a variable without a value residual. Double-check the indices in user functions where a residual term is staged."));
+    vector_value[vector_value_index[global_variable_index]] = val;
+    Assert(staged_vector_values.size() < vector_value.size(), dealii::ExcMessage("PRISMS-PF Error: A residual term was staged more than once before the call to apply_staged_residuals()."));
+    staged_vector_values.push_back(global_variable_index);
+}
+
+template <int dim, int degree, typename T>
+inline void variableContainer<dim,degree,T>::stage_vector_gradient_residual_term(unsigned int global_variable_index, const dealii::Tensor<2, dim, T > & grad){
+    Assert(vector_gradient_index[global_variable_index] >= 0, dealii::ExcMessage("PRISMS-PF Error: Attempted to stage a gradient residual term for a variable without a gradient residual. Double-check the indices in user functions where a residual term is staged."));
+    vector_gradient[vector_gradient_index[global_variable_index]] = grad;
+    Assert(staged_vector_gradients.size() < vector_gradient.size(), dealii::ExcMessage("PRISMS-PF Error: A residual term was staged more than once before the call to apply_staged_residuals()."));
+    staged_vector_gradients.push_back(global_variable_index);
+}
+
+template <int dim, int degree, typename T>
+inline void variableContainer<dim,degree,T>::apply_staged_residuals(){
+    for (unsigned int i=0; i<staged_scalar_values.size(); i++){
+        const unsigned int var = staged_scalar_values[i];
+        scalar_var_ptr[var]->submit_value(scalar_value[scalar_value_index[var]],q_point);
+    }
+    for (unsigned int i=0; i<staged_scalar_gradients.size(); i++){
+        const unsigned int var = staged_scalar_gradients[i];
+        scalar_var_ptr[var]->submit_gradient(scalar_gradient[scalar_gradient_index[var]],q_point);
+    }
+    for (unsigned int i=0; i<staged_vector_values.size(); i++){
+        const unsigned int var = staged_vector_values[i];
+        vector_var_ptr[var]->submit_value(vector_value[vector_value_index[var]],q_point);
+    }
+    for (unsigned int i=0; i<staged_vector_gradients.size(); i++){
+        const unsigned int var = staged_vector_gradients[i];
+        vector_var_ptr[var]->submit_gradient(vector_gradient[vector_gradient_index[var]],q_point);
+    }
+
+    // clear() keeps the capacity, so the next quadrature point doesn't allocate
+    staged_scalar_values.clear();
+    staged_scalar_gradients.clear();
+    staged_vector_values.clear();
+    staged_vector_gradients.clear();
+}
+
 #endif
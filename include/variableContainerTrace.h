@@ -0,0 +1,83 @@
+// This class has the same access methods as variableContainer, but instead of evaluating the fields it records which
+// values/derivatives and residual terms the residual methods use. It is only used by traceVariableNeeds.
+#ifndef VARIABLECONTAINERTRACE_H
+#define VARIABLECONTAINERTRACE_H
+
+#include "userInputParameters.h"
+
+template <int dim, int degree>
+class variableContainerTrace
+{
+public:
+    // The number type of the values returned by the access methods (the same as the double precision variableContainer)
+    typedef double number;
+    typedef dealii::VectorizedArray<double> T;
+
+    // Constructor, the record starts out empty for each variable in the list
+    explicit variableContainerTrace(const std::vector<variable_info> & varInfoList);
+
+    // Methods to get the value/grad/hess in the residual method, they return zero and record the call
+    T get_scalar_value(unsigned int global_variable_index) const {traced_value[global_variable_index] = true; return zero_value;};
+    dealii::Tensor<1, dim, T > get_scalar_gradient(unsigned int global_variable_index) const {traced_gradient[global_variable_index] = true; return zero_tensor_1;};
+    dealii::Tensor<2, dim, T > get_scalar_hessian(unsigned int global_variable_index) const {traced_hessian[global_variable_index] = true; return zero_tensor_2;};
+    dealii::Tensor<1, dim, T > get_vector_value(unsigned int global_variable_index) const {traced_value[global_variable_index] = true; return zero_tensor_1;};
+    dealii::Tensor<2, dim, T > get_vector_gradient(unsigned int global_variable_index) const {traced_gradient[global_variable_index] = true; return zero_tensor_2;};
+    dealii::Tensor<3, dim, T > get_vector_hessian(unsigned int global_variable_index) const {traced_hessian[global_variable_index] = true; return zero_tensor_3;};
+
+    // Methods to set the value residual and the gradient residual, they only record the call
+    void set_scalar_value_residual_term(unsigned int global_variable_index, T){traced_value_residual[global_variable_index] = true;};
+    void set_scalar_gradient_residual_term(unsigned int global_variable_index, dealii::Tensor<1, dim, T >){traced_gradient_residual[global_variable_index] = true;};
+    void set_vector_value_residual_term(unsigned int global_variable_index, dealii::Tensor<1, dim, T >){traced_value_residual[global_variable_index] = true;};
+    void set_vector_gradient_residual_term(unsigned int global_variable_index, dealii::Tensor<2, dim, T >){traced_gradient_residual[global_variable_index] = true;};
+
+    // Methods to stage the value residual and the gradient residual, which are traced the same way as the set methods
+    void stage_scalar_value_residual_term(unsigned int global_variable_index, const T &){traced_value_residual[global_variable_index] = true;};
+    void stage_scalar_gradient_residual_term(unsigned int global_variable_index, const dealii::Tensor<1, dim, T > &){traced_gradient_residual[global_variable_index] = true;};
+    void stage_vector_value_residual_term(unsigned int global_variable_index, const dealii::Tensor<1, dim, T > &){traced_value_residual[global_variable_index] = true;};
+    void stage_vector_gradient_residual_term(unsigned int global_variable_index, const dealii::Tensor<2, dim, T > &){traced_gradient_residual[global_variable_index] = true;};
+    void apply_staged_residuals(){};
+
+    // The quadrature point index (always zero, there is only one traced point)
+    unsigned int q_point;
+
+    // Record of the calls to the access methods, indexed by the global variable index
+    mutable std::vector<bool> traced_value;
+    mutable std::vector<bool> traced_gradient;
+    mutable std::vector<bool> traced_hessian;
+    std::vector<bool> traced_value_residual;
+    std::vector<bool> traced_gradient_residual;
+
+private:
+    // The zero values returned by the access methods (the residuals computed from them are discarded)
+    T zero_value;
+    dealii::Tensor<1, dim, T > zero_tensor_1;
+    dealii::Tensor<2, dim, T > zero_tensor_2;
+    dealii::Tensor<3, dim, T > zero_tensor_3;
+};
+
+template <int dim, int degree>
+variableContainerTrace<dim,degree>::variableContainerTrace(const std::vector<variable_info> & varInfoList)
+{
+    const unsigned int num_var = varInfoList.size();
+
+    traced_value.assign(num_var,false);
+    traced_gradient.assign(num_var,false);
+    traced_hessian.assign(num_var,false);
+    traced_value_residual.assign(num_var,false);
+    traced_gradient_residual.assign(num_var,false);
+
+    zero_value = 0.0;
+    for (unsigned int i=0; i<dim; i++){
+        zero_tensor_1[i] = 0.0;
+        for (unsigned int j=0; j<dim; j++){
+            zero_tensor_2[i][j] = 0.0;
+            for (unsigned int k=0; k<dim; k++){
+                zero_tensor_3[i][j][k] = 0.0;
+            }
+        }
+    }
+
+    q_point = 0;
+}
+
+#endif
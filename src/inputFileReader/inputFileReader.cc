@@ -254,11 +254,51 @@ void inputFileReader::declare_parameters(dealii::ParameterHandler & parameter_ha
     parameter_handler.declare_entry("Number of time steps","-1",dealii::Patterns::Integer(),"The time step size for the simulation.");
     parameter_handler.declare_entry("Time step","-0.1",dealii::Patterns::Double(),"The time step size for the simulation.");
     parameter_handler.declare_entry("Simulation end time","-0.1",dealii::Patterns::Double(),"The value of simulated time where the simulation ends.");
+    parameter_handler.declare_entry("Time integration scheme","forward_euler",dealii::Patterns::Anything(),"The time integration scheme for the PARABOLIC fields (forward_euler, one of the adaptive embedded Runge-Kutta pairs BS32 and DP54, the Adams-Bashforth methods AB2 and AB3, the implicit backward differentiation formulas BDF1 and BDF2, or the exponential time differencing schemes ETD1 and ETD2RK).");
+    parameter_handler.declare_entry("Time integration error tolerance","1.0e-4",dealii::Patterns::Double(),"The tolerance on the estimated local error for the adaptive time integration schemes (used as both the absolute and the relative tolerance).");
+    parameter_handler.declare_entry("Maximum time step","-1.0",dealii::Patterns::Double(),"The largest time step allowed for the adaptive time integration schemes and the automatic time step (no limit if negative).");
+    parameter_handler.declare_entry("Automatic time step","false",dealii::Patterns::Bool(),"Whether to set the forward Euler time step from an estimate of the largest stable time step, recomputed after each remeshing (with an adaptive scheme, the estimate is only used for the initial time step).");
+    parameter_handler.declare_entry("Automatic time step safety factor","0.8",dealii::Patterns::Double(),"The automatic time step as a fraction of the estimated largest stable time step.");
+    parameter_handler.declare_entry("Krylov subspace dimension","40",dealii::Patterns::Integer(),"The largest number of Krylov vectors used to apply the phi-functions of the linear terms in the exponential time differencing schemes.");
+    parameter_handler.declare_entry("Krylov tolerance","1.0e-8",dealii::Patterns::Double(),"The tolerance on the estimated relative error of the Krylov approximations in the exponential time differencing schemes.");
+    parameter_handler.declare_entry("Local time stepping levels","1",dealii::Patterns::Integer(),"The number of time step sizes for local time stepping on adaptive meshes, where the DOFs of the finest cells take the time step and the DOFs of each coarser level take twice the time step of the next finer one (one for the same time step everywhere).");
+    parameter_handler.declare_entry("Parareal time slices","1",dealii::Patterns::Integer(),"The number of time slices for parallel-in-time integration with Parareal, each solved by an equal share of the MPI processes (one for the usual sequential time loop).");
+    parameter_handler.declare_entry("Parareal coarse time step factor","10",dealii::Patterns::Integer(),"The time step of the coarse Parareal propagator as a multiple of the time step.");
+    parameter_handler.declare_entry("Parareal coarse time integration scheme","BDF1",dealii::Patterns::Anything(),"The time integration scheme of the coarse Parareal propagator (forward_euler or BDF1).");
+    parameter_handler.declare_entry("Parareal tolerance","1.0e-6",dealii::Patterns::Double(),"The tolerance on the change of the solution at the ends of the time slices between Parareal iterations, relative to its norm.");
+    parameter_handler.declare_entry("Maximum Parareal iterations","10",dealii::Patterns::Integer(),"The maximum number of Parareal iterations (the solution is exact after as many iterations as there are time slices).");
+    parameter_handler.declare_entry("Blow-up recovery snapshots","0",dealii::Patterns::Integer(),"The number of snapshots of the solution kept in memory to recover from a blow-up (NaN) of the solution by restoring the last one and retrying with a smaller time step (zero to stop the simulation at a blow-up instead).");
+    parameter_handler.declare_entry("Blow-up recovery snapshot interval","100",dealii::Patterns::Integer(),"The number of time steps between the snapshots of the solution for blow-up recovery.");
+    parameter_handler.declare_entry("Blow-up recovery time step reduction factor","2",dealii::Patterns::Integer(),"The factor the time step is divided by after each blow-up (each time step is then taken as this many substeps).");
+    parameter_handler.declare_entry("Maximum blow-up recovery time step reductions","5",dealii::Patterns::Integer(),"The maximum number of times the time step is reduced. Further blow-ups restore the next older snapshot.");
+    parameter_handler.declare_entry("Blow-up recovery steps before increase","100",dealii::Patterns::Integer(),"The number of time steps without a blow-up before a reduced time step is increased again by the reduction factor.");
+    parameter_handler.declare_entry("Steady state tolerance","0.0",dealii::Patterns::Double(),"The tolerance on the rate of change of each field, averaged over the steady state check interval, below which the solution is at a steady state (zero to always run to the final time).");
+    parameter_handler.declare_entry("Steady state check interval","100",dealii::Patterns::Integer(),"The number of time steps the rate of change of each field is averaged over for the steady state criterion.");
+    parameter_handler.declare_entry("Steady state norm","l2",dealii::Patterns::Anything(),"The norm of the change of each field for the steady state criterion (l2 or linfty).");
+    parameter_handler.declare_entry("Steady state action","stop",dealii::Patterns::Anything(),"What to do when a steady state is reached: stop the simulation after writing the solution, or increase the time step by the steady state time step factor (stop or increase_time_step).");
+    parameter_handler.declare_entry("Steady state time step factor","10.0",dealii::Patterns::Double(),"The factor the time step is increased by each time the steady state criterion is met, with the increase_time_step action.");
+    parameter_handler.declare_entry("Local reaction tolerance","1.0e-6",dealii::Patterns::Double(),"The tolerance on the estimated local error of the adaptive Runge-Kutta integration of the local reaction terms at each DOF (used as both the absolute and the relative tolerance).");
+    parameter_handler.declare_entry("Newton tolerance","1.0e-6",dealii::Patterns::Double(),"The tolerance for the Newton iterations of the implicit time integration schemes, relative to the norm of the nonlinear residual at the start of the time step.");
+    parameter_handler.declare_entry("Maximum Newton iterations","20",dealii::Patterns::Integer(),"The maximum number of Newton iterations in each time step of the implicit time integration schemes.");
+
+    parameter_handler.declare_entry("Fields stored in single precision","",dealii::Patterns::List(dealii::Patterns::Anything()),"The list of PARABOLIC fields whose solution is read and written in single precision during time stepping, to reduce the memory traffic (the residuals are still computed in double precision, and the double precision solution vectors are kept, so the memory footprint isn't reduced).");
+    parameter_handler.declare_entry("Residual precision","double",dealii::Patterns::Anything(),"The floating point precision used to evaluate the RHS residuals (either double or single, single requires a single precision residualRHS in the application and only PARABOLIC equations).");
+    parameter_handler.declare_entry("Infer variable needs from residuals","false",dealii::Patterns::Bool(),"Whether to replace the value/gradient/hessian needs set in equations.h with the ones found by tracing residualRHS and residualLHS at the start of the simulation.");
 
     parameter_handler.declare_entry("Linear solver","SolverCG",dealii::Patterns::Anything(),"The linear solver (currently only SolverCG).");
     parameter_handler.declare_entry("Use absolute convergence tolerance","false",dealii::Patterns::Bool(),"Whether to use an absolute tolerance for the linear solver (versus a relative tolerance).");
     parameter_handler.declare_entry("Solver tolerance value","1.0e-3",dealii::Patterns::Double(),"The tolerance for the linear solver (either absolute or relative).");
     parameter_handler.declare_entry("Maximum allowed solver iterations","10000",dealii::Patterns::Integer(),"The maximum allowed number of iterations the linear solver is given to converge before being forced to exit.");
+    parameter_handler.declare_entry("Linear solver preconditioner","none",dealii::Patterns::Anything(),"The preconditioner for the linear solver of the ELLIPTIC fields (none, Jacobi for the inverse of the matrix-free diagonal of the operator, Chebyshev for a Chebyshev polynomial of the Jacobi preconditioned operator, or GMG for a matrix-free geometric multigrid V-cycle with Chebyshev smoothers; Chebyshev and GMG require deal.II 9.0 or later).");
+    parameter_handler.declare_entry("Chebyshev preconditioner degree","4",dealii::Patterns::Integer(),"The degree of the Chebyshev preconditioner (the number of operator applications each time it is applied).");
+    parameter_handler.declare_entry("Chebyshev preconditioner smoothing range","20.0",dealii::Patterns::Double(),"The ratio of the largest eigenvalue of the Jacobi preconditioned operator to the smallest eigenvalue targeted by the Chebyshev preconditioner.");
+    parameter_handler.declare_entry("Eigenvalue estimate iterations","10",dealii::Patterns::Integer(),"The number of CG iterations used to estimate the largest eigenvalue of the Jacobi preconditioned operator for the Chebyshev preconditioner and the Chebyshev smoothers of the GMG preconditioner.");
+    parameter_handler.declare_entry("Recompute preconditioner diagonal every solve","false",dealii::Patterns::Bool(),"Whether the diagonal for the Jacobi and Chebyshev preconditioners and the levels of the GMG preconditioner are recomputed before every solve, for an operator whose coefficients change with the other fields or the time. Otherwise they are only recomputed after the mesh changes.");
+    parameter_handler.declare_entry("Elliptic initial guess","zero",dealii::Patterns::Anything(),"The initial guess for the solution increment in the linear solves of the ELLIPTIC fields (zero to start from the previous solution, extrapolation for a polynomial extrapolation of the previous solutions, or projection for the Galerkin projection onto the span of the previous solutions).");
+    parameter_handler.declare_entry("Initial guess history size","3",dealii::Patterns::Integer(),"The number of previous solutions of each ELLIPTIC field kept for the initial guess (2 or 3 for linear or quadratic extrapolation).");
+    parameter_handler.declare_entry("Recycled Krylov vectors","0",dealii::Patterns::Integer(),"The number of approximate eigenvectors of the operator of each ELLIPTIC field that are kept from one solve to the next and deflated from the CG iterations (0 for standard CG).");
+    parameter_handler.declare_entry("Multigrid smoother degree","4",dealii::Patterns::Integer(),"The degree of the Chebyshev smoother on each level of the GMG preconditioner (the number of operator applications per smoothing step).");
+    parameter_handler.declare_entry("Multigrid smoothing range","15.0",dealii::Patterns::Double(),"The ratio of the largest eigenvalue of each level of the GMG preconditioner to the smallest eigenvalue damped by its Chebyshev smoother.");
 
     parameter_handler.declare_entry("Output file name (base)","solution",dealii::Patterns::Anything(),"The name for the output file, before the time step and processor info are added.");
     parameter_handler.declare_entry("Output file type","vtu",dealii::Patterns::Anything(),"The output file type (either vtu or vtk).");
@@ -0,0 +1,257 @@
+// Methods in MatrixFreePDE for time stepping with time steps chosen during the simulation (adaptive time stepping with
+// an embedded explicit Runge-Kutta pair, or the automatic forward Euler time step)
+
+#include "../../include/matrixFreePDE.h"
+
+// Take one step of size dt from the current solution and time. On return, solutionSet holds the new solution and
+// currentTime is advanced by dt. The returned error norm is the root mean square over the free DOFs of the estimated
+// local error, each scaled by tol*(1+|u|). The DOFs constrained to other DOFs or set by Dirichlet BCs have no error of
+// their own, so they are left out of both the sum and the count (see localFreeDofs). The fields whose values aren't used in residualRHS are set to invM*R by
+// computeRates at each stage (the last stage is at the new solution), so they aren't part of the stage combinations
+// or of the error norm. If the step is rejected, the caller restores the solution from rkSolutionOld,
+// and if it is accepted, the caller moves the rate from the last stage into rkStageRates[0] for the next step.
+template <int dim, int degree>
+double MatrixFreePDE<dim,degree>::embeddedRungeKuttaStep(const double dt){
+
+	const unsigned int num_stages = rkTableau.num_stages;
+	const double old_time = currentTime;
+
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		*rkSolutionOld[fieldIndex] = *solutionSet[fieldIndex];
+	}
+
+	for (unsigned int stage=0; stage<num_stages; stage++){
+
+		// The rate at the current solution is usually left over from the last stage of the previous step
+		if (stage == 0 && rkFirstStageRateValid){
+			continue;
+		}
+
+		// Set the stage solution, u_old + dt*sum_j a_ij*k_j, in a single pass over the local DOFs
+		if (stage > 0){
+			for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+				if (!userInputs.varInfoListRHS[fieldIndex].need_value){
+					continue;
+				}
+				const vectorType & solution_old = *rkSolutionOld[fieldIndex];
+				vectorType & stage_solution = *solutionSet[fieldIndex];
+
+				const unsigned int local_size = solution_old.local_size();
+				for (unsigned int i=0; i<local_size; ++i){
+					double value = solution_old.local_element(i);
+					for (unsigned int j=0; j<stage; j++){
+						if (rkTableau.a[stage][j] != 0.0){
+							value += dt*rkTableau.a[stage][j]*rkStageRates[j][fieldIndex]->local_element(i);
+						}
+					}
+					stage_solution.local_element(i) = value;
+				}
+				stage_solution.update_ghost_values();
+			}
+		}
+
+		currentTime = old_time + rkTableau.c[stage]*dt;
+		computeRates(rkStageRates[stage]);
+	}
+	// Either the step is accepted and the last stage rate is moved to the first stage, or the step is rejected and the
+	// first stage rate is still the rate at the restored solution
+	rkFirstStageRateValid = true;
+
+	// The last stage solution is the new solution, so only the error has to be computed
+	double local_error_sqr = 0.0;
+	double local_num_dofs = 0.0;
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		if (!userInputs.varInfoListRHS[fieldIndex].need_value){
+			continue;
+		}
+		const vectorType & solution_old = *rkSolutionOld[fieldIndex];
+		const vectorType & solution_new = *solutionSet[fieldIndex];
+
+		const std::vector<bool> & free_dofs = localFreeDofs[fieldIndex];
+		const unsigned int local_size = solution_old.local_size();
+		for (unsigned int i=0; i<local_size; ++i){
+			if (!free_dofs[i]){
+				continue;
+			}
+			double error = 0.0;
+			for (unsigned int j=0; j<num_stages; j++){
+				error += (rkTableau.b[j]-rkTableau.b_hat[j])*rkStageRates[j][fieldIndex]->local_element(i);
+			}
+			error *= dt;
+			const double scale = userInputs.time_integration_tolerance*(1.0 + std::max(std::abs(solution_old.local_element(i)),std::abs(solution_new.local_element(i))));
+			local_error_sqr += (error/scale)*(error/scale);
+			local_num_dofs += 1.0;
+		}
+	}
+
+	currentTime = old_time + dt;
+
+	const double num_dofs = Utilities::MPI::sum(local_num_dofs, mpi_communicator);
+	if (num_dofs == 0.0){
+		return 0.0;
+	}
+	return std::sqrt(Utilities::MPI::sum(local_error_sqr, mpi_communicator)/num_dofs);
+}
+
+// Time loop with time steps chosen during the simulation, either by the error control of an embedded Runge-Kutta pair
+// or as a fraction of the estimated stable forward Euler time step. Steps are shortened to land exactly on the output
+// and checkpoint times, which are the output and checkpoint increments from the parameters file multiplied by the time
+// step from the parameters file.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::solveAdaptiveTimeSteps(){
+
+	char buffer[200];
+
+	// Factors for the step size controller: the safety factor and the limits on the change of the time step
+	const double safety_factor = 0.9;
+	const double max_increase = 5.0;
+	const double max_decrease = 0.2;
+	const double controller_exponent = -1.0/(rkTableau.embedded_order+1.0);
+
+	const double time_tolerance = 1.0e-10*userInputs.dtValue;
+
+	adaptiveTimeStep = userInputs.dtValue;
+	if (userInputs.automatic_time_step){
+		adaptiveTimeStep = automaticTimeStep();
+	}
+
+	while (currentTime < userInputs.finalTime - time_tolerance){
+
+		// Skip any outputs or checkpoints that were passed without being reached exactly
+		while (currentOutput < userInputs.outputTimeStepList.size() && userInputs.outputTimeStepList[currentOutput]*userInputs.dtValue < currentTime - time_tolerance){
+			currentOutput++;
+		}
+		while (currentCheckpoint < userInputs.checkpointTimeStepList.size() && userInputs.checkpointTimeStepList[currentCheckpoint]*userInputs.dtValue < currentTime - time_tolerance){
+			currentCheckpoint++;
+		}
+
+		//check and perform adaptive mesh refinement
+		adaptiveRefine(currentIncrement);
+
+		// Shorten the step if it would pass the next output time, checkpoint time or the end of the simulation
+		double next_stop_time = userInputs.finalTime;
+		if (currentOutput < userInputs.outputTimeStepList.size()){
+			next_stop_time = std::min(next_stop_time, userInputs.outputTimeStepList[currentOutput]*userInputs.dtValue);
+		}
+		if (currentCheckpoint < userInputs.checkpointTimeStepList.size()){
+			next_stop_time = std::min(next_stop_time, userInputs.checkpointTimeStepList[currentCheckpoint]*userInputs.dtValue);
+		}
+		double dt = adaptiveTimeStep;
+		if (!userInputs.adaptive_time_stepping){
+			dt = automaticTimeStep();
+		}
+		bool step_shortened = false;
+		if (currentTime + dt > next_stop_time - time_tolerance){
+			dt = next_stop_time - currentTime;
+			step_shortened = true;
+		}
+
+		if (!userInputs.adaptive_time_stepping){
+			// Forward Euler step with the automatic time step, through the same explicit update as the fixed time step
+			if (currentIncrement%userInputs.skip_print_steps==0){
+				pcout << "\ntime increment:" << currentIncrement << "  time: " << currentTime+dt << "  time step: " << dt << "\n";
+			}
+			currentTime += dt;
+			explicitStepRatio = dt/userInputs.dtValue;
+			solveIncrement();
+			explicitStepRatio = 1.0;
+		}
+		else {
+			//solve time increment, retrying with a smaller step until the error is within the tolerance
+			computing_timer.enter_section("matrixFreePDE: solveIncrements");
+			Timer time;
+			unsigned int num_rejected_steps = 0;
+			double error_norm = embeddedRungeKuttaStep(dt);
+			while (!(error_norm <= 1.0)){
+				num_rejected_steps++;
+				currentTime -= dt;
+				for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+					*solutionSet[fieldIndex] = *rkSolutionOld[fieldIndex];
+					solutionSet[fieldIndex]->update_ghost_values();
+				}
+
+				if (numbers::is_finite(error_norm)){
+					dt *= std::max(max_decrease, safety_factor*std::pow(error_norm,controller_exponent));
+				}
+				else {
+					dt *= max_decrease;
+				}
+
+				if (dt < time_tolerance){
+					sprintf(buffer, "ERROR: the adaptive time step fell below %12.6e at time %12.6e without meeting the error tolerance. exiting.\n\n", time_tolerance, currentTime);
+					pcout<<buffer;
+					exit(-1);
+				}
+				step_shortened = false;
+				error_norm = embeddedRungeKuttaStep(dt);
+			}
+			computing_timer.exit_section("matrixFreePDE: solveIncrements");
+
+			// The methods are FSAL (first same as last), so the rate at the new solution was computed in the last stage
+			std::swap(rkStageRates[0],rkStageRates[rkTableau.num_stages-1]);
+
+			// Propose the next time step. If this step was only shortened to reach an output time, don't let that shrink the next one.
+			double next_dt = dt*std::min(max_increase, safety_factor*std::pow(std::max(error_norm,1.0e-10),controller_exponent));
+			if (step_shortened){
+				next_dt = std::max(next_dt, adaptiveTimeStep);
+			}
+			if (userInputs.max_dt > 0.0){
+				next_dt = std::min(next_dt, userInputs.max_dt);
+			}
+			adaptiveTimeStep = next_dt;
+
+			if (currentIncrement%userInputs.skip_print_steps==0){
+				pcout << "\ntime increment:" << currentIncrement << "  time: " << currentTime << "  time step: " << dt << "  rejected steps: " << num_rejected_steps << "\n";
+				for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+					sprintf(buffer, "field '%2s' [adaptive explicit solve]: current solution: %12.6e, error estimate: %12.6e\n", \
+					fields[fieldIndex].name.c_str(),				\
+					solutionSet[fieldIndex]->l2_norm(),			\
+					error_norm);
+					pcout<<buffer;
+				}
+				pcout << "wall time: " << time.wall_time() << "s\n";
+			}
+		}
+
+		// Output results to file (at the proper times)
+		if (currentOutput < userInputs.outputTimeStepList.size() && std::abs(userInputs.outputTimeStepList[currentOutput]*userInputs.dtValue - currentTime) < time_tolerance) {
+			syncSinglePrecisionFields();
+			for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+				constraintsDirichletSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
+				constraintsOtherSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
+				solutionSet[fieldIndex]->update_ghost_values();
+			}
+			outputResults();
+			currentOutput++;
+		}
+
+		// Create a checkpoint (at the proper times)
+		if (currentCheckpoint < userInputs.checkpointTimeStepList.size() && std::abs(userInputs.checkpointTimeStepList[currentCheckpoint]*userInputs.dtValue - currentTime) < time_tolerance) {
+			save_checkpoint();
+			currentCheckpoint++;
+		}
+
+		// Stop at a steady state
+		if (userInputs.steady_state_tolerance > 0.0 && checkSteadyState()){
+			break;
+		}
+
+		currentIncrement++;
+	}
+}
+
+// The forward Euler time step used with "Automatic time step": the safety factor times the estimated stability limit,
+// limited by the maximum time step (the time step from the parameters file is used if no limit was found)
+template <int dim, int degree>
+double MatrixFreePDE<dim,degree>::automaticTimeStep() const {
+	double dt = userInputs.time_step_safety_factor*stableTimeStep;
+	if (userInputs.max_dt > 0.0){
+		dt = std::min(dt, userInputs.max_dt);
+	}
+	if (!(dt > 0.0) || !numbers::is_finite(dt)){
+		dt = userInputs.dtValue;
+	}
+	return dt;
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
@@ -0,0 +1,131 @@
+// Methods in MatrixFreePDE for recovering from a blow-up of the solution with in-memory snapshots
+
+#include "../../include/matrixFreePDE.h"
+
+// Solve the current increment as substeps of dtValue divided by the reduction factor for each time the time step is
+// currently reduced. If the solution blows up, the newest snapshot is restored and the time step is reduced again, or
+// if it can't be reduced any more, the snapshot before it is restored. The time step is increased again by the
+// reduction factor after each "Blow-up recovery steps before increase" increments without a blow-up.
+template <int dim, int degree>
+bool MatrixFreePDE<dim,degree>::solveRecoverableIncrement(){
+
+    char buffer[200];
+
+    const double end_time = currentTime;
+    const double start_time = currentTime - userInputs.dtValue;
+
+    // There is always a snapshot to go back to, the ring is emptied when the mesh changes
+    if (numRecoverySnapshots == 0){
+        saveRecoverySnapshot(currentIncrement-1, start_time);
+    }
+
+    unsigned int num_substeps = 1;
+    for (unsigned int i=0; i<recoveryStepReductions; i++){
+        num_substeps *= userInputs.blowup_step_reduction_factor;
+    }
+
+    explicitStepRatio = 1.0/num_substeps;
+    for (unsigned int substep=1; substep<=num_substeps && !solutionBlowUp; substep++){
+        currentTime = start_time + substep*explicitStepRatio*userInputs.dtValue;
+        solveIncrement();
+    }
+    explicitStepRatio = 1.0;
+    currentTime = end_time;
+
+    if (!solutionBlowUp){
+        if (recoveryStepReductions > 0){
+            recoveryStepsSinceChange++;
+            if (recoveryStepsSinceChange >= userInputs.blowup_steps_before_increase){
+                recoveryStepReductions--;
+                recoveryStepsSinceChange = 0;
+                // The multistep schemes start over with the new time step
+                numStoredRates = 0;
+                bdfSolutionOldValid = false;
+                pcout << "\nIncreasing the time step to " << userInputs.blowup_step_reduction_factor*userInputs.dtValue/num_substeps << " after " << userInputs.blowup_steps_before_increase << " increments without a blow-up\n";
+            }
+        }
+        return true;
+    }
+    solutionBlowUp = false;
+
+    const bool drop_newest = (recoveryStepReductions == userInputs.max_blowup_step_reductions);
+    if (!drop_newest){
+        recoveryStepReductions++;
+        num_substeps *= userInputs.blowup_step_reduction_factor;
+    }
+    recoveryStepsSinceChange = 0;
+
+    const unsigned int failed_increment = currentIncrement;
+    if (!restoreRecoverySnapshot(drop_newest)){
+        sprintf(buffer, "ERROR: the solution blew up at increment %u with the smallest time step and there are no older snapshots. exiting.\n\n", failed_increment);
+        pcout<<buffer;
+        exit(-1);
+    }
+
+    sprintf(buffer, "\nWarning: the solution blew up at increment %u, restarting from the snapshot at increment %u with a time step of %12.6e\n", failed_increment, currentIncrement, userInputs.dtValue/num_substeps);
+    pcout<<buffer;
+    return false;
+}
+
+// Save a copy of the solution in the next slot of the ring
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::saveRecoverySnapshot(const unsigned int completed_increment, const double completed_time){
+
+    const unsigned int num_slots = recoverySnapshots.size();
+    if (numRecoverySnapshots > 0){
+        newestRecoverySnapshot = (newestRecoverySnapshot+1)%num_slots;
+    }
+    numRecoverySnapshots = std::min(numRecoverySnapshots+1, num_slots);
+
+    syncSinglePrecisionFields();
+    for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+        *recoverySnapshots[newestRecoverySnapshot][fieldIndex] = *solutionSet[fieldIndex];
+    }
+    recoverySnapshotIncrement[newestRecoverySnapshot] = completed_increment;
+    recoverySnapshotTime[newestRecoverySnapshot] = completed_time;
+}
+
+// Copy the newest snapshot back to the solution and set the increment, time, output and checkpoint counters back to
+// it. The rates from the previous time steps of the multistep schemes are discarded.
+template <int dim, int degree>
+bool MatrixFreePDE<dim,degree>::restoreRecoverySnapshot(const bool drop_newest){
+
+    const unsigned int num_slots = recoverySnapshots.size();
+    if (drop_newest && numRecoverySnapshots > 0){
+        newestRecoverySnapshot = (newestRecoverySnapshot+num_slots-1)%num_slots;
+        numRecoverySnapshots--;
+    }
+    if (numRecoverySnapshots == 0){
+        return false;
+    }
+
+    for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+        *solutionSet[fieldIndex] = *recoverySnapshots[newestRecoverySnapshot][fieldIndex];
+        solutionSet[fieldIndex]->update_ghost_values();
+    }
+    residualIsZeroed.assign(fields.size(),false);
+    if (solutionSetFloat.size() > 0){
+        initSinglePrecisionFields();
+    }
+
+    currentIncrement = recoverySnapshotIncrement[newestRecoverySnapshot];
+    currentTime = recoverySnapshotTime[newestRecoverySnapshot];
+
+    // The outputs and checkpoints after the snapshot are written again
+    currentOutput = 0;
+    while (currentOutput < userInputs.outputTimeStepList.size() && userInputs.outputTimeStepList[currentOutput] <= currentIncrement){
+        currentOutput++;
+    }
+    currentCheckpoint = 0;
+    while (currentCheckpoint < userInputs.checkpointTimeStepList.size() && userInputs.checkpointTimeStepList[currentCheckpoint] <= currentIncrement){
+        currentCheckpoint++;
+    }
+
+    numStoredRates = 0;
+    bdfSolutionOldValid = false;
+    steadyStateWindowValid = false;
+    resetEllipticSolveHistory();
+    return true;
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
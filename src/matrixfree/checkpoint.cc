@@ -8,7 +8,10 @@
 template <int dim, int degree>
 void MatrixFreePDE<dim,degree>::save_checkpoint(){
     computing_timer.enter_section("matrixFreePDE: save_checkpoint");
-    unsigned int my_id = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+
+    // The checkpoint is written from the double precision solution vectors
+    syncSinglePrecisionFields();
+    unsigned int my_id = Utilities::MPI::this_mpi_process (mpi_communicator);
 
     if (my_id == 0)
     {
@@ -29,9 +29,9 @@ void  MatrixFreePDE<dim,degree>::computeIntegral(double& integratedField, int in
 		}
 	}
 
-	value=Utilities::MPI::sum(value, MPI_COMM_WORLD);
+	value=Utilities::MPI::sum(value, mpi_communicator);
 
-	//   if (Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0){
+	//   if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0){
 	//   std::cout<<"Integrated field: "<<value<<std::endl;
 	//   }
 
@@ -52,7 +52,7 @@ void MatrixFreePDE<dim,degree>::computeIntegralMF(double& integratedField, int i
   //call to integrate and assemble
   matrixFreeObject.cell_loop (&MatrixFreePDE<dim,degree>::getIntegralMF, this, residualSet, variableSet);
 
-  integratedField=Utilities::MPI::sum(integrated_var, MPI_COMM_WORLD);
+  integratedField=Utilities::MPI::sum(integrated_var, mpi_communicator);
 
   //end log
   computing_timer.exit_section("matrixFreePDE: computeIntegralMF");
@@ -64,7 +64,15 @@ void MatrixFreePDE<dim,degree>::getIntegralMF(const MatrixFree<dim,double> &data
                                         const std::vector<vectorType*> &src,
                                         const std::pair<unsigned int,unsigned int> &cell_range) {
 
-	dealii::FEEvaluation<dim,degree,degree+1,1,double> var(data,0);
+	// Get the FEEvaluation object for this thread, building it if this is the first cell range the thread has worked on
+	std::shared_ptr<dealii::FEEvaluation<dim,degree,degree+1,1,double> > & var_ptr = threadLocalIntegralEvaluators.get();
+	if (!var_ptr){
+		var_ptr.reset(new dealii::FEEvaluation<dim,degree,degree+1,1,double>(data,0));
+	}
+	dealii::FEEvaluation<dim,degree,degree+1,1,double> & var = *var_ptr;
+
+	unsigned int num_q_points = var.n_q_points;
+	dealii::AlignedVector<dealii::VectorizedArray<double> > JxW(num_q_points);
 
     //loop over cells
     for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell){
@@ -72,9 +80,6 @@ void MatrixFreePDE<dim,degree>::getIntegralMF(const MatrixFree<dim,double> &data
 		var.read_dof_values_plain(*src[0]);
 		var.evaluate(true, false, false);
 
-        unsigned int num_q_points = var.n_q_points;
-
-		dealii::AlignedVector<dealii::VectorizedArray<double> > JxW(num_q_points);
 		var.fill_JxW_values(JxW);
 
         //loop over quadrature points
@@ -1,4 +1,4 @@
-//vmult() and getLHS() method for MatrixFreePDE class
+//vmult(), getLHS() and getLHSDiagonal() methods for MatrixFreePDE class
 
 #include "../../include/matrixFreePDE.h"
 
@@ -34,31 +34,26 @@ void  MatrixFreePDE<dim,degree>::getLHS(const MatrixFree<dim,double> &data,
 				 const vectorType &src,
 				 const std::pair<unsigned int,unsigned int> &cell_range) const{
 
-    variableContainer<dim,degree,dealii::VectorizedArray<double> > variable_list(data,userInputs.varInfoListLHS);
-
-	//loop over cells
-	for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell){
-
-		// Initialize, read DOFs, and set evaulation flags for each variable
-        variable_list.reinit_and_eval_LHS(src,solutionSet,cell,currentFieldIndex);
-
-		unsigned int num_q_points = variable_list.get_num_q_points();
-
-		//loop over quadrature points
-		for (unsigned int q=0; q<num_q_points; ++q){
-            variable_list.q_point = q;
-
-            dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc = variable_list.get_q_point_location();
-
-			// Calculate the residuals
-            residualLHS(variable_list,q_point_loc);
-
-		}
+    // Default cell loop, where residualLHS is called through the virtual function table
+    cellLoopLHS(data,dst,src,cell_range,
+        [this](variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+               const dealii::Point<dim, dealii::VectorizedArray<double> > & q_point_loc){
+            this->residualLHS(variable_list,q_point_loc);
+        });
+}
 
-        // Integrate the residuals and distribute from local to global
-        variable_list.integrate_and_distribute_LHS(dst,currentFieldIndex);
+template <int dim, int degree>
+void  MatrixFreePDE<dim,degree>::getLHSDiagonal(const MatrixFree<dim,double> &data,
+				 vectorType &dst,
+				 const vectorType &src,
+				 const std::pair<unsigned int,unsigned int> &cell_range) const{
 
-	}
+    // Default cell loop, where residualLHS is called through the virtual function table
+    cellLoopLHSDiagonal(data,dst,src,cell_range,
+        [this](variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+               const dealii::Point<dim, dealii::VectorizedArray<double> > & q_point_loc){
+            this->residualLHS(variable_list,q_point_loc);
+        });
 }
 
 #include "../../include/matrixFreePDE_template_instantiations.h"
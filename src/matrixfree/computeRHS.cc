@@ -9,13 +9,29 @@ void MatrixFreePDE<dim,degree>::computeRHS(){
   //log time
   computing_timer.enter_section("matrixFreePDE: computeRHS");
 
-  //clear residual vectors before update
+  //clear residual vectors before update (unless explicitUpdate already left a zeroed vector)
   for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
-    (*residualSet[fieldIndex])=0.0;
+    if (fieldIndex < residualIsZeroed.size() && residualIsZeroed[fieldIndex]){
+      residualIsZeroed[fieldIndex] = false;
+    }
+    else {
+      (*residualSet[fieldIndex])=0.0;
+    }
   }
 
-  //call to integrate and assemble
-  matrixFreeObject.cell_loop (&MatrixFreePDE<dim,degree>::getRHS, this, residualSet, solutionSet);
+  //the fields stored in single precision are read from their single precision copies
+  rhsReadsSinglePrecisionFields = !solutionSetFloat.empty();
+
+  //call to integrate and assemble (in single precision, if selected in the parameters file)
+  if (userInputs.single_precision_residual){
+    void (MatrixFreePDE<dim,degree>::*getRHS_float)(const MatrixFree<dim,float> &, std::vector<vectorType*> &, const std::vector<vectorType*> &, const std::pair<unsigned int,unsigned int> &) const = &MatrixFreePDE<dim,degree>::getRHS;
+    matrixFreeObjectFloat.cell_loop (getRHS_float, this, residualSet, solutionSet);
+  }
+  else {
+    void (MatrixFreePDE<dim,degree>::*getRHS_double)(const MatrixFree<dim,double> &, std::vector<vectorType*> &, const std::vector<vectorType*> &, const std::pair<unsigned int,unsigned int> &) const = &MatrixFreePDE<dim,degree>::getRHS;
+    matrixFreeObject.cell_loop (getRHS_double, this, residualSet, solutionSet);
+  }
+  rhsReadsSinglePrecisionFields = false;
 
   //end log
   computing_timer.exit_section("matrixFreePDE: computeRHS");
@@ -27,28 +43,33 @@ void MatrixFreePDE<dim,degree>::getRHS(const MatrixFree<dim,double> &data,
                                         const std::vector<vectorType*> &src,
                                         const std::pair<unsigned int,unsigned int> &cell_range) const{
 
-    variableContainer<dim,degree,dealii::VectorizedArray<double> > variable_list(data,userInputs.varInfoListRHS);
-
-    //loop over cells
-    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell){
-
-        // Initialize, read DOFs, and set evaulation flags for each variable
-        variable_list.reinit_and_eval(src, cell);
-
-        unsigned int num_q_points = variable_list.get_num_q_points();
-
-        //loop over quadrature points
-        for (unsigned int q=0; q<num_q_points; ++q){
-            variable_list.q_point = q;
+    // Default cell loop, where residualRHS is called through the virtual function table
+    cellLoopRHS(data,dst,src,cell_range,
+        [this](variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+               const dealii::Point<dim, dealii::VectorizedArray<double> > & q_point_loc){
+            this->residualRHS(variable_list,q_point_loc);
+        });
+}
 
-            dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc = variable_list.get_q_point_location();
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::getRHS(const MatrixFree<dim,float> &data,
+                                        std::vector<vectorType*> &dst,
+                                        const std::vector<vectorType*> &src,
+                                        const std::pair<unsigned int,unsigned int> &cell_range) const{
 
-            // Calculate the residuals
-            residualRHS(variable_list,q_point_loc);
-        }
+    // Default single precision cell loop, where residualRHS is called through the virtual function table
+    cellLoopRHS(data,dst,src,cell_range,
+        [this](variableContainer<dim,degree,dealii::VectorizedArray<float> > & variable_list,
+               const dealii::Point<dim, dealii::VectorizedArray<float> > & q_point_loc){
+            this->residualRHS(variable_list,q_point_loc);
+        });
+}
 
-        variable_list.integrate_and_distribute(dst);
-    }
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::residualRHS(variableContainer<dim,degree,dealii::VectorizedArray<float> > & variable_list,
+                                             dealii::Point<dim, dealii::VectorizedArray<float> > q_point_loc) const {
+    std::cerr << "PRISMS-PF Error: 'Residual precision' is set to 'single' in the parameters file, but this application doesn't provide a single precision version of residualRHS." << std::endl;
+    abort();
 }
 
     #include "../../include/matrixFreePDE_template_instantiations.h"
@@ -0,0 +1,72 @@
+// Methods in MatrixFreePDE for the Jacobi and Chebyshev preconditioners of the ELLIPTIC fields
+
+#include "../../include/matrixFreePDE.h"
+
+// The inverse diagonal is computed once for each field and mesh (or before every solve, if the coefficients of
+// residualLHS change with the other fields or the time). The eigenvalue estimates of the Chebyshev preconditioner are
+// reset with it, the CG iterations for the new estimates are run the first time the preconditioner is applied.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::updateDiagonalPreconditioner(){
+
+    const unsigned int fieldIndex = currentFieldIndex;
+    if (lhsDiagonalValid[fieldIndex] && !userInputs.recompute_preconditioner_diagonal){
+        return;
+    }
+
+    computing_timer.enter_section("matrixFreePDE: preconditioner diagonal");
+
+    if (!lhsInverseDiagonal[fieldIndex]){
+        lhsInverseDiagonal[fieldIndex].reset(new DiagonalMatrix<vectorType>());
+    }
+    computeLHSInverseDiagonal(lhsInverseDiagonal[fieldIndex]->get_vector());
+
+    // The Chebyshev preconditioner is given the inverse diagonal as a preconditioner object, as in deal.II 9 (Chebyshev
+    // is rejected when the parameters are read with older versions)
+    #if (DEAL_II_VERSION_MAJOR >= 9)
+    if (userInputs.linear_preconditioner == CHEBYSHEV_PRECONDITIONER){
+        typename chebyshevPreconditionerType::AdditionalData chebyshev_data;
+        chebyshev_data.preconditioner = lhsInverseDiagonal[fieldIndex];
+        chebyshev_data.degree = userInputs.chebyshev_degree;
+        chebyshev_data.smoothing_range = userInputs.chebyshev_smoothing_range;
+        chebyshev_data.eig_cg_n_iterations = userInputs.eigenvalue_estimate_iterations;
+        if (!chebyshevPreconditioners[fieldIndex]){
+            chebyshevPreconditioners[fieldIndex].reset(new chebyshevPreconditionerType());
+        }
+        chebyshevPreconditioners[fieldIndex]->initialize(activeLHSOperator, chebyshev_data);
+    }
+    #endif
+
+    lhsDiagonalValid[fieldIndex] = true;
+
+    computing_timer.exit_section("matrixFreePDE: preconditioner diagonal");
+}
+
+// The Dirichlet DOFs have unit diagonal entries, as their rows in vmult are those of the identity. The rows of the
+// hanging node and periodic DOFs are zero in vmult (the residuals there are zero too), and they get unit entries as well.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::computeLHSInverseDiagonal(vectorType & inverse_diagonal) const {
+
+    matrixFreeObject.initialize_dof_vector(inverse_diagonal, currentFieldIndex);
+    matrixFreeObject.cell_loop(&MatrixFreePDE<dim,degree>::getLHSDiagonal, this, inverse_diagonal, *solutionSet[currentFieldIndex]);
+
+    for (std::map<types::global_dof_index, double>::const_iterator it=valuesDirichletSet[currentFieldIndex]->begin(); it!=valuesDirichletSet[currentFieldIndex]->end(); ++it){
+        if (inverse_diagonal.in_local_range(it->first)){
+            inverse_diagonal(it->first) = 1.0;
+        }
+    }
+    for (unsigned int i=0; i<inverse_diagonal.local_size(); ++i){
+        const double diagonal = inverse_diagonal.local_element(i);
+        inverse_diagonal.local_element(i) = (diagonal > 0.0 ? 1.0/diagonal : 1.0);
+    }
+}
+
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::invalidatePreconditionerDiagonal(){
+    lhsInverseDiagonal.resize(fields.size());
+    #if (DEAL_II_VERSION_MAJOR >= 9)
+    chebyshevPreconditioners.resize(fields.size());
+    #endif
+    lhsDiagonalValid.assign(fields.size(), false);
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
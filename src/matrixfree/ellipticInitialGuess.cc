@@ -0,0 +1,123 @@
+// Methods in MatrixFreePDE for the initial guesses of the solves of the ELLIPTIC fields
+
+#include "../../include/matrixFreePDE.h"
+
+// The residual is for the previous solution u_n, so the initial guess is for the increment to the new solution. With
+// extrapolation it is the polynomial through the last two or three solutions (assuming equal time steps) minus u_n:
+// u_n - u_{n-1} (linear) or 2*u_n - 3*u_{n-1} + u_{n-2} (quadratic). With projection it is the Galerkin projection of the
+// increment onto the span of the stored solutions, W*c with (W^T*A*W)*c = W^T*r, which takes one vmult per stored
+// solution. The small system is solved with its eigendecomposition, dropping the directions in which the stored
+// solutions are (nearly) linearly dependent.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::ellipticInitialGuess(const unsigned int fieldIndex, vectorType & dU){
+
+    dU = 0.0;
+
+    const unsigned int num_stored = numEllipticSolutions[fieldIndex];
+    if (userInputs.elliptic_initial_guess == ZERO_INITIAL_GUESS || num_stored == 0){
+        return;
+    }
+
+    const unsigned int num_slots = ellipticSolutionHistory[fieldIndex].size();
+    std::vector<const vectorType*> W(num_stored);
+    for (unsigned int i=0; i<num_stored; i++){
+        W[i] = ellipticSolutionHistory[fieldIndex][(newestEllipticSolution[fieldIndex]+num_slots-i)%num_slots].get();
+    }
+
+    if (userInputs.elliptic_initial_guess == EXTRAPOLATED_INITIAL_GUESS){
+        if (num_stored < 2){
+            return;
+        }
+        static const double coefficients[2][3] = {{1.0, -1.0, 0.0}, {2.0, -3.0, 1.0}};
+        const unsigned int order = num_stored-1;
+        for (unsigned int i=0; i<=order; i++){
+            dU.add(coefficients[order-1][i], *W[i]);
+        }
+        return;
+    }
+
+    const vectorType & r = *residualSet[fieldIndex];
+    denseMatrix G(num_stored, std::vector<double>(num_stored,0.0));
+    std::vector<double> f(num_stored);
+    vectorType AW;
+    AW.reinit(dU);
+    for (unsigned int j=0; j<num_stored; j++){
+        vmult(AW, *W[j]);
+        for (unsigned int i=0; i<num_stored; i++){
+            G[i][j] = (*W[i])*AW;
+        }
+        f[j] = (*W[j])*r;
+    }
+    for (unsigned int i=0; i<num_stored; i++){
+        for (unsigned int j=0; j<i; j++){
+            G[i][j] = G[j][i] = 0.5*(G[i][j] + G[j][i]);
+        }
+    }
+
+    std::vector<double> eigenvalues;
+    denseMatrix eigenvectors;
+    denseSymmetricEigen(G, eigenvalues, eigenvectors);
+
+    std::vector<double> c(num_stored, 0.0);
+    const double cutoff = 1.0e-12*eigenvalues[num_stored-1];
+    for (unsigned int k=0; k<num_stored; k++){
+        if (!(eigenvalues[k] > cutoff)){
+            continue;
+        }
+        double projection = 0.0;
+        for (unsigned int i=0; i<num_stored; i++){
+            projection += eigenvectors[i][k]*f[i];
+        }
+        for (unsigned int i=0; i<num_stored; i++){
+            c[i] += eigenvectors[i][k]*projection/eigenvalues[k];
+        }
+    }
+    for (unsigned int i=0; i<num_stored; i++){
+        dU.add(c[i], *W[i]);
+    }
+}
+
+// Add the new solution to the ring of previous solutions, overwriting the oldest one once it is full
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::storeEllipticSolution(const unsigned int fieldIndex){
+
+    if (userInputs.elliptic_initial_guess == ZERO_INITIAL_GUESS){
+        return;
+    }
+
+    std::vector<std::shared_ptr<vectorType> > & history = ellipticSolutionHistory[fieldIndex];
+    if (history.size() < userInputs.initial_guess_history_size){
+        history.resize(userInputs.initial_guess_history_size);
+    }
+    const unsigned int num_slots = history.size();
+    if (numEllipticSolutions[fieldIndex] > 0){
+        newestEllipticSolution[fieldIndex] = (newestEllipticSolution[fieldIndex]+1)%num_slots;
+    }
+    numEllipticSolutions[fieldIndex] = std::min(numEllipticSolutions[fieldIndex]+1, num_slots);
+
+    std::shared_ptr<vectorType> & solution = history[newestEllipticSolution[fieldIndex]];
+    if (!solution){
+        solution.reset(new vectorType);
+        matrixFreeObject.initialize_dof_vector(*solution, fieldIndex);
+    }
+    *solution = *solutionSet[fieldIndex];
+    solution->zero_out_ghosts();
+
+    // The increment is zero at the Dirichlet and constrained DOFs, so the initial guess must be as well
+    constraintsOtherSet[fieldIndex]->set_zero(*solution);
+    for (std::map<types::global_dof_index, double>::const_iterator it=valuesDirichletSet[fieldIndex]->begin(); it!=valuesDirichletSet[fieldIndex]->end(); ++it){
+        if (solution->in_local_range(it->first)){
+            (*solution)(it->first) = 0.0;
+        }
+    }
+}
+
+// The vectors are allocated again on the first solve after the mesh changes
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::resetEllipticSolveHistory(){
+    ellipticSolutionHistory.assign(fields.size(), std::vector<std::shared_ptr<vectorType> >());
+    newestEllipticSolution.assign(fields.size(), 0);
+    numEllipticSolutions.assign(fields.size(), 0);
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
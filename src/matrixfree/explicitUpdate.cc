@@ -0,0 +1,217 @@
+//Methods for the explicit update of the parabolic fields in the MatrixFreePDE class
+
+#include "../../include/matrixFreePDE.h"
+
+// Store the local index and value of each locally owned DOF with a Dirichlet BC, so that the explicit update can set
+// them directly instead of going through the constraint matrix every time step
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::setLocalDirichletValues(){
+	localDirichletValues.clear();
+	localDirichletValues.resize(fields.size());
+
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		for (std::map<types::global_dof_index, double>::const_iterator it=valuesDirichletSet[fieldIndex]->begin(); it!=valuesDirichletSet[fieldIndex]->end(); ++it){
+			if (solutionSet[fieldIndex]->in_local_range(it->first)){
+				unsigned int local_index = solutionSet[fieldIndex]->get_partitioner()->global_to_local(it->first);
+				localDirichletValues[fieldIndex].push_back(std::make_pair(local_index,it->second));
+			}
+		}
+	}
+
+	// Mark the locally owned DOFs that are neither constrained to other DOFs nor set by a Dirichlet BC
+	localFreeDofs.clear();
+	localFreeDofs.resize(fields.size());
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		const vectorType & solution = *solutionSet[fieldIndex];
+		const unsigned int local_size = solution.local_size();
+		localFreeDofs[fieldIndex].assign(local_size,true);
+		for (unsigned int i=0; i<local_size; ++i){
+			if (constraintsOtherSet[fieldIndex]->is_constrained(solution.get_partitioner()->local_to_global(i))){
+				localFreeDofs[fieldIndex][i] = false;
+			}
+		}
+		for (unsigned int i=0; i<localDirichletValues[fieldIndex].size(); ++i){
+			localFreeDofs[fieldIndex][localDirichletValues[fieldIndex][i].first] = false;
+		}
+	}
+
+	residualIsZeroed.assign(fields.size(),false);
+}
+
+// Explicit update of a parabolic field in a single pass over the local DOFs: the residual is scaled by the inverse
+// mass matrix in place, the old solution is zeroed, and then the two vectors are swapped, so the residual vector becomes
+// the new solution and the old solution becomes the (already zeroed) residual vector for the next call to computeRHS.
+// Returns the l2 norm of the new solution.
+template <int dim, int degree>
+double MatrixFreePDE<dim,degree>::explicitUpdate(const unsigned int fieldIndex){
+
+	// Fields stored in single precision are updated in their single precision vector instead
+	if (fieldIndex < solutionSetFloat.size() && solutionSetFloat[fieldIndex] != NULL){
+		return explicitUpdateSinglePrecision(fieldIndex);
+	}
+
+	vectorType & new_solution = *residualSet[fieldIndex];
+	vectorType & old_solution = *solutionSet[fieldIndex];
+
+	// Takes advantage of knowledge that the length of solutionSet and residualSet is an integer multiple of the length of invM for vector variables
+	const unsigned int invM_size = invM.local_size();
+	const unsigned int local_size = new_solution.local_size();
+
+	// A field whose value isn't used in residualRHS (like the chemical potential in the Cahn-Hilliard apps) can't be in
+	// its own residual, so it is set to invM*R for any step size
+	double local_norm_sqr = 0.0;
+	if (explicitStepRatio == 1.0 || !userInputs.varInfoListRHS[fieldIndex].need_value){
+		for (unsigned int offset=0; offset<local_size; offset+=invM_size){
+			for (unsigned int k=0; k<invM_size; ++k){
+				const double value = invM.local_element(k)*new_solution.local_element(offset+k);
+				new_solution.local_element(offset+k) = value;
+				old_solution.local_element(offset+k) = 0.0;
+				local_norm_sqr += value*value;
+			}
+		}
+	}
+	else {
+		// The residual is for a step of size dtValue, so a step of a different size is taken along the same direction.
+		// The DOFs constrained to others (where invM is zero) are set to zero as for a step of dtValue, otherwise they
+		// would be multiplied by (1-explicitStepRatio) at every step.
+		for (unsigned int offset=0; offset<local_size; offset+=invM_size){
+			for (unsigned int k=0; k<invM_size; ++k){
+				const double old_value = old_solution.local_element(offset+k);
+				const double step_ratio = (invM.local_element(k) == 0.0) ? 1.0 : explicitStepRatio;
+				const double value = old_value + step_ratio*(invM.local_element(k)*new_solution.local_element(offset+k) - old_value);
+				new_solution.local_element(offset+k) = value;
+				old_solution.local_element(offset+k) = 0.0;
+				local_norm_sqr += value*value;
+			}
+		}
+	}
+
+	// Set the Dirichlet values (hanging node constraints don't need to be distributed every time step, only at output)
+	for (unsigned int i=0; i<localDirichletValues[fieldIndex].size(); ++i){
+		double & value = new_solution.local_element(localDirichletValues[fieldIndex][i].first);
+		local_norm_sqr += localDirichletValues[fieldIndex][i].second*localDirichletValues[fieldIndex][i].second - value*value;
+		value = localDirichletValues[fieldIndex][i].second;
+	}
+
+	// The ghost entries of the residual vector must be zero before the next cell loop, otherwise they are added to the owned entries
+	old_solution.zero_out_ghosts();
+
+	std::swap(solutionSet[fieldIndex],residualSet[fieldIndex]);
+	solutionSet[fieldIndex]->update_ghost_values();
+	residualIsZeroed[fieldIndex] = true;
+
+	return std::sqrt(Utilities::MPI::sum(local_norm_sqr, mpi_communicator));
+}
+
+// Variant of explicitUpdate for a field stored in single precision: the new solution is written to the single
+// precision vector and the residual vector is zeroed for the next call to computeRHS
+template <int dim, int degree>
+double MatrixFreePDE<dim,degree>::explicitUpdateSinglePrecision(const unsigned int fieldIndex){
+
+	vectorType & residual = *residualSet[fieldIndex];
+	parallel::distributed::Vector<float> & new_solution = *solutionSetFloat[fieldIndex];
+
+	const unsigned int invM_size = invM.local_size();
+	const unsigned int local_size = residual.local_size();
+
+	double local_norm_sqr = 0.0;
+	for (unsigned int offset=0; offset<local_size; offset+=invM_size){
+		for (unsigned int k=0; k<invM_size; ++k){
+			const float value = invM.local_element(k)*residual.local_element(offset+k);
+			new_solution.local_element(offset+k) = value;
+			residual.local_element(offset+k) = 0.0;
+			local_norm_sqr += value*value;
+		}
+	}
+
+	for (unsigned int i=0; i<localDirichletValues[fieldIndex].size(); ++i){
+		float & value = new_solution.local_element(localDirichletValues[fieldIndex][i].first);
+		local_norm_sqr += localDirichletValues[fieldIndex][i].second*localDirichletValues[fieldIndex][i].second - value*value;
+		value = localDirichletValues[fieldIndex][i].second;
+	}
+
+	residual.zero_out_ghosts();
+	new_solution.update_ghost_values();
+	residualIsZeroed[fieldIndex] = true;
+	doubleSolutionOutdated[fieldIndex] = true;
+
+	return std::sqrt(Utilities::MPI::sum(local_norm_sqr, mpi_communicator));
+}
+
+// Adams-Bashforth update of a parabolic field in a single pass over the local DOFs: the rate at the current solution
+// is computed from the residual and stored as the newest rate, and the solution is updated in place with the weighted
+// sum of the newest and the stored rates. The residual vector is zeroed for the next call to computeRHS. Until enough
+// rates are stored (at the start and after resuming from a checkpoint), the highest order with enough rates is used.
+// Returns the l2 norm of the new solution.
+template <int dim, int degree>
+double MatrixFreePDE<dim,degree>::multistepUpdate(const unsigned int fieldIndex){
+
+	// A field whose value isn't used in residualRHS is an algebraic constraint rather than an ODE, so it is set to
+	// invM*R by the explicit update and its rate history isn't used
+	if (!userInputs.varInfoListRHS[fieldIndex].need_value){
+		return explicitUpdate(fieldIndex);
+	}
+
+	vectorType & residual = *residualSet[fieldIndex];
+	vectorType & solution = *solutionSet[fieldIndex];
+
+	// The oldest rate is no longer needed, so its vector is reused for the newest rate
+	const unsigned int num_ages = rateHistory.size();
+	vectorType * oldest_rate = rateHistory[num_ages-1][fieldIndex];
+	for (unsigned int age=num_ages-1; age>0; age--){
+		rateHistory[age][fieldIndex] = rateHistory[age-1][fieldIndex];
+	}
+	rateHistory[0][fieldIndex] = oldest_rate;
+
+	const unsigned int order = std::min(numStoredRates+1, num_ages);
+	const std::vector<double> & beta = multistepCoefficients[order-1];
+	// The step can be shorter than dtValue after a blow-up (the rate is still computed from a residual for dtValue)
+	const double dt = explicitStepRatio*userInputs.dtValue;
+	const double inv_dt = 1.0/userInputs.dtValue;
+
+	vectorType & rate = *rateHistory[0][fieldIndex];
+	const vectorType * previous_rate_1 = (order > 1) ? rateHistory[1][fieldIndex] : NULL;
+	const vectorType * previous_rate_2 = (order > 2) ? rateHistory[2][fieldIndex] : NULL;
+
+	// Takes advantage of knowledge that the length of solutionSet and residualSet is an integer multiple of the length of invM for vector variables
+	const unsigned int invM_size = invM.local_size();
+	const unsigned int local_size = solution.local_size();
+
+	double local_norm_sqr = 0.0;
+	for (unsigned int offset=0; offset<local_size; offset+=invM_size){
+		for (unsigned int k=0; k<invM_size; ++k){
+			const unsigned int i = offset+k;
+			const double old_value = solution.local_element(i);
+			const double current_rate = (invM.local_element(k)*residual.local_element(i) - old_value)*inv_dt;
+			rate.local_element(i) = current_rate;
+
+			double increment = beta[0]*current_rate;
+			if (previous_rate_1 != NULL){
+				increment += beta[1]*previous_rate_1->local_element(i);
+			}
+			if (previous_rate_2 != NULL){
+				increment += beta[2]*previous_rate_2->local_element(i);
+			}
+			const double value = old_value + dt*increment;
+			solution.local_element(i) = value;
+			residual.local_element(i) = 0.0;
+			local_norm_sqr += value*value;
+		}
+	}
+
+	// Set the Dirichlet values
+	for (unsigned int i=0; i<localDirichletValues[fieldIndex].size(); ++i){
+		double & value = solution.local_element(localDirichletValues[fieldIndex][i].first);
+		local_norm_sqr += localDirichletValues[fieldIndex][i].second*localDirichletValues[fieldIndex][i].second - value*value;
+		value = localDirichletValues[fieldIndex][i].second;
+		rate.local_element(localDirichletValues[fieldIndex][i].first) = 0.0;
+	}
+
+	residual.zero_out_ghosts();
+	solution.update_ghost_values();
+	residualIsZeroed[fieldIndex] = true;
+
+	return std::sqrt(Utilities::MPI::sum(local_norm_sqr, mpi_communicator));
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
@@ -0,0 +1,224 @@
+// Methods in MatrixFreePDE for the exponential time differencing (ETD) time integration schemes
+
+#include "../../include/matrixFreePDE.h"
+
+// Time step of the ETD schemes. Each PARABOLIC field is split into du/dt = L*u + N(u), where L is the linear operator
+// from residualLHS for the fields with implicit linear terms (zero for the others) and N is the rate of the explicit
+// terms from residualRHS (from computeRates). The linear part is integrated exactly with the phi-functions of dt*L:
+//   ETD1:   u_{n+1} = u_n + dt*phi_1(dt*L)*(L*u_n + N(u_n))
+//   ETD2RK: a = u_n + dt*phi_1(dt*L)*(L*u_n + N(u_n)),  u_{n+1} = a + dt*phi_2(dt*L)*(N(a) - N(u_n))
+// The products of the phi-functions with vectors are Krylov approximations (see krylovPhiProduct), so the time step
+// isn't limited by the stiffness of the linear terms, and L is only applied through vmult. A field whose value isn't
+// used in residualRHS isn't integrated, computeRates sets it to invM*R at each stage.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::etdUpdate(){
+
+	char buffer[200];
+	const double dt = userInputs.dtValue;
+
+	std::vector<vectorType> nonlinear_rates(fields.size());
+	std::vector<vectorType*> nonlinear_rate_ptrs(fields.size());
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		matrixFreeObject.initialize_dof_vector(nonlinear_rates[fieldIndex], fieldIndex);
+		nonlinear_rate_ptrs[fieldIndex] = &nonlinear_rates[fieldIndex];
+	}
+	std::vector<unsigned int> krylov_dimensions(fields.size(),0);
+
+	// Nonlinear rates at the current solution, N(u_n)
+	computeRates(nonlinear_rate_ptrs);
+
+	// First stage (the whole step for ETD1)
+	vectorType linear_rate, update;
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		if (!userInputs.varInfoListRHS[fieldIndex].need_value){
+			continue;
+		}
+		vectorType & solution = *solutionSet[fieldIndex];
+
+		if (userInputs.var_implicit_linear_terms[fieldIndex]){
+			matrixFreeObject.initialize_dof_vector(linear_rate, fieldIndex);
+			matrixFreeObject.initialize_dof_vector(update, fieldIndex);
+			applyETDLinearOperator(fieldIndex, linear_rate, solution);
+			linear_rate += nonlinear_rates[fieldIndex];
+			krylov_dimensions[fieldIndex] = krylovPhiProduct(fieldIndex, 1, linear_rate, update);
+			solution += update;
+		}
+		else {
+			// With L = 0 this is a forward Euler step
+			solution.add(dt, nonlinear_rates[fieldIndex]);
+		}
+
+		for (unsigned int i=0; i<localDirichletValues[fieldIndex].size(); ++i){
+			solution.local_element(localDirichletValues[fieldIndex][i].first) = localDirichletValues[fieldIndex][i].second;
+		}
+		solution.update_ghost_values();
+	}
+
+	// Second stage, the correction of the nonlinear rate over the step
+	if (userInputs.etd_order == 2){
+		std::vector<vectorType> stage_rates(fields.size());
+		std::vector<vectorType*> stage_rate_ptrs(fields.size());
+		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+			matrixFreeObject.initialize_dof_vector(stage_rates[fieldIndex], fieldIndex);
+			stage_rate_ptrs[fieldIndex] = &stage_rates[fieldIndex];
+		}
+		computeRates(stage_rate_ptrs);
+
+		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+			if (!userInputs.varInfoListRHS[fieldIndex].need_value){
+				continue;
+			}
+			vectorType & solution = *solutionSet[fieldIndex];
+			stage_rates[fieldIndex] -= nonlinear_rates[fieldIndex];
+
+			if (userInputs.var_implicit_linear_terms[fieldIndex]){
+				matrixFreeObject.initialize_dof_vector(update, fieldIndex);
+				krylov_dimensions[fieldIndex] = std::max(krylov_dimensions[fieldIndex], krylovPhiProduct(fieldIndex, 2, stage_rates[fieldIndex], update));
+				solution += update;
+			}
+			else {
+				// phi_2(0) = 1/2
+				solution.add(0.5*dt, stage_rates[fieldIndex]);
+			}
+			// The rates are zero at the Dirichlet DOFs, so the values set in the first stage are kept
+			solution.update_ghost_values();
+		}
+	}
+
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		const double solution_norm = solutionSet[fieldIndex]->l2_norm();
+
+		if (currentIncrement%userInputs.skip_print_steps==0){
+			sprintf(buffer, "field '%2s' [ETD%s update]: current solution: %12.6e, Krylov vectors: %u\n", \
+			fields[fieldIndex].name.c_str(),				\
+			(userInputs.etd_order == 2 ? "2RK" : "1"),		\
+			solution_norm,									\
+			krylov_dimensions[fieldIndex]);
+			pcout<<buffer;
+		}
+
+		//check if solution is nan
+		if (!numbers::is_finite(solution_norm)){
+			sprintf(buffer, "ERROR: field '%s' solution is NAN. exiting.\n\n",
+			fields[fieldIndex].name.c_str());
+			pcout<<buffer;
+			exit(-1);
+		}
+	}
+}
+
+// Apply the linear operator of a field with implicit linear terms. residualLHS gives (M + dtValue*K)*v through vmult,
+// so L*v = -invM*K*v = (v - invM*vmult(v))/dtValue. L*v is set to zero at the Dirichlet DOFs and at the DOFs
+// constrained to others (whose values are never read), so the Krylov vectors don't pick up spurious components there.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::applyETDLinearOperator(const unsigned int fieldIndex, vectorType & dst, const vectorType & src){
+
+	currentFieldIndex = fieldIndex; // Used in vmult()
+	vmult(dst, src);
+
+	const double inv_dt = 1.0/userInputs.dtValue;
+
+	// Takes advantage of knowledge that the length of the field vectors is an integer multiple of the length of invM for vector variables
+	const unsigned int invM_size = invM.local_size();
+	const unsigned int local_size = dst.local_size();
+	for (unsigned int offset=0; offset<local_size; offset+=invM_size){
+		for (unsigned int k=0; k<invM_size; ++k){
+			dst.local_element(offset+k) = (src.local_element(offset+k) - invM.local_element(k)*dst.local_element(offset+k))*inv_dt;
+		}
+	}
+
+	for (unsigned int i=0; i<localDirichletValues[fieldIndex].size(); ++i){
+		dst.local_element(localDirichletValues[fieldIndex][i].first) = 0.0;
+	}
+	constraintsOtherSet[fieldIndex]->set_zero(dst);
+}
+
+// Approximate dtValue*phi_k(dtValue*L)*b for a field with implicit linear terms (k = 1 or 2). The Arnoldi process
+// (with modified Gram-Schmidt) builds an orthonormal basis V_m of the Krylov subspace span{b, L*b, ..., L^(m-1)*b} and
+// the upper Hessenberg matrix H_m = V_m^T*L*V_m, and the approximation is beta*dt*V_m*phi_k(dt*H_m)*e_1 with
+// beta = |b|. The phi-functions of the small matrix are found with krylovPhiFunctions.h. The operator isn't symmetric
+// in the Euclidean inner product (because of invM), so the full Arnoldi process is used rather than Lanczos. Every few
+// vectors the relative error is estimated with the usual a posteriori estimate, h_{m+1,m}*dt*|e_m^T*phi_{k+1}(dt*H_m)*e_1|
+// relative to |phi_k(dt*H_m)*e_1|, and the process stops once it is below the Krylov tolerance. Returns the number of
+// Krylov vectors used.
+template <int dim, int degree>
+unsigned int MatrixFreePDE<dim,degree>::krylovPhiProduct(const unsigned int fieldIndex, const unsigned int k, const vectorType & b, vectorType & result){
+
+	const double dt = userInputs.dtValue;
+	const unsigned int max_dimension = userInputs.krylov_max_dimension;
+	const unsigned int check_interval = 5;
+
+	result = 0.0;
+	const double beta = b.l2_norm();
+	if (beta == 0.0){
+		return 0;
+	}
+
+	// The basis vectors are kept between calls, and are resized for the field if needed
+	while (krylovBasis.size() < max_dimension+1){
+		krylovBasis.push_back(new vectorType);
+	}
+
+	std::vector<vectorType*> & V = krylovBasis;
+	V[0]->reinit(b, true);
+	*V[0] = b;
+	*V[0] *= 1.0/beta;
+
+	denseMatrix H(max_dimension+1, std::vector<double>(max_dimension,0.0));
+	std::vector<std::vector<double> > phi;
+	unsigned int m = 0;
+	bool converged = false;
+
+	for (unsigned int j=0; j<max_dimension; j++){
+		V[j+1]->reinit(b, true);
+		applyETDLinearOperator(fieldIndex, *V[j+1], *V[j]);
+
+		double column_norm = 0.0;
+		for (unsigned int i=0; i<=j; i++){
+			H[i][j] = (*V[j+1]) * (*V[i]);
+			V[j+1]->add(-H[i][j], *V[i]);
+			column_norm += H[i][j]*H[i][j];
+		}
+		H[j+1][j] = V[j+1]->l2_norm();
+		column_norm = std::sqrt(column_norm + H[j+1][j]*H[j+1][j]);
+		m = j+1;
+
+		// The Krylov subspace is invariant under L (happy breakdown), so the approximation is exact
+		const bool breakdown = (H[j+1][j] <= 1.0e-12*column_norm);
+
+		if (breakdown || m%check_interval == 0 || m == max_dimension){
+			denseMatrix scaled_H(m, std::vector<double>(m,0.0));
+			for (unsigned int r=0; r<m; r++){
+				for (unsigned int c=0; c<m; c++){
+					scaled_H[r][c] = dt*H[r][c];
+				}
+			}
+			phi = phiFunctionsTimesFirstUnitVector(scaled_H, k+1);
+
+			double phi_norm = 0.0;
+			for (unsigned int r=0; r<m; r++){
+				phi_norm += phi[k-1][r]*phi[k-1][r];
+			}
+			phi_norm = std::sqrt(phi_norm);
+
+			const double error_estimate = breakdown ? 0.0 : H[j+1][j]*dt*std::abs(phi[k][m-1]);
+			converged = (error_estimate <= userInputs.krylov_tolerance*phi_norm);
+		}
+		if (converged || breakdown){
+			break;
+		}
+		*V[j+1] *= 1.0/H[j+1][j];
+	}
+
+	if (!converged){
+		pcout << "\nWarning: Krylov approximation for the ETD time step did not converge as per set tolerances. consider increasing the Krylov subspace dimension or decreasing the time step.\n";
+	}
+
+	for (unsigned int i=0; i<m; i++){
+		result.add(beta*dt*phi[k-1][i], *V[i]);
+	}
+
+	return m;
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
@@ -0,0 +1,207 @@
+// Methods in MatrixFreePDE for the implicit backward differentiation formula (BDF) time integration schemes
+
+#include "../../include/matrixFreePDE.h"
+
+// Time step of the BDF schemes. The new solution solves the nonlinear system G(u) = u - h - gamma*dt*f(u) = 0 for all
+// of the fields together, where f is the rate from computeRates and h is the combination of the previous solutions:
+//   BDF1 (backward Euler): h = u_n,                  gamma = 1
+//   BDF2:                  h = 4/3*u_n - 1/3*u_{n-1}, gamma = 2/3
+// For a field whose value isn't used in residualRHS (an algebraic constraint rather than an ODE) the block of G is
+// u - invM*R(u) instead, without the previous solutions.
+// The system is solved with Newton iterations (with a backtracking line search), and the linear system of each
+// iteration is solved with GMRES, where the products with the Jacobian are finite differences of computeRates. The
+// Jacobian is never assembled, so each GMRES iteration costs one evaluation of the residuals with the same matrix-free
+// cell loops used by the explicit schemes.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::bdfUpdate(){
+
+	char buffer[200];
+
+	// The linear solves of the inexact Newton iterations only reduce the nonlinear residual by a fixed factor, and the
+	// line search halves the Newton step until the residual decreases
+	const double linear_forcing = 1.0e-3;
+	const unsigned int gmres_restart = 30;
+	const unsigned int max_line_search_steps = 10;
+
+	// BDF2 needs the solution from the previous time step, so the first step (and the first step after restarting
+	// from a checkpoint) is taken with BDF1
+	const bool second_order = (userInputs.bdf_order == 2 && bdfSolutionOldValid);
+	bdfRateScale = (second_order ? 2.0/3.0 : 1.0)*explicitStepRatio*userInputs.dtValue;
+
+	// Combination of the previous solutions, and the Newton iterate starting from the current solution. The Dirichlet
+	// values are set in both, so the nonlinear residual (and the Newton update) is zero at the Dirichlet DOFs.
+	blockVectorType history;
+	history.reinit(bdfSolution, true);
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		bdfSolution.block(fieldIndex) = *solutionSet[fieldIndex];
+		history.block(fieldIndex) = *solutionSet[fieldIndex];
+		if (second_order){
+			history.block(fieldIndex).sadd(4.0/3.0, -1.0/3.0, *bdfSolutionOld[fieldIndex]);
+		}
+		// Only the locally owned values are used by the vector operations of the solvers
+		bdfSolution.block(fieldIndex).zero_out_ghosts();
+		history.block(fieldIndex).zero_out_ghosts();
+		for (unsigned int i=0; i<localDirichletValues[fieldIndex].size(); ++i){
+			bdfSolution.block(fieldIndex).local_element(localDirichletValues[fieldIndex][i].first) = localDirichletValues[fieldIndex][i].second;
+			history.block(fieldIndex).local_element(localDirichletValues[fieldIndex][i].first) = localDirichletValues[fieldIndex][i].second;
+		}
+
+		// The current solution is the previous one for the next BDF2 step
+		if (userInputs.bdf_order == 2){
+			*bdfSolutionOld[fieldIndex] = *solutionSet[fieldIndex];
+		}
+	}
+	if (userInputs.bdf_order == 2){
+		bdfSolutionOldValid = true;
+	}
+
+	blockVectorType nonlinear_residual, newton_update;
+	nonlinear_residual.reinit(bdfSolution, true);
+	newton_update.reinit(bdfSolution, true);
+
+	double residual_norm = bdfResidual(history, nonlinear_residual);
+	const double initial_residual_norm = residual_norm;
+	const double newton_tol_value = userInputs.newton_tolerance*initial_residual_norm;
+
+	unsigned int newton_iteration = 0;
+	unsigned int linear_iterations = 0;
+	for (; newton_iteration<userInputs.max_newton_iterations && residual_norm > newton_tol_value; newton_iteration++){
+
+		// Solve J*du = -G(u)
+		nonlinear_residual *= -1.0;
+		newton_update = 0.0;
+
+		SolverControl solver_control(userInputs.max_solver_iterations, linear_forcing*residual_norm);
+		SolverGMRES<blockVectorType> solver(solver_control, typename SolverGMRES<blockVectorType>::AdditionalData(gmres_restart));
+		try{
+			solver.solve(bdfJacobian(*this), newton_update, nonlinear_residual, PreconditionIdentity());
+		}
+		catch (...) {
+			pcout << "\nWarning: linear solver for the Newton update did not converge as per set tolerances. consider increasing maxSolverIterations.\n";
+		}
+		linear_iterations += solver_control.last_step();
+
+		// Backtracking line search on the norm of the nonlinear residual
+		double step_length = 1.0;
+		bdfSolution.add(step_length, newton_update);
+		double new_residual_norm = bdfResidual(history, nonlinear_residual);
+		for (unsigned int line_search_step=0; line_search_step<max_line_search_steps; line_search_step++){
+			if (new_residual_norm <= (1.0-1.0e-4*step_length)*residual_norm){
+				break;
+			}
+			bdfSolution.add(-0.5*step_length, newton_update);
+			step_length *= 0.5;
+			new_residual_norm = bdfResidual(history, nonlinear_residual);
+		}
+		residual_norm = new_residual_norm;
+	}
+
+	if (residual_norm > newton_tol_value){
+		pcout << "\nWarning: Newton iterations for the BDF time step did not converge as per set tolerances. consider increasing the maximum number of Newton iterations or decreasing the time step.\n";
+	}
+
+	// bdfResidual left the last Newton iterate in solutionSet (with invM*R at the iterate for the fields that are algebraic constraints)
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		const double solution_norm = solutionSet[fieldIndex]->l2_norm();
+
+		if (currentIncrement%userInputs.skip_print_steps==0){
+			sprintf(buffer, "field '%2s' [BDF%u solve]: current solution: %12.6e\n", \
+			fields[fieldIndex].name.c_str(),	\
+			(second_order ? 2u : 1u),			\
+			solution_norm);
+			pcout<<buffer;
+		}
+
+		//check if solution is nan
+		if (!numbers::is_finite(solution_norm)){
+			// With blow-up recovery, the time loop restores the last snapshot and retries with a smaller time step
+			if (userInputs.blowup_recovery_snapshots > 0){
+				sprintf(buffer, "field '%s' solution is NAN.\n", fields[fieldIndex].name.c_str());
+				pcout<<buffer;
+				solutionBlowUp = true;
+				return;
+			}
+			sprintf(buffer, "ERROR: field '%s' solution is NAN. exiting.\n\n",
+			fields[fieldIndex].name.c_str());
+			pcout<<buffer;
+			exit(-1);
+		}
+	}
+
+	if (currentIncrement%userInputs.skip_print_steps==0){
+		sprintf(buffer, "Newton iterations: %u, GMRES iterations: %u, initial residual: %12.6e, final residual: %12.6e\n", \
+		newton_iteration, linear_iterations, initial_residual_norm, residual_norm);
+		pcout<<buffer;
+	}
+}
+
+// Evaluate the nonlinear residual of the BDF step, G(u) = u - h - gamma*dt*f(u), at the Newton iterate in bdfSolution.
+// The iterate is copied into solutionSet for computeRates (and is left there), and the rates are kept in bdfRates as
+// the base point of the finite differences in applyBDFJacobian. For the fields set to invM*R by computeRates, bdfRates
+// holds invM*R instead of the (zero) rate and the residual is u - invM*R. Returns the l2 norm of the residual.
+template <int dim, int degree>
+double MatrixFreePDE<dim,degree>::bdfResidual(const blockVectorType & history, blockVectorType & residual){
+
+	std::vector<vectorType*> rates(fields.size());
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		*solutionSet[fieldIndex] = bdfSolution.block(fieldIndex);
+		solutionSet[fieldIndex]->update_ghost_values();
+		rates[fieldIndex] = &bdfRates.block(fieldIndex);
+	}
+	computeRates(rates);
+	bdfSolutionNorm = bdfSolution.l2_norm();
+
+	residual = bdfSolution;
+	residual -= history;
+	residual.add(-bdfRateScale, bdfRates);
+
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		if (!userInputs.varInfoListRHS[fieldIndex].need_value){
+			bdfRates.block(fieldIndex) = *solutionSet[fieldIndex];
+			bdfRates.block(fieldIndex).zero_out_ghosts();
+			residual.block(fieldIndex) = bdfSolution.block(fieldIndex);
+			residual.block(fieldIndex) -= bdfRates.block(fieldIndex);
+		}
+	}
+
+	return residual.l2_norm();
+}
+
+// Apply the Jacobian of the nonlinear residual of the BDF step at bdfSolution, J*v = v - gamma*dt*f'(u)*v. The product
+// with the Jacobian of the rates is the finite difference (f(u+epsilon*v) - f(u))/epsilon, with the rates at u from
+// the last call to bdfResidual. The rates are zero at the Dirichlet DOFs, so J is the identity there. For the fields set
+// to invM*R by computeRates, the block is v - (invM*R(u+epsilon*v) - invM*R(u))/epsilon.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::applyBDFJacobian(blockVectorType & dst, const blockVectorType & src){
+
+	const double src_norm = src.l2_norm();
+	if (src_norm == 0.0){
+		dst = 0.0;
+		return;
+	}
+
+	// The usual choice of the finite difference step, balancing the truncation error against the rounding error
+	const double epsilon = std::sqrt(std::numeric_limits<double>::epsilon())*(1.0+bdfSolutionNorm)/src_norm;
+
+	std::vector<vectorType*> rates(fields.size());
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		*solutionSet[fieldIndex] = bdfSolution.block(fieldIndex);
+		solutionSet[fieldIndex]->add(epsilon, src.block(fieldIndex));
+		solutionSet[fieldIndex]->update_ghost_values();
+		rates[fieldIndex] = &dst.block(fieldIndex);
+	}
+	computeRates(rates);
+
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		double scale = bdfRateScale/epsilon;
+		if (!userInputs.varInfoListRHS[fieldIndex].need_value){
+			dst.block(fieldIndex) = *solutionSet[fieldIndex];
+			dst.block(fieldIndex).zero_out_ghosts();
+			scale = 1.0/epsilon;
+		}
+		dst.block(fieldIndex).sadd(-scale, scale, bdfRates.block(fieldIndex));
+	}
+	dst += src;
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
@@ -85,6 +85,12 @@ template <int dim, int degree>
 		 dofHandlersSet_nonconst.push_back(dof_handler);
 
 		 dof_handler->distribute_dofs (*fe);
+		 // The multigrid preconditioner also needs the DOFs of each level of the mesh
+	     #if (DEAL_II_VERSION_MAJOR >= 9)
+		 if (userInputs.linear_preconditioner == GMG_PRECONDITIONER){
+			 dof_handler->distribute_mg_dofs();
+		 }
+	     #endif
 		 totalDOFs+=dof_handler->n_dofs();
 
 		 // Extract locally_relevant_dofs
@@ -142,17 +148,14 @@ template <int dim, int degree>
 	 }
 	 pcout << "total DOF : " << totalDOFs << std::endl;
 
+	 // Check the variable attributes against the residual methods (must be done before the cell loop containers are created)
+	 traceVariableNeeds();
+	 if (userInputs.max_subcycling_steps > 1){
+		 initSubcycleVariableNeeds();
+	 }
+
 	 // Setup the matrix free object
-	 typename MatrixFree<dim,double>::AdditionalData additional_data;
-     // The member "mpi_communicator" was removed in deal.II version 8.5 but is required before it
-     #if (DEAL_II_VERSION_MAJOR < 9 && DEAL_II_VERSION_MINOR < 5)
-         additional_data.mpi_communicator = MPI_COMM_WORLD;
-     #endif
-	 additional_data.tasks_parallel_scheme = MatrixFree<dim,double>::AdditionalData::partition_partition;
-	 additional_data.mapping_update_flags = (update_values | update_gradients | update_JxW_values | update_quadrature_points);
-	 QGaussLobatto<1> quadrature (degree+1);
-	 matrixFreeObject.clear();
-	 matrixFreeObject.reinit (dofHandlersSet, constraintsOtherSet, quadrature, additional_data);
+	 setupMatrixFreeObjects();
 
 	 bool dU_scalar_init = false;
 	 bool dU_vector_init = false;
@@ -186,6 +189,9 @@ template <int dim, int degree>
 		 }
 	 }
 
+	 // Store the locally owned Dirichlet DOFs for the explicit update
+	 setLocalDirichletValues();
+
 	 //check if time dependent BVP and compute invM
 	 if (isTimeDependentBVP){
 		 computeInvM();
@@ -225,9 +231,70 @@ template <int dim, int degree>
           load_checkpoint_time_info();
       }
 
+      // Create the single precision copies of the fields that are stored in single precision during time stepping
+      initSinglePrecisionFields();
+
+      // Allocate the vectors for the selected time integration scheme
+      initTimeIntegrationVectors();
+
+      // Estimate the stable time step on the initial mesh
+      if (userInputs.automatic_time_step && isTimeDependentBVP){
+          estimateStableTimeStep();
+      }
+
 	 computing_timer.exit_section("matrixFreePDE: initialization");
 }
 
+// Setup the matrix free object(s) for the current mesh
+template <int dim, int degree>
+ void MatrixFreePDE<dim,degree>::setupMatrixFreeObjects(){
+
+	 QGaussLobatto<1> quadrature (degree+1);
+
+	 // The per-thread containers refer to the matrix free objects, so they need to be rebuilt
+	 clearThreadLocalContainers();
+
+	 typename MatrixFree<dim,double>::AdditionalData additional_data;
+     // The member "mpi_communicator" was removed in deal.II version 8.5 but is required before it
+     #if (DEAL_II_VERSION_MAJOR < 9 && DEAL_II_VERSION_MINOR < 5)
+         additional_data.mpi_communicator = mpi_communicator;
+     #endif
+	 additional_data.tasks_parallel_scheme = MatrixFree<dim,double>::AdditionalData::partition_partition;
+     //additional_data.tasks_block_size = 1; // This improves performance for small runs, not sure about larger runs
+	 // The quadrature point locations are a large part of the mapping data, so they are only stored if they are used
+	 additional_data.mapping_update_flags = (update_values | update_gradients | update_JxW_values);
+	 if (userInputs.need_q_point_locations){
+		 additional_data.mapping_update_flags = additional_data.mapping_update_flags | update_quadrature_points;
+	 }
+	 matrixFreeObject.clear();
+	 matrixFreeObject.reinit (dofHandlersSet, constraintsOtherSet, quadrature, additional_data);
+
+	 // Single precision version, with the same DOF numbering so it can read from and write to the same vectors
+	 if (userInputs.single_precision_residual){
+		 typename MatrixFree<dim,float>::AdditionalData additional_data_float;
+	     #if (DEAL_II_VERSION_MAJOR < 9 && DEAL_II_VERSION_MINOR < 5)
+	         additional_data_float.mpi_communicator = mpi_communicator;
+	     #endif
+		 additional_data_float.tasks_parallel_scheme = MatrixFree<dim,float>::AdditionalData::partition_partition;
+		 additional_data_float.mapping_update_flags = additional_data.mapping_update_flags;
+		 matrixFreeObjectFloat.clear();
+		 matrixFreeObjectFloat.reinit (dofHandlersSet, constraintsOtherSet, quadrature, additional_data_float);
+	 }
+
+	 // The matrix free objects of the mesh levels and the transfers between them, for the multigrid preconditioner
+	 #if (DEAL_II_VERSION_MAJOR >= 9)
+	 if (userInputs.linear_preconditioner == GMG_PRECONDITIONER){
+		 setupMultigrid();
+	 }
+	 #endif
+
+	 // The diagonals of the Jacobi and Chebyshev preconditioners are recomputed for the new mesh, and the previous
+	 // solutions and recycled Krylov vectors of the ELLIPTIC fields are dropped
+	 invalidatePreconditionerDiagonal();
+	 resetEllipticSolveHistory();
+	 recycledKrylovVectors.assign(fields.size(), std::vector<std::shared_ptr<vectorType> >());
+}
+
 template <int dim, int degree>
  void MatrixFreePDE<dim,degree>::makeTriangulation(parallel::distributed::Triangulation<dim> & tria) const{
      if (dim == 3){
@@ -60,7 +60,7 @@ for (unsigned int var_index=0; var_index < userInputs.number_of_variables; var_i
 			filename = userInputs.load_file_name[var_index] + ".vtk";
 		}
 		else {
-			int proc_num = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+			int proc_num = Utilities::MPI::this_mpi_process(mpi_communicator);
 			std::ostringstream conversion;
 			conversion << proc_num;
 			filename = userInputs.load_file_name[var_index] + "." + conversion.str() + ".vtk";
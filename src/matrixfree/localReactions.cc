@@ -0,0 +1,23 @@
+// Methods in MatrixFreePDE for the operator splitting of the local reaction terms
+
+#include "../../include/matrixFreePDE.h"
+
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::integrateLocalReactions(const double dt){
+
+    // Default DOF loop, where reactionRates is called through the virtual function table
+    localReactionLoop(dt,
+        [this](const std::vector<dealii::VectorizedArray<double> > & values,
+               std::vector<dealii::VectorizedArray<double> > & rates){
+            this->reactionRates(values,rates);
+        });
+}
+
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::reactionRates(const std::vector<dealii::VectorizedArray<double> > & values,
+                                               std::vector<dealii::VectorizedArray<double> > & rates) const {
+    std::cerr << "PRISMS-PF Error: Local reaction terms are set for at least one equation in equations.h, but this application doesn't provide reactionRates." << std::endl;
+    abort();
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
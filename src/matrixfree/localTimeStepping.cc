@@ -0,0 +1,207 @@
+// Methods in MatrixFreePDE for local time stepping on adaptively refined meshes
+
+#include "../../include/matrixFreePDE.h"
+
+// Find the time step class of each DOF for local time stepping. A cell at the finest level of the mesh has class zero,
+// and each coarser level has the next class (up to the number of levels in the parameters file). Each DOF takes the
+// smallest class of the cells it belongs to, and of the DOFs constrained to it, so that the time step of every DOF is
+// limited by the finest cell its residual gets contributions from. The cell batches of the MatrixFree object mix cells
+// from different levels, so for each class the ranges of batches with a DOF of that class (or finer) are stored, and
+// only those are evaluated when the DOFs of that class are updated.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::initLocalTimeStepping(){
+
+	const unsigned int num_classes = userInputs.local_time_stepping_levels;
+	const unsigned int finest_level = triangulation.n_global_levels()-1;
+
+	// Class of each locally relevant DOF (indexed as the local elements of the solution vector, owned and then ghost)
+	std::vector<std::vector<unsigned char> > relevant_dof_class(fields.size());
+
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		const Utilities::MPI::Partitioner & partitioner = *solutionSet[fieldIndex]->get_partitioner();
+		std::vector<unsigned char> & dof_class = relevant_dof_class[fieldIndex];
+		dof_class.assign(partitioner.local_size()+partitioner.n_ghost_indices(), num_classes-1);
+
+		std::vector<types::global_dof_index> local_dof_indices(dofHandlersSet[fieldIndex]->get_fe().dofs_per_cell);
+		typename DoFHandler<dim>::active_cell_iterator cell = dofHandlersSet[fieldIndex]->begin_active(), endc = dofHandlersSet[fieldIndex]->end();
+		for (; cell!=endc; ++cell){
+			if (!cell->is_locally_owned() && !cell->is_ghost()){
+				continue;
+			}
+			const unsigned char cell_class = std::min(finest_level - cell->level(), num_classes-1);
+			cell->get_dof_indices(local_dof_indices);
+			for (unsigned int i=0; i<local_dof_indices.size(); ++i){
+				if (partitioner.in_local_range(local_dof_indices[i]) || partitioner.is_ghost_entry(local_dof_indices[i])){
+					unsigned char & index_class = dof_class[partitioner.global_to_local(local_dof_indices[i])];
+					index_class = std::min(index_class, cell_class);
+				}
+			}
+		}
+
+		// The residuals of DOFs constrained to others (at hanging nodes or periodic boundaries) are added to the DOFs
+		// they are constrained to
+		const ConstraintMatrix & constraints = *constraintsOtherSet[fieldIndex];
+		for (unsigned int i=0; i<dof_class.size(); ++i){
+			const std::vector<std::pair<types::global_dof_index,double> > * entries = constraints.get_constraint_entries(partitioner.local_to_global(i));
+			if (entries == NULL){
+				continue;
+			}
+			for (unsigned int j=0; j<entries->size(); ++j){
+				const types::global_dof_index master = (*entries)[j].first;
+				if (partitioner.in_local_range(master) || partitioner.is_ghost_entry(master)){
+					unsigned char & master_class = dof_class[partitioner.global_to_local(master)];
+					master_class = std::min(master_class, dof_class[i]);
+				}
+			}
+		}
+
+		// Make the classes the same on all processors, since the cells beyond a processor's ghost layer can lower the
+		// class of a DOF through the constraints. For each class, the DOFs at that class or finer on any processor are
+		// marked (with compress(add), so the classes work the same way for all of the supported deal.II versions).
+		vectorType indicator;
+		indicator.reinit(*solutionSet[fieldIndex]);
+		for (unsigned int c=0; c+1<num_classes; ++c){
+			indicator = 0.0;
+			indicator.zero_out_ghosts();
+			for (unsigned int i=0; i<dof_class.size(); ++i){
+				if (dof_class[i] <= c){
+					indicator.local_element(i) = 1.0;
+				}
+			}
+			indicator.compress(VectorOperation::add);
+			indicator.update_ghost_values();
+			for (unsigned int i=0; i<dof_class.size(); ++i){
+				if (indicator.local_element(i) > 0.0){
+					dof_class[i] = std::min(dof_class[i], (unsigned char)c);
+				}
+			}
+		}
+
+		ltsDofClass.resize(fields.size());
+		ltsDofClass[fieldIndex].assign(dof_class.begin(), dof_class.begin()+partitioner.local_size());
+	}
+
+	// The class of each cell batch is the smallest class of its DOFs
+	const unsigned int num_batches = matrixFreeObject.n_macro_cells();
+	std::vector<unsigned char> batch_class(num_batches, num_classes-1);
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		const Utilities::MPI::Partitioner & partitioner = *solutionSet[fieldIndex]->get_partitioner();
+		std::vector<types::global_dof_index> local_dof_indices(dofHandlersSet[fieldIndex]->get_fe().dofs_per_cell);
+		for (unsigned int batch=0; batch<num_batches; ++batch){
+			for (unsigned int lane=0; lane<matrixFreeObject.n_components_filled(batch); ++lane){
+				typename DoFHandler<dim>::cell_iterator cell = matrixFreeObject.get_cell_iterator(batch, lane, fieldIndex);
+				cell->get_dof_indices(local_dof_indices);
+				for (unsigned int i=0; i<local_dof_indices.size(); ++i){
+					batch_class[batch] = std::min(batch_class[batch], relevant_dof_class[fieldIndex][partitioner.global_to_local(local_dof_indices[i])]);
+				}
+			}
+		}
+	}
+
+	// Contiguous ranges of the batches needed for each class
+	ltsCellRanges.assign(num_classes, std::vector<std::pair<unsigned int,unsigned int> >());
+	std::vector<unsigned int> num_batches_in_class(num_classes, 0);
+	for (unsigned int c=0; c<num_classes; ++c){
+		for (unsigned int batch=0; batch<num_batches; ++batch){
+			if (batch_class[batch] > c){
+				continue;
+			}
+			if (ltsCellRanges[c].size() > 0 && ltsCellRanges[c].back().second == batch){
+				ltsCellRanges[c].back().second = batch+1;
+			}
+			else {
+				ltsCellRanges[c].push_back(std::make_pair(batch,batch+1));
+			}
+			if (batch_class[batch] == c){
+				num_batches_in_class[c]++;
+			}
+		}
+	}
+
+	pcout << "\nLocal time stepping, cell batches in each time step class (time step 2^class*dt):";
+	for (unsigned int c=0; c<num_classes; ++c){
+		pcout << " " << Utilities::MPI::sum(num_batches_in_class[c], mpi_communicator);
+	}
+	pcout << "\n";
+}
+
+// Forward Euler time step with local time stepping. At increment n, the DOFs of class c are updated if n is a
+// multiple of 2^c, with a step of 2^c*dtValue and the rate at the current solution, so all of the DOFs are at the same
+// time at the multiples of 2^(number of classes - 1). Only the cell batches with a DOF being updated are evaluated.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::localTimeSteppingUpdate(){
+
+	char buffer[200];
+
+	// The largest class that is due at this increment
+	unsigned int max_class = 0;
+	while (max_class+1 < ltsCellRanges.size() && currentIncrement%(1u << (max_class+1)) == 0){
+		max_class++;
+	}
+
+	// Evaluate the residuals on the needed cell batches. The ranges are evaluated one after another (instead of with
+	// the task parallel MatrixFree::cell_loop), so the contributions to the ghost DOFs are added with compress().
+	computing_timer.enter_section("matrixFreePDE: computeRHS");
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		(*residualSet[fieldIndex])=0.0;
+	}
+	const std::vector<std::pair<unsigned int,unsigned int> > & cell_ranges = ltsCellRanges[max_class];
+	for (unsigned int r=0; r<cell_ranges.size(); ++r){
+		getRHS(matrixFreeObject, residualSet, solutionSet, cell_ranges[r]);
+	}
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		residualSet[fieldIndex]->compress(VectorOperation::add);
+	}
+	computing_timer.exit_section("matrixFreePDE: computeRHS");
+
+	// Takes advantage of knowledge that the length of solutionSet and residualSet is an integer multiple of the length of invM for vector variables
+	const unsigned int invM_size = invM.local_size();
+
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		vectorType & solution = *solutionSet[fieldIndex];
+		const vectorType & residual = *residualSet[fieldIndex];
+		const std::vector<unsigned char> & dof_class = ltsDofClass[fieldIndex];
+
+		// The residual is M*(u + dtValue*f(u)), so the update with a step of 2^c*dtValue is u + 2^c*(invM*R - u). A field
+		// whose value isn't used in residualRHS (like the chemical potential in the Cahn-Hilliard apps) is set to invM*R,
+		// which doesn't depend on the time step. So are the DOFs constrained to others (where invM is zero), which are
+		// set to zero as in the single rate update and only get their values from the constraints at output, otherwise
+		// a step of 2^c*dtValue would multiply them by (1-2^c) at every update.
+		const bool projected_field = !userInputs.varInfoListRHS[fieldIndex].need_value;
+		const unsigned int local_size = solution.local_size();
+		for (unsigned int offset=0; offset<local_size; offset+=invM_size){
+			for (unsigned int k=0; k<invM_size; ++k){
+				const unsigned int i = offset+k;
+				if (dof_class[i] <= max_class){
+					const double step_ratio = (projected_field || invM.local_element(k) == 0.0) ? 1.0 : (double)(1u << dof_class[i]);
+					solution.local_element(i) += step_ratio*(invM.local_element(k)*residual.local_element(i) - solution.local_element(i));
+				}
+			}
+		}
+
+		for (unsigned int i=0; i<localDirichletValues[fieldIndex].size(); ++i){
+			solution.local_element(localDirichletValues[fieldIndex][i].first) = localDirichletValues[fieldIndex][i].second;
+		}
+		solution.update_ghost_values();
+
+		const double solution_norm = solution.l2_norm();
+
+		if (currentIncrement%userInputs.skip_print_steps==0){
+			sprintf(buffer, "field '%2s' [local time stepping]: current solution: %12.6e, classes updated: 0-%u\n", \
+			fields[fieldIndex].name.c_str(),	\
+			solution_norm,						\
+			max_class);
+			pcout<<buffer;
+		}
+
+		//check if solution is nan
+		if (!numbers::is_finite(solution_norm)){
+			sprintf(buffer, "ERROR: field '%s' solution is NAN. exiting.\n\n",
+			fields[fieldIndex].name.c_str());
+			pcout<<buffer;
+			exit(-1);
+		}
+	}
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
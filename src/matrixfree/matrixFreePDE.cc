@@ -8,9 +8,13 @@ template <int dim, int degree>
  MatrixFreePDE<dim,degree>::MatrixFreePDE (userInputParameters<dim> _userInputs)
  :
  Subscriptor(),
+ mpi_communicator (pararealCommunicator(_userInputs)),
  pcout (std::cout, Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)==0),
  userInputs(_userInputs),
- triangulation (MPI_COMM_WORLD),
+ // The multigrid preconditioner needs the cells of every level, which are only kept on each process if requested
+ triangulation (mpi_communicator,
+                (_userInputs.linear_preconditioner == GMG_PRECONDITIONER ? Triangulation<dim>::limit_level_difference_at_vertices : Triangulation<dim>::none),
+                (_userInputs.linear_preconditioner == GMG_PRECONDITIONER ? parallel::distributed::Triangulation<dim>::construct_multigrid_hierarchy : parallel::distributed::Triangulation<dim>::default_setting)),
  currentFieldIndex(0),
  isTimeDependentBVP(false),
  isEllipticBVP(false),
@@ -23,13 +27,38 @@ template <int dim, int degree>
  computing_timer (pcout, TimerOutput::summary, TimerOutput::wall_times),
  first_integrated_var_output_complete(false)
  {
+   stableTimeStep = 0.0;
+   explicitStepRatio = 1.0;
+   numStoredRates = 0;
+   bdfSolutionNorm = 0.0;
+   bdfRateScale = 0.0;
+   bdfSolutionOldValid = false;
+   rhsReadsSinglePrecisionFields = false;
+   rhsUsesSubcycleContainers = false;
+   numRecoverySnapshots = 0;
+   newestRecoverySnapshot = 0;
+   recoveryStepReductions = 0;
+   recoveryStepsSinceChange = 0;
+   solutionBlowUp = false;
+   steadyStateWindowIncrement = 0;
+   steadyStateWindowTime = 0.0;
+   steadyStateWindowValid = false;
+   steadyStateStepRatio = 1.0;
+   mgCurrentLevel = 0;
+   mgPreconditionerFieldIndex = numbers::invalid_unsigned_int;
+   activeLHSOperator.initialize(this);
  }
 
  //destructor
  template <int dim, int degree>
  MatrixFreePDE<dim,degree>::~MatrixFreePDE ()
  {
+   #if (DEAL_II_VERSION_MAJOR >= 9)
+   clearMultigrid();
+   #endif
+   clearThreadLocalContainers();
    matrixFreeObject.clear();
+   matrixFreeObjectFloat.clear();
 
    // Delete the pointers contained in several member variable vectors
    // The size of each of these must be checked individually in case an exception is thrown
@@ -55,6 +84,36 @@ template <int dim, int degree>
    for(unsigned int iter=0; iter<residualSet.size(); iter++){
        delete residualSet[iter];
    }
+   for(unsigned int iter=0; iter<solutionSetFloat.size(); iter++){
+       delete solutionSetFloat[iter];
+   }
+   for(unsigned int stage=0; stage<rkStageRates.size(); stage++){
+       for(unsigned int iter=0; iter<rkStageRates[stage].size(); iter++){
+           delete rkStageRates[stage][iter];
+       }
+   }
+   for(unsigned int iter=0; iter<rkSolutionOld.size(); iter++){
+       delete rkSolutionOld[iter];
+   }
+   for(unsigned int age=0; age<rateHistory.size(); age++){
+       for(unsigned int iter=0; iter<rateHistory[age].size(); iter++){
+           delete rateHistory[age][iter];
+       }
+   }
+   for(unsigned int iter=0; iter<bdfSolutionOld.size(); iter++){
+       delete bdfSolutionOld[iter];
+   }
+   for(unsigned int iter=0; iter<krylovBasis.size(); iter++){
+       delete krylovBasis[iter];
+   }
+   for(unsigned int iter=0; iter<steadyStateSolutionOld.size(); iter++){
+       delete steadyStateSolutionOld[iter];
+   }
+   for(unsigned int slot=0; slot<recoverySnapshots.size(); slot++){
+       for(unsigned int iter=0; iter<recoverySnapshots[slot].size(); iter++){
+           delete recoverySnapshots[slot][iter];
+       }
+   }
 
  }
 
@@ -0,0 +1,348 @@
+// Methods in MatrixFreePDE for the geometric multigrid preconditioner of the ELLIPTIC fields
+
+#include "../../include/matrixFreePDE.h"
+
+// The multigrid preconditioner uses the matrix-free multigrid interfaces of deal.II 9 (GMG is rejected when the
+// parameters are read with older versions)
+#if (DEAL_II_VERSION_MAJOR >= 9)
+
+// The levels of the multigrid hierarchy are the levels of the triangulation (local smoothing), so on an adaptive mesh
+// each level only has the cells of that level, and the DOFs at its refinement edge couple it to the finer cells. The
+// level operators evaluate residualLHS with matrix free objects for each level, with the other fields read by
+// residualLHS interpolated to the levels.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::setupMultigrid(){
+
+    clearMultigrid();
+
+    const unsigned int n_levels = triangulation.n_global_levels();
+
+    // Level DOFs with zero Dirichlet BCs (only for the ELLIPTIC fields, the only ones solved with the preconditioner)
+    // and the transfer between the levels for each field
+    unsigned int starting_BC_list_index = 0;
+    for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+        unsigned int num_components = (fields[fieldIndex].type == SCALAR ? 1 : dim);
+
+        std::shared_ptr<MGConstrainedDoFs> constrained_dofs(new MGConstrainedDoFs);
+        constrained_dofs->initialize(*dofHandlersSet[fieldIndex]);
+        if (fields[fieldIndex].pdetype == ELLIPTIC){
+            for (unsigned int direction = 0; direction < 2*dim; direction++){
+                std::vector<bool> mask(num_components,false);
+                bool any_dirichlet = false;
+                for (unsigned int component=0; component < num_components; component++){
+                    BC_type type = userInputs.BC_list[starting_BC_list_index+component].var_BC_type[direction];
+                    if (type == DIRICHLET || type == NON_UNIFORM_DIRICHLET){
+                        mask[component] = true;
+                        any_dirichlet = true;
+                    }
+                }
+                if (any_dirichlet){
+                    std::set<types::boundary_id> boundary_ids;
+                    boundary_ids.insert(direction);
+                    constrained_dofs->make_zero_boundary_constraints(*dofHandlersSet[fieldIndex], boundary_ids, ComponentMask(mask));
+                }
+            }
+        }
+        mgConstrainedDoFs.push_back(constrained_dofs);
+
+        std::shared_ptr<MGTransferMatrixFree<dim,double> > transfer(new MGTransferMatrixFree<dim,double>(*constrained_dofs));
+        transfer->build(*dofHandlersSet[fieldIndex]);
+        mgTransfers.push_back(transfer);
+
+        starting_BC_list_index += num_components;
+    }
+
+    // Matrix free objects for the levels. The level operators set the rows and columns of the constrained DOFs
+    // themselves, so the other fields are read with their actual values at the boundaries.
+    QGaussLobatto<1> quadrature (degree+1);
+    ConstraintMatrix no_constraints;
+    no_constraints.close();
+    std::vector<const ConstraintMatrix*> level_constraints(fields.size(), &no_constraints);
+
+    typename MatrixFree<dim,double>::AdditionalData additional_data;
+    additional_data.tasks_parallel_scheme = MatrixFree<dim,double>::AdditionalData::none;
+    additional_data.mapping_update_flags = (update_values | update_gradients | update_JxW_values);
+    if (userInputs.need_q_point_locations){
+        additional_data.mapping_update_flags = additional_data.mapping_update_flags | update_quadrature_points;
+    }
+
+    for (unsigned int level=0; level<n_levels; level++){
+        additional_data.level_mg_handler = level;
+        std::shared_ptr<MatrixFree<dim,double> > level_matrix_free(new MatrixFree<dim,double>);
+        level_matrix_free->reinit(dofHandlersSet, level_constraints, quadrature, additional_data);
+        mgMatrixFree.push_back(level_matrix_free);
+
+        mgThreadLocalContainersLHS.push_back(std::shared_ptr<dealii::Threads::ThreadLocalStorage<variableContainerPtr> >(new dealii::Threads::ThreadLocalStorage<variableContainerPtr>));
+
+        std::vector<vectorType*> level_solutions(fields.size(), NULL);
+        for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+            if (userInputs.varInfoListLHS[fieldIndex].var_needed){
+                level_solutions[fieldIndex] = new vectorType;
+                level_matrix_free->initialize_dof_vector(*level_solutions[fieldIndex], fieldIndex);
+            }
+        }
+        mgLevelSolutionSet.push_back(level_solutions);
+    }
+
+    mgLevelSrc.resize(0, n_levels-1);
+    mgLevelDst.resize(0, n_levels-1);
+    mgLevelOperators.resize(0, n_levels-1);
+    mgInterfaceOperators.resize(0, n_levels-1);
+    mgConstrainedIndices.resize(n_levels);
+    mgEdgeIndices.resize(n_levels);
+
+    pcout << "multigrid levels: " << n_levels << std::endl;
+}
+
+// The V-cycle refers to the level objects, so it goes first
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::clearMultigrid(){
+    mgPreconditioner.reset();
+    mgPreconditionerFieldIndex = numbers::invalid_unsigned_int;
+    mgMultigrid.reset();
+    mgCoarse.clear();
+    mgSmoother.clear();
+    mgMatrix.reset();
+    mgInterfaceMatrix.reset();
+
+    for (unsigned int level=0; level<mgLevelSolutionSet.size(); level++){
+        for(unsigned int fieldIndex=0; fieldIndex<mgLevelSolutionSet[level].size(); fieldIndex++){
+            delete mgLevelSolutionSet[level][fieldIndex];
+        }
+    }
+    mgLevelSolutionSet.clear();
+    mgThreadLocalContainersLHS.clear();
+    mgMatrixFree.clear();
+    mgTransfers.clear();
+    mgConstrainedDoFs.clear();
+}
+
+// Everything but the level matrix free objects and the transfers is built for one field at a time. Like the diagonal of
+// the Jacobi and Chebyshev preconditioners, the V-cycle is only rebuilt after the mesh changes, when the solves switch
+// to another field, or before every solve if "Recompute preconditioner diagonal every solve" is set (for level
+// operators whose coefficients change with the other fields read by residualLHS or the time).
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::updateMultigridPreconditioner(){
+
+    const unsigned int fieldIndex = currentFieldIndex;
+    if (mgPreconditioner && mgPreconditionerFieldIndex == fieldIndex && lhsDiagonalValid[fieldIndex] && !userInputs.recompute_preconditioner_diagonal){
+        return;
+    }
+
+    computing_timer.enter_section("matrixFreePDE: multigrid setup");
+
+    const unsigned int max_level = mgMatrixFree.size()-1;
+
+    mgPreconditioner.reset();
+    mgMultigrid.reset();
+
+    // Interpolate the other fields read by residualLHS to the levels
+    syncSinglePrecisionFields();
+    for(unsigned int otherFieldIndex=0; otherFieldIndex<fields.size(); otherFieldIndex++){
+        if (otherFieldIndex == fieldIndex || mgLevelSolutionSet[0][otherFieldIndex] == NULL){
+            continue;
+        }
+        MGLevelObject<vectorType> level_values(0, max_level);
+        mgTransfers[otherFieldIndex]->interpolate_to_mg(*dofHandlersSet[otherFieldIndex], level_values, *solutionSet[otherFieldIndex]);
+        for (unsigned int level=0; level<=max_level; level++){
+            vectorType & level_solution = *mgLevelSolutionSet[level][otherFieldIndex];
+            for (unsigned int i=0; i<level_solution.local_size(); ++i){
+                level_solution.local_element(i) = level_values[level].local_element(i);
+            }
+            level_solution.update_ghost_values();
+        }
+    }
+
+    MGLevelObject<typename mgSmootherType::AdditionalData> smoother_data(0, max_level);
+    for (unsigned int level=0; level<=max_level; level++){
+        mgMatrixFree[level]->initialize_dof_vector(mgLevelSrc[level], fieldIndex);
+        mgMatrixFree[level]->initialize_dof_vector(mgLevelDst[level], fieldIndex);
+
+        // Local indices of the locally owned DOFs on the Dirichlet boundaries or at the refinement edge
+        const IndexSet & owned_dofs = dofHandlersSet[fieldIndex]->locally_owned_mg_dofs(level);
+        const IndexSet & boundary_dofs = mgConstrainedDoFs[fieldIndex]->get_boundary_indices(level);
+        const IndexSet & edge_dofs = mgConstrainedDoFs[fieldIndex]->get_refinement_edge_indices(level);
+        mgConstrainedIndices[level].clear();
+        mgEdgeIndices[level].clear();
+        for (unsigned int i=0; i<owned_dofs.n_elements(); ++i){
+            const types::global_dof_index dof = owned_dofs.nth_index_in_set(i);
+            if (boundary_dofs.is_element(dof)){
+                mgConstrainedIndices[level].push_back(i);
+            }
+            else if (edge_dofs.is_element(dof)){
+                mgConstrainedIndices[level].push_back(i);
+                mgEdgeIndices[level].push_back(i);
+            }
+        }
+
+        mgLevelOperators[level].initialize(this, level);
+        mgInterfaceOperators[level].initialize(this, level);
+
+        // Chebyshev smoother preconditioned with the inverse of the diagonal. On the coarsest level, it is iterated
+        // until the residual is reduced by the smoothing range, as the coarse solver.
+        smoother_data[level].preconditioner.reset(new DiagonalMatrix<vectorType>());
+        computeLevelInverseDiagonal(level, smoother_data[level].preconditioner->get_vector());
+        if (level > 0){
+            smoother_data[level].smoothing_range = userInputs.mg_smoothing_range;
+            smoother_data[level].degree = userInputs.mg_smoother_degree;
+            smoother_data[level].eig_cg_n_iterations = userInputs.eigenvalue_estimate_iterations;
+        }
+        else {
+            smoother_data[level].smoothing_range = 1.0e-3;
+            smoother_data[level].degree = numbers::invalid_unsigned_int;
+            smoother_data[level].eig_cg_n_iterations = mgLevelOperators[level].m();
+        }
+    }
+
+    mgMatrix.initialize(mgLevelOperators);
+    mgInterfaceMatrix.initialize(mgInterfaceOperators);
+    mgSmoother.initialize(mgLevelOperators, smoother_data);
+    mgCoarse.initialize(mgSmoother);
+
+    mgMultigrid.reset(new Multigrid<vectorType>(mgMatrix, mgCoarse, *mgTransfers[fieldIndex], mgSmoother, mgSmoother, 0, max_level));
+    mgMultigrid->set_edge_matrices(mgInterfaceMatrix, mgInterfaceMatrix);
+    mgPreconditioner.reset(new PreconditionMG<dim,vectorType,MGTransferMatrixFree<dim,double> >(*dofHandlersSet[fieldIndex], *mgMultigrid, *mgTransfers[fieldIndex]));
+    mgPreconditionerFieldIndex = fieldIndex;
+    lhsDiagonalValid[fieldIndex] = true;
+
+    computing_timer.exit_section("matrixFreePDE: multigrid setup");
+}
+
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::levelCellLoop(const unsigned int level) const {
+    mgLevelSrc[level].update_ghost_values();
+    mgLevelDst[level] = 0.0;
+    mgCurrentLevel = level;
+    mgMatrixFree[level]->cell_loop(&MatrixFreePDE<dim,degree>::getLHS, this, mgLevelDst[level], mgLevelSrc[level]);
+}
+
+// The vectors of the V-cycle come from the transfer, which has fewer ghost DOFs than the level matrix free object, so
+// the locally owned values are copied to and from the work vectors for the cell loop. With add, the result is added
+// to dst straight from the work vector, so vmult_add doesn't need a temporary vector.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::applyLevelLHS(const unsigned int level, vectorType & dst, const vectorType & src, const bool add) const {
+
+    vectorType & level_src = mgLevelSrc[level];
+    const vectorType & level_dst = mgLevelDst[level];
+    const std::vector<unsigned int> & constrained = mgConstrainedIndices[level];
+
+    for (unsigned int i=0; i<level_src.local_size(); ++i){
+        level_src.local_element(i) = src.local_element(i);
+    }
+    for (unsigned int k=0; k<constrained.size(); ++k){
+        level_src.local_element(constrained[k]) = 0.0;
+    }
+
+    levelCellLoop(level);
+
+    if (add){
+        for (unsigned int i=0; i<level_dst.local_size(); ++i){
+            dst.local_element(i) += level_dst.local_element(i);
+        }
+        for (unsigned int k=0; k<constrained.size(); ++k){
+            dst.local_element(constrained[k]) += src.local_element(constrained[k]);
+        }
+    }
+    else {
+        for (unsigned int i=0; i<level_dst.local_size(); ++i){
+            dst.local_element(i) = level_dst.local_element(i);
+        }
+        for (unsigned int k=0; k<constrained.size(); ++k){
+            dst.local_element(constrained[k]) = src.local_element(constrained[k]);
+        }
+    }
+}
+
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::applyLevelInterface(const unsigned int level, vectorType & dst, const vectorType & src, const bool to_edge, const bool add) const {
+
+    vectorType & level_src = mgLevelSrc[level];
+    const vectorType & level_dst = mgLevelDst[level];
+    const std::vector<unsigned int> & constrained = mgConstrainedIndices[level];
+    const std::vector<unsigned int> & edge = mgEdgeIndices[level];
+
+    if (to_edge){
+        for (unsigned int i=0; i<level_src.local_size(); ++i){
+            level_src.local_element(i) = src.local_element(i);
+        }
+        for (unsigned int k=0; k<constrained.size(); ++k){
+            level_src.local_element(constrained[k]) = 0.0;
+        }
+    }
+    else {
+        level_src = 0.0;
+        for (unsigned int k=0; k<edge.size(); ++k){
+            level_src.local_element(edge[k]) = src.local_element(edge[k]);
+        }
+    }
+
+    levelCellLoop(level);
+
+    // Only the edge rows (to_edge) or the other rows are nonzero, so with add only those are added to dst
+    if (to_edge){
+        if (!add){
+            dst = 0.0;
+        }
+        for (unsigned int k=0; k<edge.size(); ++k){
+            dst.local_element(edge[k]) += level_dst.local_element(edge[k]);
+        }
+    }
+    else {
+        // The constrained indices are in increasing order
+        unsigned int next_constrained = 0;
+        for (unsigned int i=0; i<level_dst.local_size(); ++i){
+            if (next_constrained < constrained.size() && constrained[next_constrained] == i){
+                if (!add){
+                    dst.local_element(i) = 0.0;
+                }
+                next_constrained++;
+            }
+            else if (add){
+                dst.local_element(i) += level_dst.local_element(i);
+            }
+            else {
+                dst.local_element(i) = level_dst.local_element(i);
+            }
+        }
+    }
+}
+
+// The constrained DOFs have unit diagonal entries, as in applyLevelLHS
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::computeLevelInverseDiagonal(const unsigned int level, vectorType & inverse_diagonal) const {
+
+    mgMatrixFree[level]->initialize_dof_vector(inverse_diagonal, currentFieldIndex);
+    mgCurrentLevel = level;
+    mgMatrixFree[level]->cell_loop(&MatrixFreePDE<dim,degree>::getLHSDiagonal, this, inverse_diagonal, mgLevelSrc[level]);
+
+    const std::vector<unsigned int> & constrained = mgConstrainedIndices[level];
+    for (unsigned int k=0; k<constrained.size(); ++k){
+        inverse_diagonal.local_element(constrained[k]) = 1.0;
+    }
+    for (unsigned int i=0; i<inverse_diagonal.local_size(); ++i){
+        const double diagonal = inverse_diagonal.local_element(i);
+        inverse_diagonal.local_element(i) = (diagonal > 0.0 ? 1.0/diagonal : 1.0);
+    }
+}
+
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::applyMultigridPreconditioner(vectorType & dst, const vectorType & src) const {
+
+    computing_timer.enter_section("matrixFreePDE: multigrid V-cycle");
+
+    mgPreconditioner->vmult(dst, src);
+
+    // The solution increment is zero at the hanging node and Dirichlet DOFs
+    constraintsOtherSet[currentFieldIndex]->set_zero(dst);
+    for (std::map<types::global_dof_index, double>::const_iterator it=valuesDirichletSet[currentFieldIndex]->begin(); it!=valuesDirichletSet[currentFieldIndex]->end(); ++it){
+        if (dst.in_local_range(it->first)){
+            dst(it->first) = 0.0;
+        }
+    }
+
+    computing_timer.exit_section("matrixFreePDE: multigrid V-cycle");
+}
+
+#endif
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
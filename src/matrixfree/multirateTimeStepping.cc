@@ -0,0 +1,156 @@
+// Methods in MatrixFreePDE for multirate time stepping, where fields with subcycling steps take several forward Euler
+// substeps in each time step
+
+#include "../../include/matrixFreePDE.h"
+
+// Explicit update of a field with subcycling steps. The residual is written for a step of dtValue, so a substep of
+// dtValue/(number of substeps) is taken along the same direction. Returns the l2 norm of the new solution.
+template <int dim, int degree>
+double MatrixFreePDE<dim,degree>::subcycledUpdate(const unsigned int fieldIndex){
+
+	const double step_ratio = explicitStepRatio;
+	explicitStepRatio = step_ratio/userInputs.var_subcycling_steps[fieldIndex];
+	const double solution_norm = explicitUpdate(fieldIndex);
+	explicitStepRatio = step_ratio;
+
+	return solution_norm;
+}
+
+// Trace residualRHS with only the residuals of the subcycled fields needed (residualNeeded is false for the others). If
+// it then only sets the residuals of the subcycled fields, the substeps can use containers that only read and evaluate
+// what those residuals use and don't integrate anything else. Otherwise the substeps use the full containers.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::initSubcycleVariableNeeds(){
+
+	varInfoListRHSSubcycle.clear();
+
+	dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc;
+	for (unsigned int d=0; d<dim; d++){
+		q_point_loc(d) = 0.0;
+	}
+
+	rhsFieldSubset.assign(fields.size(),false);
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		rhsFieldSubset[fieldIndex] = (userInputs.var_subcycling_steps[fieldIndex] > 1);
+	}
+	variableContainerTrace<dim,degree> trace(userInputs.varInfoListRHS);
+	const bool traced = traceResidualRHS(trace,q_point_loc);
+	const std::vector<bool> subcycled = rhsFieldSubset;
+	rhsFieldSubset.clear();
+
+	if (!traced){
+		pcout << "Note: residualRHS can't be traced, so the substeps of the subcycled fields read and evaluate all of the fields.\n";
+		return;
+	}
+	for (unsigned int i=0; i<fields.size(); i++){
+		if (!subcycled[i] && (trace.traced_value_residual[i] || trace.traced_gradient_residual[i])){
+			pcout << "Note: residualRHS sets the residual of variable '" << userInputs.var_name[i] << "' in the substeps of the subcycled fields, so the substeps read and evaluate all of the fields. Check this->residualNeeded(" << i << ") in residualRHS to skip it.\n";
+			return;
+		}
+	}
+
+	// The subcycled fields keep their attributes, the others are only read for the values/derivatives that the
+	// subcycled residuals use and aren't integrated
+	varInfoListRHSSubcycle = userInputs.varInfoListRHS;
+	unsigned int scalar_var_index = 0;
+	unsigned int vector_var_index = 0;
+	unsigned int num_fields_read = 0;
+	for (unsigned int i=0; i<varInfoListRHSSubcycle.size(); i++){
+		variable_info & varInfo = varInfoListRHSSubcycle[i];
+
+		if (!subcycled[i]){
+			varInfo.need_value = varInfo.need_value && trace.traced_value[i];
+			varInfo.need_gradient = varInfo.need_gradient && trace.traced_gradient[i];
+			varInfo.need_hessian = varInfo.need_hessian && trace.traced_hessian[i];
+			varInfo.value_residual = false;
+			varInfo.gradient_residual = false;
+			varInfo.var_needed = varInfo.need_value || varInfo.need_gradient || varInfo.need_hessian;
+		}
+
+		if (varInfo.var_needed){
+			if (varInfo.is_scalar){
+				varInfo.scalar_or_vector_index = scalar_var_index;
+				scalar_var_index++;
+			}
+			else {
+				varInfo.scalar_or_vector_index = vector_var_index;
+				vector_var_index++;
+			}
+			num_fields_read++;
+		}
+	}
+	pcout << "multirate substeps: " << num_fields_read << " of " << fields.size() << " fields read, only the residuals of the subcycled fields evaluated\n";
+}
+
+// Remaining substeps of the fields with subcycling steps. Every field took its first substep (or its full step) in
+// solveIncrement() with the residuals at the start of the time step. The time step is then divided into the largest
+// number of substeps, and a field with n substeps is updated at every (largest number)/n of them. In each substep the
+// residuals are evaluated with the current values of all of the fields (the slower fields are already at the end of
+// the time step), but only the residuals of the fields being updated are integrated and distributed. If residualRHS
+// skips the residuals of the other fields when residualNeeded is false for them, the substeps use the containers
+// built by initSubcycleVariableNeeds, which only read and evaluate the values/derivatives the subcycled residuals use.
+// Otherwise all of the fields are read and evaluated and each substep costs about as much as a full time step.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::solveSubcycles(){
+
+	char buffer[200];
+	const unsigned int max_steps = userInputs.max_subcycling_steps;
+
+	std::vector<double> solution_norms(fields.size(),0.0);
+
+	rhsFieldSubset.assign(fields.size(),false);
+	for (unsigned int substep=1; substep<max_steps; substep++){
+
+		bool fields_due = false;
+		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+			const unsigned int steps = userInputs.var_subcycling_steps[fieldIndex];
+			rhsFieldSubset[fieldIndex] = (steps > 1 && substep%(max_steps/steps) == 0);
+			fields_due = fields_due || rhsFieldSubset[fieldIndex];
+		}
+		if (!fields_due){
+			continue;
+		}
+
+		rhsUsesSubcycleContainers = !varInfoListRHSSubcycle.empty();
+		computeRHS();
+		rhsUsesSubcycleContainers = false;
+
+		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+			if (!rhsFieldSubset[fieldIndex]){
+				continue;
+			}
+			solution_norms[fieldIndex] = subcycledUpdate(fieldIndex);
+
+			//check if solution is nan
+			if (!numbers::is_finite(solution_norms[fieldIndex])){
+				// With blow-up recovery, the time loop restores the last snapshot and retries with a smaller time step
+				if (userInputs.blowup_recovery_snapshots > 0){
+					sprintf(buffer, "field '%s' solution is NAN.\n", fields[fieldIndex].name.c_str());
+					pcout<<buffer;
+					solutionBlowUp = true;
+					rhsFieldSubset.clear();
+					return;
+				}
+				sprintf(buffer, "ERROR: field '%s' solution is NAN. exiting.\n\n",
+				fields[fieldIndex].name.c_str());
+				pcout<<buffer;
+				exit(-1);
+			}
+		}
+	}
+	rhsFieldSubset.clear();
+
+	if (currentIncrement%userInputs.skip_print_steps==0){
+		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+			if (userInputs.var_subcycling_steps[fieldIndex] > 1){
+				sprintf(buffer, "field '%2s' [subcycled solve]: substeps: %u, current solution: %12.6e\n", \
+				fields[fieldIndex].name.c_str(),				\
+				userInputs.var_subcycling_steps[fieldIndex],	\
+				solution_norms[fieldIndex]);
+				pcout<<buffer;
+			}
+		}
+	}
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
@@ -17,6 +17,7 @@ void MatrixFreePDE<dim,degree>::updateNucleiList() {
             computing_timer.enter_section("matrixFreePDE: nucleation");
 
             // Apply constraints
+            syncSinglePrecisionFields();
             for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
                 constraintsDirichletSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
                 constraintsOtherSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
@@ -53,7 +53,7 @@ void MatrixFreePDE<dim,degree>::outputResults() {
           }
           output_file.precision(10);
 
-          if (Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0){
+          if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0){
               output_file << currentTime;
           }
 
@@ -62,12 +62,12 @@ void MatrixFreePDE<dim,degree>::outputResults() {
                   double integrated_field;
                   computeIntegral(integrated_field,i,postProcessedSet);
                   pcout << "Integrated value of " << userInputs.pp_var_name[userInputs.integrated_field_indices[i]] << ": " << integrated_field << std::endl;
-                  if (Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0){
+                  if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0){
                       output_file << "\t" << userInputs.pp_var_name[userInputs.integrated_field_indices[i]] << "\t" << integrated_field;
                   }
               }
           }
-          if (Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0){
+          if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0){
               output_file << std::endl;
           }
           output_file.close();
@@ -104,7 +104,7 @@ void MatrixFreePDE<dim,degree>::outputResults() {
   cycleAsString << std::setw(std::floor(std::log10(userInputs.totalIncrements))+1) << std::setfill('0') << currentIncrement;
   char baseFileName[100], vtuFileName[100];
   sprintf(baseFileName, "%s-%s", userInputs.output_file_name.c_str(), cycleAsString.str().c_str());
-  sprintf(vtuFileName, "%s.%u.%s", baseFileName,Utilities::MPI::this_mpi_process(MPI_COMM_WORLD),userInputs.output_file_type.c_str());
+  sprintf(vtuFileName, "%s.%u.%s", baseFileName,Utilities::MPI::this_mpi_process(mpi_communicator),userInputs.output_file_type.c_str());
 
   // Write to file in either vtu or vtk format
   if (userInputs.output_file_type == "vtu"){
@@ -122,9 +122,9 @@ void MatrixFreePDE<dim,degree>::outputResults() {
           data_out.write_vtu (output);
 
           // Create pvtu record that can be used to stitch together the results from all the processes
-          if (Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0){
+          if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0){
             std::vector<std::string> filenames;
-            for (unsigned int i=0;i<Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD); ++i) {
+            for (unsigned int i=0;i<Utilities::MPI::n_mpi_processes (mpi_communicator); ++i) {
             	char vtuProcFileName[100];
             	sprintf(vtuProcFileName, "%s-%s.%u.%s", userInputs.output_file_name.c_str(),cycleAsString.str().c_str(),i,userInputs.output_file_type.c_str());
             	filenames.push_back (vtuProcFileName);
@@ -142,7 +142,7 @@ void MatrixFreePDE<dim,degree>::outputResults() {
           // Write the results to a file shared between all processes
           char svtuFileName[100];
           sprintf(svtuFileName, "%s.%s", baseFileName ,userInputs.output_file_type.c_str());
-          data_out.write_vtu_in_parallel(svtuFileName, MPI_COMM_WORLD);
+          data_out.write_vtu_in_parallel(svtuFileName, mpi_communicator);
           pcout << "Output written to:" << svtuFileName << "\n\n";
       }
   }
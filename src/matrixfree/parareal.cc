@@ -0,0 +1,229 @@
+// Methods in MatrixFreePDE for parallel-in-time integration with Parareal
+
+#include "../../include/matrixFreePDE.h"
+
+// With Parareal, the processes are split into groups of consecutive ranks, one for each time slice, and each group
+// solves the spatial problem for its slice with its own communicator
+template <int dim, int degree>
+MPI_Comm MatrixFreePDE<dim,degree>::pararealCommunicator(const userInputParameters<dim> & inputs){
+    if (inputs.parareal_time_slices <= 1){
+        return MPI_COMM_WORLD;
+    }
+    const unsigned int world_rank = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    const unsigned int ranks_per_slice = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD)/inputs.parareal_time_slices;
+
+    MPI_Comm slice_communicator;
+    MPI_Comm_split(MPI_COMM_WORLD, world_rank/ranks_per_slice, world_rank, &slice_communicator);
+    return slice_communicator;
+}
+
+// The part of the solution owned by this process, for all of the fields one after the other. The DOFs constrained to
+// other DOFs (hanging nodes, periodic slaves) are only set by distribute at the outputs, so they are stored as zero and
+// don't enter the Parareal corrections or the convergence norm.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::getPararealState(std::vector<double> & state) const {
+    state.clear();
+    for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+        const vectorType & solution = *solutionSet[fieldIndex];
+        for (unsigned int i=0; i<solution.local_size(); ++i){
+            if (constraintsOtherSet[fieldIndex]->is_constrained(solution.get_partitioner()->local_to_global(i))){
+                state.push_back(0.0);
+            }
+            else {
+                state.push_back(solution.local_element(i));
+            }
+        }
+    }
+}
+
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::setPararealState(const std::vector<double> & state){
+    unsigned int j = 0;
+    for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+        vectorType & solution = *solutionSet[fieldIndex];
+        for (unsigned int i=0; i<solution.local_size(); ++i){
+            solution.local_element(i) = state[j++];
+        }
+        solution.update_ghost_values();
+    }
+}
+
+// Fine propagator: the usual time steps of size dtValue. Coarse propagator: the same number of steps divided by the
+// coarse time step factor (rounded up), each a single BDF1 or forward Euler step of the same mesh.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::pararealPropagate(const unsigned int first_increment, const unsigned int last_increment, const bool coarse, const bool write_output){
+
+    if (coarse){
+        const unsigned int n_fine = last_increment - first_increment;
+        const unsigned int n_coarse = (n_fine + userInputs.parareal_coarse_factor - 1)/userInputs.parareal_coarse_factor;
+        const double step_ratio = (double)n_fine/n_coarse;
+
+        explicitStepRatio = step_ratio;
+        for (unsigned int step=1; step<=n_coarse; ++step){
+            currentIncrement = first_increment + (unsigned int)(step*step_ratio + 0.5);
+            currentTime = (first_increment + step*step_ratio)*userInputs.dtValue;
+
+            if (userInputs.parareal_coarse_bdf){
+                // Same splitting of the local reaction terms as in solveIncrement
+                if (userInputs.local_reaction_splitting){
+                    integrateLocalReactions(0.5*step_ratio*userInputs.dtValue);
+                }
+                bdfUpdate();
+                if (userInputs.local_reaction_splitting){
+                    integrateLocalReactions(0.5*step_ratio*userInputs.dtValue);
+                }
+            }
+            else {
+                solveIncrement();
+            }
+        }
+        explicitStepRatio = 1.0;
+        return;
+    }
+
+    if (write_output){
+        currentOutput = 0;
+        while (currentOutput < userInputs.outputTimeStepList.size() && userInputs.outputTimeStepList[currentOutput] <= first_increment){
+            currentOutput++;
+        }
+    }
+
+    for (currentIncrement=first_increment+1; currentIncrement<=last_increment; ++currentIncrement){
+        currentTime = currentIncrement*userInputs.dtValue;
+        if (write_output && currentIncrement%userInputs.skip_print_steps==0){
+            pcout << "\ntime increment:" << currentIncrement << "  time: " << currentTime << "\n";
+        }
+
+        solveIncrement();
+
+        if (write_output && currentOutput < userInputs.outputTimeStepList.size() && userInputs.outputTimeStepList[currentOutput] == currentIncrement) {
+            for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+                constraintsDirichletSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
+                constraintsOtherSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
+                solutionSet[fieldIndex]->update_ghost_values();
+            }
+            outputResults();
+            currentOutput++;
+        }
+    }
+    currentIncrement = last_increment;
+}
+
+// Parareal iterations. With the solution U_s^k at the start of slice s after iteration k, the fine propagator F and the
+// coarse propagator G, the solution at the start of the next slice is updated with
+//   U_{s+1}^{k+1} = G(U_s^{k+1}) + F(U_s^k) - G(U_s^k)
+// The fine propagations of all of the slices run at the same time, and only the (much cheaper) coarse propagations are
+// sequential, passed from one slice to the next. After k iterations the first k slices have the same solution as the
+// sequential time loop, so at most one iteration per slice is needed, and the iterations stop earlier once the change
+// in the solution at the end of every slice is below the Parareal tolerance (relative to the norm of the solution). The
+// output is written by a final fine propagation of each slice from its converged starting solution.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::solveParareal(){
+
+    const unsigned int num_slices = userInputs.parareal_time_slices;
+    const unsigned int world_rank = Utilities::MPI::this_mpi_process(MPI_COMM_WORLD);
+    const unsigned int ranks_per_slice = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD)/num_slices;
+    const unsigned int slice = world_rank/ranks_per_slice;
+    const bool has_previous = (slice > 0);
+    const bool has_next = (slice+1 < num_slices);
+
+    // The processes with the same rank in neighboring slices own the same DOFs
+    const int previous_rank = world_rank - ranks_per_slice;
+    const int next_rank = world_rank + ranks_per_slice;
+
+    const unsigned int first_increment = (slice*userInputs.totalIncrements)/num_slices;
+    const unsigned int last_increment = ((slice+1)*userInputs.totalIncrements)/num_slices;
+
+    pcout << "\nParareal: " << num_slices << " time slices with " << ranks_per_slice << " processes each, coarse time step factor: " << userInputs.parareal_coarse_factor << ", coarse scheme: " << (userInputs.parareal_coarse_bdf ? "BDF1" : "forward Euler") << "\n";
+
+    // The initial conditions are output by the first slice
+    if (slice == 0 && userInputs.outputTimeStepList.size() > 0 && userInputs.outputTimeStepList[0] == 0){
+        for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+            constraintsDirichletSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
+            constraintsOtherSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
+            solutionSet[fieldIndex]->update_ghost_values();
+        }
+        outputResults();
+    }
+
+    std::vector<double> start_state, coarse_state, fine_state, end_state, new_state;
+    getPararealState(start_state);
+    const int count = start_state.size();
+    bool fine_state_valid = false;
+
+    // Iteration 0: the coarse propagator alone, passed sequentially through the slices
+    if (has_previous){
+        MPI_Recv(&start_state[0], count, MPI_DOUBLE, previous_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    }
+    setPararealState(start_state);
+    pararealPropagate(first_increment, last_increment, true, false);
+    getPararealState(coarse_state);
+    end_state = coarse_state;
+    if (has_next){
+        MPI_Send(&end_state[0], count, MPI_DOUBLE, next_rank, 0, MPI_COMM_WORLD);
+    }
+
+    const unsigned int max_iterations = std::min(userInputs.max_parareal_iterations, num_slices);
+    unsigned int iteration = 1;
+    for (; iteration<=max_iterations; iteration++){
+
+        // Fine propagation from the current starting solution (if it has changed since the last one)
+        if (!fine_state_valid){
+            setPararealState(start_state);
+            pararealPropagate(first_increment, last_increment, false, false);
+            getPararealState(fine_state);
+            fine_state_valid = true;
+        }
+
+        // Coarse correction from the new starting solution of the previous slice
+        new_state = start_state;
+        if (has_previous){
+            MPI_Recv(&new_state[0], count, MPI_DOUBLE, previous_rank, iteration, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+        if (new_state != start_state){
+            start_state.swap(new_state);
+            fine_state_valid = false;
+            setPararealState(start_state);
+            pararealPropagate(first_increment, last_increment, true, false);
+            getPararealState(new_state);
+        }
+        else {
+            new_state = coarse_state;
+        }
+
+        double local_change_sqr = 0.0;
+        double local_norm_sqr = 0.0;
+        for (unsigned int i=0; i<end_state.size(); ++i){
+            const double value = new_state[i] + fine_state[i] - coarse_state[i];
+            local_change_sqr += (value - end_state[i])*(value - end_state[i]);
+            local_norm_sqr += value*value;
+            end_state[i] = value;
+        }
+        coarse_state.swap(new_state);
+
+        if (has_next){
+            MPI_Send(&end_state[0], count, MPI_DOUBLE, next_rank, iteration, MPI_COMM_WORLD);
+        }
+
+        const double change = std::sqrt(Utilities::MPI::sum(local_change_sqr, MPI_COMM_WORLD));
+        const double norm = std::sqrt(Utilities::MPI::sum(local_norm_sqr, MPI_COMM_WORLD));
+        pcout << "Parareal iteration " << iteration << ": change in the solution at the end of the slices: " << change << " (relative: " << change/std::max(norm,1.0e-300) << ")\n";
+
+        if (change <= userInputs.parareal_tolerance*norm){
+            break;
+        }
+    }
+    if (iteration > max_iterations){
+        iteration = max_iterations;
+        if (max_iterations < num_slices){
+            pcout << "\nWarning: Parareal did not converge as per set tolerances. consider increasing the maximum number of Parareal iterations.\n";
+        }
+    }
+    pcout << "Parareal converged after " << iteration << " iterations\n";
+
+    // Final fine propagation of each slice from its converged starting solution, with output
+    setPararealState(start_state);
+    pararealPropagate(first_increment, last_increment, false, true);
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
@@ -29,35 +29,13 @@ void MatrixFreePDE<dim,degree>::getPostProcessedFields(const dealii::MatrixFree<
 		const std::vector<vectorType*> &src,
 		const std::pair<unsigned int,unsigned int> &cell_range) {
 
-	//initialize FEEvaulation objects
-	variableContainer<dim,degree,dealii::VectorizedArray<double> > variable_list(data,userInputs.pp_baseVarInfoList);
-	variableContainer<dim,degree,dealii::VectorizedArray<double> > pp_variable_list(data,userInputs.pp_varInfoList,0);
-
-	//loop over cells
-	for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell){
-
-		// Initialize, read DOFs, and set evaulation flags for each variable
-		variable_list.reinit_and_eval(src, cell);
-		pp_variable_list.reinit(cell);
-
-		unsigned int num_q_points = variable_list.get_num_q_points();
-
-		dealii::AlignedVector<dealii::VectorizedArray<double> > JxW(num_q_points);
-        pp_variable_list.get_JxW(JxW);
-
-		//loop over quadrature points
-		for (unsigned int q=0; q<num_q_points; ++q){
-			variable_list.q_point = q;
-			pp_variable_list.q_point = q;
-
-			dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc = variable_list.get_q_point_location();
-
-			// Calculate the residuals
-			postProcessedFields(variable_list,pp_variable_list,q_point_loc);
-		}
-
-		pp_variable_list.integrate_and_distribute(dst);
-	}
+	// Default cell loop, where postProcessedFields is called through the virtual function table
+	cellLoopPostProcessedFields(data,dst,src,cell_range,
+		[this](const variableContainer<dim,degree,dealii::VectorizedArray<double> > & variable_list,
+			   variableContainer<dim,degree,dealii::VectorizedArray<double> > & pp_variable_list,
+			   const dealii::Point<dim, dealii::VectorizedArray<double> > & q_point_loc){
+			this->postProcessedFields(variable_list,pp_variable_list,q_point_loc);
+		});
 }
 
 #include "../../include/matrixFreePDE_template_instantiations.h"
@@ -26,6 +26,7 @@ if (userInputs.h_adaptivity == true){
 		computing_timer.enter_section("matrixFreePDE: AMR");
 
 		// Apply constraints before remeshing
+		syncSinglePrecisionFields();
 		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
 			constraintsDirichletSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
 			constraintsOtherSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
@@ -133,7 +134,20 @@ for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
 	//(*residualSet[fieldIndex])=(*solutionSet[fieldIndex]);
 	//soltransSet[fieldIndex]->prepare_for_coarsening_and_refinement(*residualSet[fieldIndex]);
 
-	soltransSet[fieldIndex]->prepare_for_coarsening_and_refinement(*solutionSet[fieldIndex]);
+	// The vectors stored by the time integration schemes from previous steps are transferred along with the solution
+	std::vector<vectorType*> history = transferredHistoryVectors(fieldIndex);
+	if (history.size() > 0){
+		std::vector<const vectorType*> transferred_vectors;
+		transferred_vectors.push_back(solutionSet[fieldIndex]);
+		for (unsigned int i=0; i<history.size(); i++){
+			history[i]->update_ghost_values();
+			transferred_vectors.push_back(history[i]);
+		}
+		soltransSet[fieldIndex]->prepare_for_coarsening_and_refinement(transferred_vectors);
+	}
+	else {
+		soltransSet[fieldIndex]->prepare_for_coarsening_and_refinement(*solutionSet[fieldIndex]);
+	}
 }
 triangulation.execute_coarsening_and_refinement();
 
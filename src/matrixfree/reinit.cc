@@ -25,6 +25,12 @@ template <int dim, int degree>
 		 dof_handler=dofHandlersSet_nonconst.at(it->index);
 
 		 dof_handler->distribute_dofs (*fe);
+		 // The multigrid preconditioner also needs the DOFs of each level of the mesh
+	     #if (DEAL_II_VERSION_MAJOR >= 9)
+		 if (userInputs.linear_preconditioner == GMG_PRECONDITIONER){
+			 dof_handler->distribute_mg_dofs();
+		 }
+	     #endif
 		 totalDOFs+=dof_handler->n_dofs();
 
 		 //extract locally_relevant_dofs
@@ -77,17 +83,7 @@ template <int dim, int degree>
  	 pcout << "total DOF : " << totalDOFs << std::endl;
 
  	 // Setup the matrix free object
- 	 typename MatrixFree<dim,double>::AdditionalData additional_data;
-     // The member "mpi_communicator" was removed in deal.II version 8.5 but is required before it
-     #if (DEAL_II_VERSION_MAJOR < 9 && DEAL_II_VERSION_MINOR < 5)
-         additional_data.mpi_communicator = MPI_COMM_WORLD;
-     #endif
- 	 additional_data.tasks_parallel_scheme = MatrixFree<dim,double>::AdditionalData::partition_partition;
-     //additional_data.tasks_block_size = 1; // This improves performance for small runs, not sure about larger runs
- 	 additional_data.mapping_update_flags = (update_values | update_gradients | update_JxW_values | update_quadrature_points);
- 	 QGaussLobatto<1> quadrature (degree+1);
- 	 matrixFreeObject.clear();
- 	 matrixFreeObject.reinit (dofHandlersSet, constraintsOtherSet, quadrature, additional_data);
+ 	 setupMatrixFreeObjects();
 
  	bool dU_scalar_init = false;
  	bool dU_vector_init = false;
@@ -128,7 +124,20 @@ template <int dim, int degree>
  	 for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
 
  		 //interpolate and clear used solution transfer sets
- 		 soltransSet[fieldIndex]->interpolate(*solutionSet[fieldIndex]);
+ 		 std::vector<vectorType*> history = transferredHistoryVectors(fieldIndex);
+ 		 if (history.size() > 0){
+ 			 // The vectors stored by the time integration schemes were transferred along with the solution
+ 			 std::vector<vectorType*> transferred_vectors;
+ 			 transferred_vectors.push_back(solutionSet[fieldIndex]);
+ 			 for (unsigned int i=0; i<history.size(); i++){
+ 				 matrixFreeObject.initialize_dof_vector(*history[i], fieldIndex);
+ 				 transferred_vectors.push_back(history[i]);
+ 			 }
+ 			 soltransSet[fieldIndex]->interpolate(transferred_vectors);
+ 		 }
+ 		 else {
+ 			 soltransSet[fieldIndex]->interpolate(*solutionSet[fieldIndex]);
+ 		 }
  		 delete soltransSet[fieldIndex];
 
  		 //reset residual vector
@@ -136,6 +145,9 @@ template <int dim, int degree>
  		 matrixFreeObject.initialize_dof_vector(*R,  fieldIndex); *R=0;
  	 }
 
+ 	 // Store the locally owned Dirichlet DOFs for the explicit update
+ 	 setLocalDirichletValues();
+
  	 // Create new solution transfer sets
  	 soltransSet.clear();
  	 for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
@@ -154,6 +166,17 @@ template <int dim, int degree>
 		 solutionSet[fieldIndex]->update_ghost_values();
  	 }
 
+ 	 // Update the single precision copies of the fields that are stored in single precision during time stepping
+ 	 initSinglePrecisionFields();
+
+ 	 // Resize the vectors for the selected time integration scheme
+ 	 initTimeIntegrationVectors();
+
+ 	 // Update the stable time step for the new mesh (during initialization this is done once at the end of init())
+ 	 if (userInputs.automatic_time_step && isTimeDependentBVP && currentIncrement > 0){
+ 		 estimateStableTimeStep();
+ 	 }
+
  	 computing_timer.exit_section("matrixFreePDE: reinitialization");
 }
 
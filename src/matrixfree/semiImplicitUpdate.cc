@@ -0,0 +1,78 @@
+// Methods in MatrixFreePDE for the semi-implicit (IMEX) update of PARABOLIC fields with implicit linear terms
+
+#include "../../include/matrixFreePDE.h"
+
+// Diagonal preconditioner for the semi-implicit solves, using the inverse of the lumped mass matrix. It takes care of
+// the variation of the mass matrix with the cell size (on adaptive meshes) and is exact in the limit of a small time step.
+class inverseMassPreconditioner
+{
+public:
+	inverseMassPreconditioner(const vectorType & _invM) : invM(_invM) {}
+
+	void vmult(vectorType & dst, const vectorType & src) const {
+		const unsigned int invM_size = invM.local_size();
+		const unsigned int local_size = src.local_size();
+		for (unsigned int offset=0; offset<local_size; offset+=invM_size){
+			for (unsigned int k=0; k<invM_size; ++k){
+				dst.local_element(offset+k) = invM.local_element(k)*src.local_element(offset+k);
+			}
+		}
+	}
+
+private:
+	const vectorType & invM;
+};
+
+// Semi-implicit update of a PARABOLIC field whose linear terms are implicit. residualRHS gives the explicit part,
+// M*u_n + dt*f(u_n), and residualLHS applies M + dt*K, so (M + dt*K)*u_{n+1} = M*u_n + dt*f(u_n) is solved with CG
+// and the same vmult as the ELLIPTIC fields, starting from the current solution. Returns the l2 norm of the new solution.
+template <int dim, int degree>
+double MatrixFreePDE<dim,degree>::semiImplicitUpdate(const unsigned int fieldIndex){
+
+	char buffer[200];
+
+	vectorType & rhs = *residualSet[fieldIndex];
+	vectorType & solution = *solutionSet[fieldIndex];
+
+	// vmult copies the Dirichlet DOFs from the source vector, so the right hand side holds their values
+	for (unsigned int i=0; i<localDirichletValues[fieldIndex].size(); ++i){
+		rhs.local_element(localDirichletValues[fieldIndex][i].first) = localDirichletValues[fieldIndex][i].second;
+	}
+
+	//solver controls
+	double tol_value;
+	if (userInputs.abs_tol == true){
+		tol_value = userInputs.solver_tolerance;
+	}
+	else {
+		tol_value = userInputs.solver_tolerance*rhs.l2_norm();
+	}
+
+	SolverControl solver_control(userInputs.max_solver_iterations, tol_value);
+	SolverCG<vectorType> solver(solver_control);
+	inverseMassPreconditioner preconditioner(invM);
+
+	// The solution vector is updated in place by the solver, so its ghost values are out of date until the end
+	solution.zero_out_ghosts();
+	try{
+		solver.solve(*this, solution, rhs, preconditioner);
+	}
+	catch (...) {
+		pcout << "\nWarning: semi-implicit solver did not converge as per set tolerances. consider increasing maxSolverIterations or decreasing solverTolerance.\n";
+	}
+	solution.update_ghost_values();
+
+	const double solution_norm = solution.l2_norm();
+
+	if (currentIncrement%userInputs.skip_print_steps==0){
+		sprintf(buffer, "field '%2s' [semi-implicit solve]: current solution: %12.6e, nsteps:%u, tolerance criterion:%12.6e\n", \
+		fields[fieldIndex].name.c_str(),			\
+		solution_norm,								\
+		solver_control.last_step(), solver_control.tolerance());
+		pcout<<buffer;
+	}
+
+	return solution_norm;
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
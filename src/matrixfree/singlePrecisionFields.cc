@@ -0,0 +1,48 @@
+// Methods in MatrixFreePDE for the fields that are stored in single precision during time stepping
+
+#include "../../include/matrixFreePDE.h"
+
+// (Re)initialize the single precision copies of the selected fields from the double precision solution vectors, called
+// whenever the double precision vectors are set outside of the time stepping (initial conditions, checkpoints, remeshing)
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::initSinglePrecisionFields(){
+
+	if (solutionSetFloat.size() != fields.size()){
+		solutionSetFloat.resize(fields.size(),NULL);
+		doubleSolutionOutdated.resize(fields.size(),false);
+	}
+
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		if (userInputs.var_single_precision_storage[fieldIndex]){
+			if (solutionSetFloat[fieldIndex] == NULL){
+				solutionSetFloat[fieldIndex] = new parallel::distributed::Vector<float>;
+			}
+			matrixFreeObject.initialize_dof_vector(*solutionSetFloat[fieldIndex], fieldIndex);
+
+			for (unsigned int dof=0; dof<solutionSet[fieldIndex]->local_size(); ++dof){
+				solutionSetFloat[fieldIndex]->local_element(dof) = solutionSet[fieldIndex]->local_element(dof);
+			}
+			solutionSetFloat[fieldIndex]->update_ghost_values();
+			doubleSolutionOutdated[fieldIndex] = false;
+		}
+	}
+}
+
+// Copy the single precision fields that were updated since the last call back into the double precision solution
+// vectors. Needs to be called before solutionSet is used outside of the residual evaluation (output, checkpoints,
+// remeshing, nucleation).
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::syncSinglePrecisionFields(){
+
+	for(unsigned int fieldIndex=0; fieldIndex<solutionSetFloat.size(); fieldIndex++){
+		if (doubleSolutionOutdated[fieldIndex]){
+			for (unsigned int dof=0; dof<solutionSet[fieldIndex]->local_size(); ++dof){
+				solutionSet[fieldIndex]->local_element(dof) = solutionSetFloat[fieldIndex]->local_element(dof);
+			}
+			solutionSet[fieldIndex]->update_ghost_values();
+			doubleSolutionOutdated[fieldIndex] = false;
+		}
+	}
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
@@ -9,12 +9,17 @@ void MatrixFreePDE<dim,degree>::solve(){
     computing_timer.enter_section("matrixFreePDE: solve");
     pcout << "\nsolving...\n\n";
 
+    //time dependent BVP, with the time slices solved in parallel with Parareal
+    if (isTimeDependentBVP && userInputs.parareal_time_slices > 1){
+        solveParareal();
+    }
     //time dependent BVP
-    if (isTimeDependentBVP){
+    else if (isTimeDependentBVP){
 
         //output initial conditions for time dependent BVP
         if (userInputs.outputTimeStepList[currentOutput] == currentIncrement) {
 
+            syncSinglePrecisionFields();
             for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
                 constraintsDirichletSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
                 constraintsOtherSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
@@ -33,7 +38,15 @@ void MatrixFreePDE<dim,degree>::solve(){
         currentIncrement++;
         
         //time stepping
-        pcout << "\nTime stepping parameters: timeStep: " << userInputs.dtValue << "  timeFinal: " << userInputs.finalTime << "  timeIncrements: " << userInputs.totalIncrements << "\n";
+        if (userInputs.adaptive_time_stepping){
+            pcout << "\nTime stepping parameters: initial timeStep: " << (userInputs.automatic_time_step ? automaticTimeStep() : userInputs.dtValue) << "  timeFinal: " << userInputs.finalTime << "  tolerance: " << userInputs.time_integration_tolerance << "\n";
+        }
+        else if (userInputs.automatic_time_step){
+            pcout << "\nTime stepping parameters: automatic timeStep: " << automaticTimeStep() << "  timeFinal: " << userInputs.finalTime << "\n";
+        }
+        else {
+            pcout << "\nTime stepping parameters: timeStep: " << userInputs.dtValue << "  timeFinal: " << userInputs.finalTime << "  timeIncrements: " << userInputs.totalIncrements << "\n";
+        }
 
         // Cycle up to the proper output and checkpoint counters
         while (userInputs.outputTimeStepList.size() > 0 && userInputs.outputTimeStepList[currentOutput] < currentIncrement){
@@ -43,40 +56,77 @@ void MatrixFreePDE<dim,degree>::solve(){
             currentCheckpoint++;
         }
 
+        // With an adaptive scheme or an automatic time step, the number of increments isn't known in advance and the time loop is separate
+        if (userInputs.adaptive_time_stepping || userInputs.automatic_time_step){
+            solveAdaptiveTimeSteps();
+        }
+        else {
+            for (; currentIncrement<=userInputs.totalIncrements; ++currentIncrement){
+                //increment current time
+                currentTime+=steadyStateStepRatio*userInputs.dtValue;
+                if (currentIncrement%userInputs.skip_print_steps==0){
+                    pcout << "\ntime increment:" << currentIncrement << "  time: " << currentTime << "\n";
+                }
 
-        for (; currentIncrement<=userInputs.totalIncrements; ++currentIncrement){
-            //increment current time
-            currentTime+=userInputs.dtValue;
-            if (currentIncrement%userInputs.skip_print_steps==0){
-                pcout << "\ntime increment:" << currentIncrement << "  time: " << currentTime << "\n";
-            }
+                //check and perform adaptive mesh refinement
+                adaptiveRefine(currentIncrement);
 
-            //check and perform adaptive mesh refinement
-            adaptiveRefine(currentIncrement);
+                // Update the list of nuclei (if relevant)
+                updateNucleiList();
 
-            // Update the list of nuclei (if relevant)
-            updateNucleiList();
+                //solve time increment (going back to the last snapshot if the solution blows up with blow-up recovery)
+                if (userInputs.blowup_recovery_snapshots > 0){
+                    if (!solveRecoverableIncrement()){
+                        continue;
+                    }
+                }
+                else {
+                    explicitStepRatio = steadyStateStepRatio;
+                    solveIncrement();
+                    explicitStepRatio = 1.0;
+                }
 
-            //solve time increment
-            solveIncrement();
+                // Output results to file (on the proper increments)
+                if (userInputs.outputTimeStepList[currentOutput] == currentIncrement) {
+                    syncSinglePrecisionFields();
+                    for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+                        constraintsDirichletSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
+                        constraintsOtherSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
+                        solutionSet[fieldIndex]->update_ghost_values();
+                    }
+                    outputResults();
+                    currentOutput++;
+                }
 
-            // Output results to file (on the proper increments)
-            if (userInputs.outputTimeStepList[currentOutput] == currentIncrement) {
-                for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
-                    constraintsDirichletSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
-                    constraintsOtherSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
-                    solutionSet[fieldIndex]->update_ghost_values();
+                // Create a checkpoint (on the proper increments)
+                if (userInputs.checkpointTimeStepList[currentCheckpoint] == currentIncrement) {
+                    save_checkpoint();
+                    currentCheckpoint++;
                 }
-                outputResults();
-                currentOutput++;
-            }
 
-            // Create a checkpoint (on the proper increments)
-            if (userInputs.checkpointTimeStepList[currentCheckpoint] == currentIncrement) {
-                save_checkpoint();
-                currentCheckpoint++;
-            }
+                // Save a snapshot for blow-up recovery (on the proper increments)
+                if (userInputs.blowup_recovery_snapshots > 0 && currentIncrement%userInputs.blowup_snapshot_interval==0){
+                    saveRecoverySnapshot(currentIncrement, currentTime);
+                }
 
+                // Stop at a steady state (or increase the time step, with the increase_time_step action)
+                if (userInputs.steady_state_tolerance > 0.0 && checkSteadyState()){
+                    break;
+                }
+
+                // With the larger time steps after a steady state, the final time is reached before the last increment
+                if (steadyStateStepRatio > 1.0){
+                    if (currentTime >= userInputs.finalTime*(1.0-1.0e-10)){
+                        break;
+                    }
+                    const double clampedStepRatio = (userInputs.finalTime - currentTime)/userInputs.dtValue;
+                    if (clampedStepRatio < steadyStateStepRatio){
+                        steadyStateStepRatio = clampedStepRatio;
+                        // The previous solution for BDF2 is for the old time step
+                        bdfSolutionOldValid = false;
+                    }
+                }
+            }
         }
     }
 
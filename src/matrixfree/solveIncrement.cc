@@ -11,6 +11,34 @@ void MatrixFreePDE<dim,degree>::solveIncrement(){
     Timer time;
     char buffer[200];
 
+    // The implicit BDF schemes solve for all of the fields together instead of field by field, the ETD schemes evaluate
+    // the residuals at more than one stage, and local time stepping only evaluates the residuals that are needed for the
+    // DOFs updated in this increment
+    if (userInputs.bdf_order > 0 || userInputs.etd_order > 0 || userInputs.local_time_stepping_levels > 1){
+        if (userInputs.bdf_order > 0){
+            bdfUpdate();
+        }
+        else if (userInputs.etd_order > 0){
+            etdUpdate();
+        }
+        else {
+            localTimeSteppingUpdate();
+        }
+
+        if (currentIncrement%userInputs.skip_print_steps==0){
+            pcout << "wall time: " << time.wall_time() << "s\n";
+        }
+        computing_timer.exit_section("matrixFreePDE: solveIncrements");
+        return;
+    }
+
+    // Strang splitting of the local reaction terms: a half step of the reaction terms at each DOF, the full step of the
+    // rest of the equations below, and then another half step of the reaction terms
+    const double reaction_dt = 0.5*explicitStepRatio*userInputs.dtValue;
+    if (userInputs.local_reaction_splitting){
+        integrateLocalReactions(reaction_dt);
+    }
+
     //compute residual vectors
     computeRHS();
 
@@ -18,31 +46,46 @@ void MatrixFreePDE<dim,degree>::solveIncrement(){
     for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
         currentFieldIndex = fieldIndex; // Used in computeLHS()
 
+        // The norm of the new solution, used to check for NaNs (computed by explicitUpdate for parabolic fields)
+        double solution_norm = 0.0;
+
         // Add Neumann BC terms to the residual vector for the current field, if appropriate
         // Currently commented out because it isn't working yet
         //applyNeumannBCs();
 
+        //Parabolic fields with implicit linear terms
+        if (fields[fieldIndex].pdetype==PARABOLIC && userInputs.var_implicit_linear_terms[fieldIndex]){
+
+            // Solve for the new solution with the implicit terms from residualLHS
+            solution_norm = semiImplicitUpdate(fieldIndex);
+        }
         //Parabolic (first order derivatives in time) fields
-        if (fields[fieldIndex].pdetype==PARABOLIC){
-
-            // Explicit-time step each DOF
-            // Takes advantage of knowledge that the length of solutionSet and residualSet is an integer multiple of the length of invM for vector variables
-            unsigned int invM_size = invM.local_size();
-            for (unsigned int dof=0; dof<solutionSet[fieldIndex]->local_size(); ++dof){
-                solutionSet[fieldIndex]->local_element(dof)=			\
-                invM.local_element(dof%invM_size)*residualSet[fieldIndex]->local_element(dof);
+        else if (fields[fieldIndex].pdetype==PARABOLIC){
+
+            // The residual is overwritten by the update, so get its norm first if it is going to be printed
+            double residual_norm = 0.0;
+            if (currentIncrement%userInputs.skip_print_steps==0){
+                residual_norm = residualSet[fieldIndex]->l2_norm();
             }
 
-            // Set the Dirichelet values (hanging node constraints don't need to be distributed every time step, only at output)
-            constraintsDirichletSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
-            solutionSet[fieldIndex]->update_ghost_values();
+            // Explicit-time step each DOF and set the Dirichlet values in a single pass, then swap the solution and residual vectors
+            // (the multistep schemes update the solution in place, combining the rate with the ones from previous steps)
+            if (userInputs.multistep_order > 0){
+                solution_norm = multistepUpdate(fieldIndex);
+            }
+            else if (userInputs.var_subcycling_steps[fieldIndex] > 1){
+                solution_norm = subcycledUpdate(fieldIndex);
+            }
+            else {
+                solution_norm = explicitUpdate(fieldIndex);
+            }
 
             // Print update to screen
             if (currentIncrement%userInputs.skip_print_steps==0){
                 sprintf(buffer, "field '%2s' [explicit solve]: current solution: %12.6e, current residual:%12.6e\n", \
                 fields[fieldIndex].name.c_str(),				\
-                solutionSet[fieldIndex]->l2_norm(),			\
-                residualSet[fieldIndex]->l2_norm());
+                solution_norm,			\
+                residual_norm);
                 pcout<<buffer;
             }
         }
@@ -71,18 +114,34 @@ void MatrixFreePDE<dim,degree>::solveIncrement(){
 
             SolverControl solver_control(userInputs.max_solver_iterations, tol_value);
 
-            // Currently the only allowed solver is SolverCG, the SolverType input variable is a dummy
-            SolverCG<vectorType> solver(solver_control);
+            // Currently the only allowed solver is CG, the SolverType input variable is a dummy. With recycled Krylov
+            // vectors, they are deflated from the CG iterations and updated at the end of the solve.
+            SolverRecycledCG<vectorType> solver(solver_control, recycledKrylovVectors[fieldIndex], userInputs.recycled_krylov_vectors);
 
-            //solve
+            //solve (the V-cycle of the multigrid preconditioner, set up at the current solution, and the diagonal for the
+            //Jacobi and Chebyshev preconditioners are computed first if they are out of date)
             try{
-                if (fields[fieldIndex].type == SCALAR){
-                    dU_scalar=0.0;
-                    solver.solve(*this, dU_scalar, *residualSet[fieldIndex], IdentityMatrix(solutionSet[fieldIndex]->size()));
+                vectorType & dU = (fields[fieldIndex].type == SCALAR ? dU_scalar : dU_vector);
+                ellipticInitialGuess(fieldIndex, dU);
+                #if (DEAL_II_VERSION_MAJOR >= 9)
+                if (userInputs.linear_preconditioner == GMG_PRECONDITIONER){
+                    updateMultigridPreconditioner();
+                    solver.solve(*this, dU, *residualSet[fieldIndex], gmgPreconditioner(*this));
+                }
+                else
+                #endif
+                if (userInputs.linear_preconditioner == JACOBI_PRECONDITIONER){
+                    updateDiagonalPreconditioner();
+                    solver.solve(*this, dU, *residualSet[fieldIndex], *lhsInverseDiagonal[fieldIndex]);
                 }
+                #if (DEAL_II_VERSION_MAJOR >= 9)
+                else if (userInputs.linear_preconditioner == CHEBYSHEV_PRECONDITIONER){
+                    updateDiagonalPreconditioner();
+                    solver.solve(*this, dU, *residualSet[fieldIndex], *chebyshevPreconditioners[fieldIndex]);
+                }
+                #endif
                 else {
-                    dU_vector=0.0;
-                    solver.solve(*this, dU_vector, *residualSet[fieldIndex], IdentityMatrix(solutionSet[fieldIndex]->size()));
+                    solver.solve(*this, dU, *residualSet[fieldIndex], IdentityMatrix(solutionSet[fieldIndex]->size()));
                 }
             }
             catch (...) {
@@ -94,6 +153,8 @@ void MatrixFreePDE<dim,degree>::solveIncrement(){
             else {
                 *solutionSet[fieldIndex]+=dU_vector;
             }
+            storeEllipticSolution(fieldIndex);
+            solution_norm = solutionSet[fieldIndex]->l2_norm();
 
             if (currentIncrement%userInputs.skip_print_steps==0){
                 double dU_norm;
@@ -107,7 +168,7 @@ void MatrixFreePDE<dim,degree>::solveIncrement(){
                 fields[fieldIndex].name.c_str(),			\
                 residualSet[fieldIndex]->l2_norm(),			\
                 solver_control.last_value(),				\
-                solver_control.last_step(), solver_control.tolerance(), solutionSet[fieldIndex]->l2_norm(), dU_norm);
+                solver_control.last_step(), solver_control.tolerance(), solution_norm, dU_norm);
                 pcout<<buffer;
             }
 
@@ -121,13 +182,40 @@ void MatrixFreePDE<dim,degree>::solveIncrement(){
         }
 
         //check if solution is nan
-        if (!numbers::is_finite(solutionSet[fieldIndex]->l2_norm())){
+        if (!numbers::is_finite(solution_norm)){
+            // With blow-up recovery, the time loop restores the last snapshot and retries with a smaller time step
+            if (userInputs.blowup_recovery_snapshots > 0){
+                sprintf(buffer, "field '%s' solution is NAN.\n", fields[fieldIndex].name.c_str());
+                pcout<<buffer;
+                solutionBlowUp = true;
+                computing_timer.exit_section("matrixFreePDE: solveIncrements");
+                return;
+            }
             sprintf(buffer, "ERROR: field '%s' solution is NAN. exiting.\n\n",
             fields[fieldIndex].name.c_str());
             pcout<<buffer;
             exit(-1);
         }
     }
+
+    // The fields with subcycling steps take the rest of their substeps
+    if (userInputs.max_subcycling_steps > 1){
+        solveSubcycles();
+        if (solutionBlowUp){
+            computing_timer.exit_section("matrixFreePDE: solveIncrements");
+            return;
+        }
+    }
+
+    if (userInputs.local_reaction_splitting){
+        integrateLocalReactions(reaction_dt);
+    }
+
+    // One more rate is stored for the multistep schemes (up to the number they need)
+    if (userInputs.multistep_order > 0 && numStoredRates+1 < rateHistory.size()){
+        numStoredRates++;
+    }
+
     if (currentIncrement%userInputs.skip_print_steps==0){
         pcout << "wall time: " << time.wall_time() << "s\n";
     }
@@ -0,0 +1,86 @@
+// Methods in MatrixFreePDE for stopping the time loop at a steady state
+
+#include "../../include/matrixFreePDE.h"
+
+// At the end of each window of "Steady state check interval" increments, the rate of change of each field averaged
+// over the window, |u - u_window_start|/(t - t_window_start), is compared with the steady state tolerance. The
+// solution is at a steady state once it is below the tolerance for every field, and a new window starts either way.
+// Only one copy of the solution is kept and the norms are only computed once per window. The copy is transferred along
+// with the solution when the mesh changes, so remeshing doesn't restart the window. The DOFs constrained to other DOFs
+// (hanging nodes, periodic slaves) and the Dirichlet DOFs aren't updated by the time steps, so they are left out of the
+// change.
+template <int dim, int degree>
+bool MatrixFreePDE<dim,degree>::checkSteadyState(){
+
+    char buffer[200];
+
+    if (steadyStateWindowValid && currentIncrement >= steadyStateWindowIncrement + userInputs.steady_state_interval){
+
+        const double elapsed_time = currentTime - steadyStateWindowTime;
+        bool steady = (elapsed_time > 0.0);
+
+        syncSinglePrecisionFields();
+        for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+            // The old solution isn't needed after this, so the change is computed in its place
+            vectorType & change = *steadyStateSolutionOld[fieldIndex];
+            change.sadd(-1.0, 1.0, *solutionSet[fieldIndex]);
+            for (unsigned int i=0; i<localDirichletValues[fieldIndex].size(); ++i){
+                change.local_element(localDirichletValues[fieldIndex][i].first) = 0.0;
+            }
+            constraintsOtherSet[fieldIndex]->set_zero(change);
+            double rate = (userInputs.steady_state_linfty_norm ? change.linfty_norm() : change.l2_norm());
+            if (elapsed_time > 0.0){
+                rate /= elapsed_time;
+            }
+            if (!(rate < userInputs.steady_state_tolerance)){
+                steady = false;
+            }
+
+            if (currentIncrement%userInputs.skip_print_steps==0){
+                sprintf(buffer, "field '%2s' [steady state check]: averaged rate of change: %12.6e, tolerance: %12.6e\n", \
+                fields[fieldIndex].name.c_str(), rate, userInputs.steady_state_tolerance);
+                pcout<<buffer;
+            }
+        }
+        steadyStateWindowValid = false;
+
+        if (steady){
+            if (!userInputs.steady_state_increase_time_step){
+                sprintf(buffer, "\nSteady state reached at increment %u, time %12.6e. Stopping the simulation.\n", currentIncrement, currentTime);
+                pcout<<buffer;
+
+                // Write the final solution, unless it was just written
+                if (currentOutput == 0 || userInputs.outputTimeStepList[currentOutput-1] != currentIncrement){
+                    for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+                        constraintsDirichletSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
+                        constraintsOtherSet[fieldIndex]->distribute(*solutionSet[fieldIndex]);
+                        solutionSet[fieldIndex]->update_ghost_values();
+                    }
+                    outputResults();
+                }
+                return true;
+            }
+
+            steadyStateStepRatio *= userInputs.steady_state_step_factor;
+            sprintf(buffer, "\nSteady state reached at increment %u, time %12.6e. Increasing the time step to %12.6e.\n", currentIncrement, currentTime, steadyStateStepRatio*userInputs.dtValue);
+            pcout<<buffer;
+            // The previous solution for BDF2 is for the old time step
+            bdfSolutionOldValid = false;
+        }
+    }
+
+    // Start a new window
+    if (!steadyStateWindowValid){
+        syncSinglePrecisionFields();
+        for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+            *steadyStateSolutionOld[fieldIndex] = *solutionSet[fieldIndex];
+        }
+        steadyStateWindowIncrement = currentIncrement;
+        steadyStateWindowTime = currentTime;
+        steadyStateWindowValid = true;
+    }
+
+    return false;
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
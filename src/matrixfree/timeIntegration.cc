@@ -0,0 +1,324 @@
+// Methods in MatrixFreePDE shared by the time integration schemes other than forward Euler with a fixed time step
+
+#include "../../include/matrixFreePDE.h"
+
+// Compute the rate of change of each PARABOLIC field at the current solution and time. The residual from residualRHS
+// is M*(u + dtValue*f(u)), so the rate is f(u) = (invM*R - u)/dtValue. The rate is zero for the DOFs with Dirichlet BCs
+// and for the DOFs constrained to others (hanging nodes, periodic slaves), where invM is zero and the rate would be a
+// spurious decay -u/dtValue. The values of the constrained DOFs are only set from the constraints at output.
+// A field whose value isn't used in residualRHS (like the chemical potential in the Cahn-Hilliard apps) isn't an ODE
+// but an algebraic constraint, u = invM*R, so it is set to invM*R in place (with its Dirichlet values) and its rate is
+// zero. The schemes leave these fields out of their stage and history combinations.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::computeRates(std::vector<vectorType*> & rates){
+
+	computeRHS();
+
+	const double inv_dt = 1.0/userInputs.dtValue;
+
+	// Takes advantage of knowledge that the length of solutionSet and residualSet is an integer multiple of the length of invM for vector variables
+	const unsigned int invM_size = invM.local_size();
+
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		if (fields[fieldIndex].pdetype != PARABOLIC){
+			continue;
+		}
+
+		const vectorType & residual = *residualSet[fieldIndex];
+		vectorType & solution = *solutionSet[fieldIndex];
+		vectorType & rate = *rates[fieldIndex];
+
+		const unsigned int local_size = solution.local_size();
+		if (!userInputs.varInfoListRHS[fieldIndex].need_value){
+			for (unsigned int offset=0; offset<local_size; offset+=invM_size){
+				for (unsigned int k=0; k<invM_size; ++k){
+					solution.local_element(offset+k) = invM.local_element(k)*residual.local_element(offset+k);
+				}
+			}
+			for (unsigned int i=0; i<localDirichletValues[fieldIndex].size(); ++i){
+				solution.local_element(localDirichletValues[fieldIndex][i].first) = localDirichletValues[fieldIndex][i].second;
+			}
+			solution.update_ghost_values();
+			rate = 0.0;
+			continue;
+		}
+
+		for (unsigned int offset=0; offset<local_size; offset+=invM_size){
+			for (unsigned int k=0; k<invM_size; ++k){
+				rate.local_element(offset+k) = (invM.local_element(k)*residual.local_element(offset+k) - solution.local_element(offset+k))*inv_dt;
+			}
+		}
+
+		for (unsigned int i=0; i<localDirichletValues[fieldIndex].size(); ++i){
+			rate.local_element(localDirichletValues[fieldIndex][i].first) = 0.0;
+		}
+		constraintsOtherSet[fieldIndex]->set_zero(rate);
+	}
+}
+
+// (Re)initialize the vectors for the selected time integration scheme on the current mesh. The Runge-Kutta stage rates
+// from a previous mesh aren't transferred, so they are marked as invalid. The rate history of the multistep schemes is
+// transferred in reinit(), so it is only allocated here the first time, as is the previous solution for BDF2.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::initTimeIntegrationVectors(){
+
+	rkFirstStageRateValid = false;
+
+	if (userInputs.adaptive_time_stepping){
+		rkTableau = embeddedRungeKuttaTableau(userInputs.time_integration_scheme);
+
+		rkStageRates.resize(rkTableau.num_stages);
+		for (unsigned int stage=0; stage<rkTableau.num_stages; stage++){
+			rkStageRates[stage].resize(fields.size(),NULL);
+		}
+		rkSolutionOld.resize(fields.size(),NULL);
+
+		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+			if (fields[fieldIndex].pdetype == PARABOLIC){
+				for (unsigned int stage=0; stage<rkTableau.num_stages; stage++){
+					if (rkStageRates[stage][fieldIndex] == NULL){
+						rkStageRates[stage][fieldIndex] = new vectorType;
+					}
+					matrixFreeObject.initialize_dof_vector(*rkStageRates[stage][fieldIndex], fieldIndex);
+				}
+				if (rkSolutionOld[fieldIndex] == NULL){
+					rkSolutionOld[fieldIndex] = new vectorType;
+				}
+				matrixFreeObject.initialize_dof_vector(*rkSolutionOld[fieldIndex], fieldIndex);
+			}
+		}
+	}
+
+	if (userInputs.multistep_order > 0 && rateHistory.size() == 0){
+		multistepCoefficients.clear();
+		for (unsigned int order=1; order<=userInputs.multistep_order; order++){
+			multistepCoefficients.push_back(adamsBashforthCoefficients(order));
+		}
+
+		rateHistory.resize(userInputs.multistep_order);
+		for (unsigned int age=0; age<userInputs.multistep_order; age++){
+			rateHistory[age].resize(fields.size(),NULL);
+			for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+				if (fields[fieldIndex].pdetype == PARABOLIC){
+					rateHistory[age][fieldIndex] = new vectorType;
+					matrixFreeObject.initialize_dof_vector(*rateHistory[age][fieldIndex], fieldIndex);
+				}
+			}
+		}
+		numStoredRates = 0;
+	}
+
+	// BDF1 can also be the coarse propagator of Parareal
+	if (userInputs.bdf_order > 0 || userInputs.parareal_coarse_bdf){
+		bdfSolution.reinit(fields.size());
+		bdfRates.reinit(fields.size());
+		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+			matrixFreeObject.initialize_dof_vector(bdfSolution.block(fieldIndex), fieldIndex);
+			matrixFreeObject.initialize_dof_vector(bdfRates.block(fieldIndex), fieldIndex);
+		}
+		bdfSolution.collect_sizes();
+		bdfRates.collect_sizes();
+	}
+
+	if (userInputs.local_time_stepping_levels > 1){
+		initLocalTimeStepping();
+	}
+
+	if (userInputs.bdf_order == 2 && bdfSolutionOld.size() == 0){
+		bdfSolutionOld.resize(fields.size(),NULL);
+		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+			bdfSolutionOld[fieldIndex] = new vectorType;
+			matrixFreeObject.initialize_dof_vector(*bdfSolutionOld[fieldIndex], fieldIndex);
+		}
+		bdfSolutionOldValid = false;
+	}
+
+	// The snapshots for blow-up recovery aren't transferred to the new mesh, the ring starts over
+	if (userInputs.blowup_recovery_snapshots > 0){
+		recoverySnapshots.resize(userInputs.blowup_recovery_snapshots);
+		recoverySnapshotIncrement.resize(userInputs.blowup_recovery_snapshots,0);
+		recoverySnapshotTime.resize(userInputs.blowup_recovery_snapshots,0.0);
+		for (unsigned int slot=0; slot<recoverySnapshots.size(); slot++){
+			recoverySnapshots[slot].resize(fields.size(),NULL);
+			for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+				if (recoverySnapshots[slot][fieldIndex] == NULL){
+					recoverySnapshots[slot][fieldIndex] = new vectorType;
+				}
+				matrixFreeObject.initialize_dof_vector(*recoverySnapshots[slot][fieldIndex], fieldIndex);
+			}
+		}
+		numRecoverySnapshots = 0;
+	}
+
+	// The solution at the start of the steady state window is transferred in reinit(), so the window carries over to
+	// the new mesh and it is only allocated here the first time
+	if (userInputs.steady_state_tolerance > 0.0 && steadyStateSolutionOld.size() == 0){
+		steadyStateSolutionOld.resize(fields.size(),NULL);
+		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+			steadyStateSolutionOld[fieldIndex] = new vectorType;
+			matrixFreeObject.initialize_dof_vector(*steadyStateSolutionOld[fieldIndex], fieldIndex);
+		}
+		steadyStateWindowValid = false;
+	}
+}
+
+// Get the vectors from previous time steps that are transferred to the new mesh along with the solution of a field,
+// empty if the time integration scheme doesn't store any
+template <int dim, int degree>
+std::vector<vectorType*> MatrixFreePDE<dim,degree>::transferredHistoryVectors(const unsigned int fieldIndex){
+
+	std::vector<vectorType*> history;
+	for (unsigned int age=0; age<rateHistory.size(); age++){
+		if (rateHistory[age][fieldIndex] != NULL){
+			history.push_back(rateHistory[age][fieldIndex]);
+		}
+	}
+	if (bdfSolutionOld.size() > 0 && bdfSolutionOld[fieldIndex] != NULL){
+		history.push_back(bdfSolutionOld[fieldIndex]);
+	}
+	if (steadyStateSolutionOld.size() > 0){
+		history.push_back(steadyStateSolutionOld[fieldIndex]);
+	}
+	return history;
+}
+
+// Estimate the largest stable forward Euler time step. Forward Euler is stable for the linearized problem if
+// dt*|lambda| <= 2 for the eigenvalues lambda of the Jacobian of the rates, which for diffusion-like terms are real and
+// negative and scale with the model coefficients and 1/h^2 of the smallest cells. The largest eigenvalue magnitude is
+// found with a power iteration, where each product of the Jacobian with a vector is a finite difference of computeRates.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::estimateStableTimeStep(){
+
+	computing_timer.enter_section("matrixFreePDE: estimateStableTimeStep");
+
+	const unsigned int max_iterations = 50;
+	const double iteration_tolerance = 1.0e-3;
+
+	// Vectors for the PARABOLIC fields: the current solution, the rates there, the perturbed rates and the direction
+	// of the power iteration. The fields set to invM*R by computeRates have no rate, so they aren't in the direction.
+	// The rates of the other fields depend on them, so before each evaluation of the rates they are set from the
+	// (perturbed) solution with an extra call to computeRates, and the product is with the Jacobian of the rates with
+	// the constraints eliminated.
+	std::vector<vectorType*> solution_base(fields.size(),NULL);
+	std::vector<vectorType*> rates_base(fields.size(),NULL);
+	std::vector<vectorType*> rates_perturbed(fields.size(),NULL);
+	std::vector<vectorType*> direction(fields.size(),NULL);
+
+	double solution_max = 0.0;
+	double direction_norm_sqr = 0.0;
+	bool projected_fields = false;
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		if (fields[fieldIndex].pdetype != PARABOLIC){
+			continue;
+		}
+		solution_base[fieldIndex] = new vectorType;
+		rates_base[fieldIndex] = new vectorType;
+		rates_perturbed[fieldIndex] = new vectorType;
+		matrixFreeObject.initialize_dof_vector(*solution_base[fieldIndex], fieldIndex);
+		matrixFreeObject.initialize_dof_vector(*rates_base[fieldIndex], fieldIndex);
+		matrixFreeObject.initialize_dof_vector(*rates_perturbed[fieldIndex], fieldIndex);
+
+		*solution_base[fieldIndex] = *solutionSet[fieldIndex];
+
+		if (!userInputs.varInfoListRHS[fieldIndex].need_value){
+			projected_fields = true;
+			continue;
+		}
+		direction[fieldIndex] = new vectorType;
+		matrixFreeObject.initialize_dof_vector(*direction[fieldIndex], fieldIndex);
+		solution_max = std::max(solution_max, solution_base[fieldIndex]->linfty_norm());
+
+		// Start from a direction that varies from DOF to DOF (the same for any number of processors), so that it
+		// isn't orthogonal to the high frequency modes that limit the time step
+		const types::global_dof_index first_index = direction[fieldIndex]->local_range().first;
+		for (unsigned int i=0; i<direction[fieldIndex]->local_size(); ++i){
+			direction[fieldIndex]->local_element(i) = std::sin(12.9898*(first_index+i) + 1.0);
+		}
+		for (unsigned int i=0; i<localDirichletValues[fieldIndex].size(); ++i){
+			direction[fieldIndex]->local_element(localDirichletValues[fieldIndex][i].first) = 0.0;
+		}
+		constraintsOtherSet[fieldIndex]->set_zero(*direction[fieldIndex]);
+		direction_norm_sqr += direction[fieldIndex]->norm_sqr();
+	}
+
+	if (projected_fields){
+		computeRates(rates_base);
+	}
+	computeRates(rates_base);
+
+	double lambda = 0.0;
+	double direction_norm = std::sqrt(direction_norm_sqr);
+	unsigned int iteration = 0;
+	for (; iteration<max_iterations && direction_norm > 0.0; iteration++){
+
+		// Perturb the solution along the direction, scaled so that the largest change is small relative to the solution
+		double direction_max = 0.0;
+		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+			if (direction[fieldIndex] != NULL){
+				direction_max = std::max(direction_max, direction[fieldIndex]->linfty_norm());
+			}
+		}
+		const double epsilon = 1.0e-6*(1.0+solution_max)/direction_max;
+
+		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+			if (solution_base[fieldIndex] != NULL){
+				*solutionSet[fieldIndex] = *solution_base[fieldIndex];
+				if (direction[fieldIndex] != NULL){
+					solutionSet[fieldIndex]->add(epsilon, *direction[fieldIndex]);
+				}
+				solutionSet[fieldIndex]->update_ghost_values();
+			}
+		}
+
+		if (projected_fields){
+			computeRates(rates_perturbed);
+		}
+		computeRates(rates_perturbed);
+
+		// The new direction is the product of the Jacobian and the old direction, and the ratio of their norms is the
+		// estimate of the largest eigenvalue magnitude
+		double new_norm_sqr = 0.0;
+		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+			if (direction[fieldIndex] != NULL){
+				direction[fieldIndex]->equ(1.0/epsilon, *rates_perturbed[fieldIndex]);
+				direction[fieldIndex]->add(-1.0/epsilon, *rates_base[fieldIndex]);
+				new_norm_sqr += direction[fieldIndex]->norm_sqr();
+			}
+		}
+		const double new_norm = std::sqrt(new_norm_sqr);
+		const double new_lambda = new_norm/direction_norm;
+		direction_norm = new_norm;
+
+		if (std::abs(new_lambda - lambda) < iteration_tolerance*new_lambda){
+			lambda = new_lambda;
+			iteration++;
+			break;
+		}
+		lambda = new_lambda;
+	}
+
+	// Restore the solution and free the temporary vectors
+	for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+		if (solution_base[fieldIndex] != NULL){
+			*solutionSet[fieldIndex] = *solution_base[fieldIndex];
+			solutionSet[fieldIndex]->update_ghost_values();
+		}
+		delete solution_base[fieldIndex];
+		delete rates_base[fieldIndex];
+		delete rates_perturbed[fieldIndex];
+		delete direction[fieldIndex];
+	}
+
+	if (lambda > 0.0 && numbers::is_finite(lambda)){
+		stableTimeStep = 2.0/lambda;
+	}
+	else {
+		stableTimeStep = std::numeric_limits<double>::infinity();
+	}
+
+	pcout << "\nEstimated stable time step: " << stableTimeStep << " (largest rate eigenvalue magnitude: " << lambda << ", power iterations: " << iteration << "), time step used: " << automaticTimeStep() << "\n";
+
+	computing_timer.exit_section("matrixFreePDE: estimateStableTimeStep");
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
@@ -0,0 +1,111 @@
+// Methods in MatrixFreePDE to find which values/derivatives of the variables the residual methods actually use
+
+#include "../../include/matrixFreePDE.h"
+
+// Run residualRHS and residualLHS once with tracing containers, report the needs and residual terms set in
+// loadVariableAttributes that don't match what the residual methods use and, if "Infer variable needs from residuals"
+// is set in the parameters file, replace the declared value/gradient/hessian needs with the traced ones.
+// This has to be called before the containers for the cell loops are created.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::traceVariableNeeds(){
+
+	dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc;
+	for (unsigned int d=0; d<dim; d++){
+		q_point_loc(d) = 0.0;
+	}
+
+	variableContainerTrace<dim,degree> rhs_trace(userInputs.varInfoListRHS);
+	if (!traceResidualRHS(rhs_trace,q_point_loc)){
+		pcout << "Note: the residual methods of this application can't be traced, the variable attributes in equations.h are used as declared.\n";
+		return;
+	}
+	applyTracedVariableNeeds(userInputs.varInfoListRHS,rhs_trace,"residualRHS",true);
+
+	if (isEllipticBVP || userInputs.imex_time_integration){
+		variableContainerTrace<dim,degree> lhs_trace(userInputs.varInfoListLHS);
+		unsigned int field_index_before_trace = currentFieldIndex;
+		for(unsigned int fieldIndex=0; fieldIndex<fields.size(); fieldIndex++){
+			if (fields[fieldIndex].pdetype == ELLIPTIC || userInputs.var_implicit_linear_terms[fieldIndex]){
+				currentFieldIndex = fieldIndex;
+				traceResidualLHS(lhs_trace,q_point_loc);
+			}
+		}
+		currentFieldIndex = field_index_before_trace;
+		applyTracedVariableNeeds(userInputs.varInfoListLHS,lhs_trace,"residualLHS",false);
+	}
+}
+
+// Default versions of the tracing methods, for models that don't provide the residual methods as templates on the
+// container type
+template <int dim, int degree>
+bool MatrixFreePDE<dim,degree>::traceResidualRHS(variableContainerTrace<dim,degree> & variable_list,
+		dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
+	return false;
+}
+
+template <int dim, int degree>
+bool MatrixFreePDE<dim,degree>::traceResidualLHS(variableContainerTrace<dim,degree> & variable_list,
+		dealii::Point<dim, dealii::VectorizedArray<double> > q_point_loc) const {
+	return false;
+}
+
+// Compare one list of variable attributes with the trace of the corresponding residual method. If every field is
+// integrated with this list (as in the RHS), every field keeps its FEEvaluation object even if none of its
+// values/derivatives are used.
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::applyTracedVariableNeeds(std::vector<variable_info> & varInfoList,
+		const variableContainerTrace<dim,degree> & trace,
+		const std::string residual_name, bool every_field_integrated){
+
+	for (unsigned int i=0; i<varInfoList.size(); i++){
+		const std::string & name = userInputs.var_name[i];
+
+		const unsigned int num_terms = 5;
+		const char * term_names[num_terms] = {"value", "gradient", "hessian", "value residual term", "gradient residual term"};
+		const bool declared[num_terms] = {varInfoList[i].need_value, varInfoList[i].need_gradient, varInfoList[i].need_hessian,
+				varInfoList[i].value_residual, varInfoList[i].gradient_residual};
+		const bool used[num_terms] = {trace.traced_value[i], trace.traced_gradient[i], trace.traced_hessian[i],
+				trace.traced_value_residual[i], trace.traced_gradient_residual[i]};
+
+		for (unsigned int n=0; n<num_terms; n++){
+			if (declared[n] && !used[n]){
+				pcout << "Note: the " << term_names[n] << " of variable '" << name << "' is marked as needed for " << residual_name << " in equations.h, but " << residual_name << " doesn't use it.\n";
+			}
+			else if (!declared[n] && used[n]){
+				pcout << "Warning: the " << term_names[n] << " of variable '" << name << "' is used by " << residual_name << ", but isn't marked as needed in equations.h.\n";
+			}
+		}
+	}
+
+	if (!userInputs.infer_variable_needs){
+		return;
+	}
+
+	// Replace the value/gradient/hessian needs (the residual terms are left as declared, since they determine what is
+	// integrated) and renumber the FEEvaluation objects
+	unsigned int scalar_var_index = 0;
+	unsigned int vector_var_index = 0;
+	for (unsigned int i=0; i<varInfoList.size(); i++){
+		variable_info & varInfo = varInfoList[i];
+
+		varInfo.need_value = trace.traced_value[i];
+		varInfo.need_gradient = trace.traced_gradient[i];
+		varInfo.need_hessian = trace.traced_hessian[i];
+
+		bool integrated = every_field_integrated || varInfo.value_residual || varInfo.gradient_residual;
+		varInfo.var_needed = varInfo.need_value || varInfo.need_gradient || varInfo.need_hessian || (integrated && varInfo.var_needed);
+
+		if (varInfo.var_needed){
+			if (varInfo.is_scalar){
+				varInfo.scalar_or_vector_index = scalar_var_index;
+				scalar_var_index++;
+			}
+			else {
+				varInfo.scalar_or_vector_index = vector_var_index;
+				vector_var_index++;
+			}
+		}
+	}
+}
+
+#include "../../include/matrixFreePDE_template_instantiations.h"
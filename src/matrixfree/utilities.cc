@@ -12,5 +12,18 @@ unsigned int MatrixFreePDE<dim,degree>::getFieldIndex(std::string _name) {
    exit(-1);
 }
 
+// Delete the per-thread containers used in the cell loops, they are rebuilt the next time each thread runs a cell loop
+template <int dim, int degree>
+void MatrixFreePDE<dim,degree>::clearThreadLocalContainers() {
+   threadLocalContainersRHS.clear();
+   threadLocalContainersLHS.clear();
+   threadLocalContainersPPBase.clear();
+   threadLocalContainersPP.clear();
+   threadLocalIntegralEvaluators.clear();
+   threadLocalContainersRHSFloat.clear();
+   threadLocalContainersRHSSubcycle.clear();
+   threadLocalContainersRHSSubcycleFloat.clear();
+}
+
 #include "../../include/matrixFreePDE_template_instantiations.h"
 
@@ -38,6 +38,57 @@ void userInputParameters<dim>::loadVariableAttributes(variableAttributeLoader va
     pp_calc_integral = sortIndexEntryPairList(variable_attributes.output_integral_list,pp_number_of_variables,false);
 
 
+    need_q_point_locations = variable_attributes.need_q_point_locations;
+
+    // Load the flags for the PARABOLIC equations with implicit linear terms
+    var_implicit_linear_terms = sortIndexEntryPairList(variable_attributes.implicit_linear_terms_list,number_of_variables,false);
+    imex_time_integration = false;
+    for (unsigned int i=0; i<number_of_variables; i++){
+        if (var_implicit_linear_terms[i]){
+            if (var_eq_type[i] != PARABOLIC){
+                std::cerr << "PRISMS-PF Error: Implicit linear terms can only be set for PARABOLIC equations (variable '" << var_name[i] << "')." << std::endl;
+                abort();
+            }
+            imex_time_integration = true;
+        }
+    }
+
+    // Load the number of substeps of each field for multirate time stepping. Each field is updated at the substeps that
+    // are a multiple of (largest number of substeps)/(its number of substeps), so the numbers must divide the largest one.
+    var_subcycling_steps = sortIndexEntryPairList(variable_attributes.subcycling_steps_list,number_of_variables,1);
+    max_subcycling_steps = 1;
+    for (unsigned int i=0; i<number_of_variables; i++){
+        if (var_subcycling_steps[i] == 0){
+            std::cerr << "PRISMS-PF Error: The number of subcycling steps must be at least one (variable '" << var_name[i] << "')." << std::endl;
+            abort();
+        }
+        if (var_subcycling_steps[i] > 1 && var_eq_type[i] != PARABOLIC){
+            std::cerr << "PRISMS-PF Error: Subcycling steps can only be set for PARABOLIC equations (variable '" << var_name[i] << "')." << std::endl;
+            abort();
+        }
+        max_subcycling_steps = std::max(max_subcycling_steps, var_subcycling_steps[i]);
+    }
+    for (unsigned int i=0; i<number_of_variables; i++){
+        if (max_subcycling_steps%var_subcycling_steps[i] != 0){
+            std::cerr << "PRISMS-PF Error: The number of subcycling steps of each variable must divide the largest number of subcycling steps (variable '" << var_name[i] << "')." << std::endl;
+            abort();
+        }
+    }
+
+    // Load the flags for the PARABOLIC equations with local reaction terms. The reaction terms are integrated at each
+    // DOF separately, with the values of all of the scalar fields at that DOF.
+    var_local_reaction_terms = sortIndexEntryPairList(variable_attributes.local_reaction_terms_list,number_of_variables,false);
+    local_reaction_splitting = false;
+    for (unsigned int i=0; i<number_of_variables; i++){
+        if (var_local_reaction_terms[i]){
+            if (var_eq_type[i] != PARABOLIC || var_type[i] != SCALAR){
+                std::cerr << "PRISMS-PF Error: Local reaction terms can only be set for SCALAR PARABOLIC equations (variable '" << var_name[i] << "')." << std::endl;
+                abort();
+            }
+            local_reaction_splitting = true;
+        }
+    }
+
     // Load some nucleation parameters
     for (unsigned int i=0; i<number_of_variables; i++){
         if (nucleating_variable.at(i)==true){
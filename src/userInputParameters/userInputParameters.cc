@@ -70,12 +70,370 @@ userInputParameters<dim>::userInputParameters(inputFileReader & input_file_reade
     int totalIncrements_temp = parameter_handler.get_integer("Number of time steps");
     finalTime = parameter_handler.get_double("Simulation end time");
 
+    // Precision for the evaluation of the RHS residuals
+    std::string residual_precision = parameter_handler.get("Residual precision");
+    if (boost::iequals(residual_precision,"double")){
+        single_precision_residual = false;
+    }
+    else if (boost::iequals(residual_precision,"single")){
+        single_precision_residual = true;
+        for (unsigned int i=0; i<var_eq_type.size(); i++){
+            if (var_eq_type[i] == ELLIPTIC){
+                std::cerr << "PRISMS-PF Error: Single precision residuals are only supported when all of the equations are PARABOLIC." << std::endl;
+                abort();
+            }
+        }
+    }
+    else {
+        std::cerr << "PRISMS-PF Error: The residual precision must be either 'double' or 'single'." << std::endl;
+        std::cerr << residual_precision << std::endl;
+        abort();
+    }
+
+    // Fields stored in single precision during time stepping
+    var_single_precision_storage.assign(_number_of_variables,false);
+    std::vector<std::string> single_precision_fields_str = dealii::Utilities::split_string_list(parameter_handler.get("Fields stored in single precision"));
+    for (unsigned int sp_field=0; sp_field<single_precision_fields_str.size(); sp_field++){
+        bool field_found = false;
+        for (unsigned int i=0; i<_number_of_variables; i++ ){
+            if (boost::iequals(single_precision_fields_str[sp_field], variable_attributes.var_name_list[i].second)){
+                unsigned int var_index = variable_attributes.var_name_list[i].first;
+                if (var_eq_type[var_index] != PARABOLIC){
+                    std::cerr << "PRISMS-PF Error: Only PARABOLIC fields can be stored in single precision." << std::endl;
+                    std::cerr << single_precision_fields_str[sp_field] << std::endl;
+                    abort();
+                }
+                var_single_precision_storage[var_index] = true;
+                field_found = true;
+                break;
+            }
+        }
+        if (field_found == false){
+            std::cerr << "PRISMS-PF Error: Entries in the list of fields stored in single precision must match the variable names in equations.h." << std::endl;
+            std::cerr << single_precision_fields_str[sp_field] << std::endl;
+            abort();
+        }
+    }
+
+    // Time integration scheme
+    std::string time_integration_scheme_str = parameter_handler.get("Time integration scheme");
+    if (boost::iequals(time_integration_scheme_str,"forward_euler")){
+        time_integration_scheme = FORWARD_EULER;
+    }
+    else if (boost::iequals(time_integration_scheme_str,"BS32")){
+        time_integration_scheme = BOGACKI_SHAMPINE_32;
+    }
+    else if (boost::iequals(time_integration_scheme_str,"DP54")){
+        time_integration_scheme = DORMAND_PRINCE_54;
+    }
+    else if (boost::iequals(time_integration_scheme_str,"AB2")){
+        time_integration_scheme = ADAMS_BASHFORTH_2;
+    }
+    else if (boost::iequals(time_integration_scheme_str,"AB3")){
+        time_integration_scheme = ADAMS_BASHFORTH_3;
+    }
+    else if (boost::iequals(time_integration_scheme_str,"BDF1")){
+        time_integration_scheme = BACKWARD_DIFFERENTIATION_1;
+    }
+    else if (boost::iequals(time_integration_scheme_str,"BDF2")){
+        time_integration_scheme = BACKWARD_DIFFERENTIATION_2;
+    }
+    else if (boost::iequals(time_integration_scheme_str,"ETD1")){
+        time_integration_scheme = EXPONENTIAL_EULER;
+    }
+    else if (boost::iequals(time_integration_scheme_str,"ETD2RK")){
+        time_integration_scheme = EXPONENTIAL_RUNGE_KUTTA_2;
+    }
+    else {
+        std::cerr << "PRISMS-PF Error: The time integration scheme must be 'forward_euler', 'BS32', 'DP54', 'AB2', 'AB3', 'BDF1', 'BDF2', 'ETD1' or 'ETD2RK'." << std::endl;
+        std::cerr << time_integration_scheme_str << std::endl;
+        abort();
+    }
+    adaptive_time_stepping = (time_integration_scheme == BOGACKI_SHAMPINE_32 || time_integration_scheme == DORMAND_PRINCE_54);
+    multistep_order = 0;
+    if (time_integration_scheme == ADAMS_BASHFORTH_2){
+        multistep_order = 2;
+    }
+    else if (time_integration_scheme == ADAMS_BASHFORTH_3){
+        multistep_order = 3;
+    }
+    bdf_order = 0;
+    if (time_integration_scheme == BACKWARD_DIFFERENTIATION_1){
+        bdf_order = 1;
+    }
+    else if (time_integration_scheme == BACKWARD_DIFFERENTIATION_2){
+        bdf_order = 2;
+    }
+    etd_order = 0;
+    if (time_integration_scheme == EXPONENTIAL_EULER){
+        etd_order = 1;
+    }
+    else if (time_integration_scheme == EXPONENTIAL_RUNGE_KUTTA_2){
+        etd_order = 2;
+    }
+    time_integration_tolerance = parameter_handler.get_double("Time integration error tolerance");
+    max_dt = parameter_handler.get_double("Maximum time step");
+
+    if (adaptive_time_stepping){
+        for (unsigned int i=0; i<var_eq_type.size(); i++){
+            if (var_eq_type[i] == ELLIPTIC){
+                std::cerr << "PRISMS-PF Error: The adaptive time integration schemes are currently only available if all of the equations are PARABOLIC." << std::endl;
+                abort();
+            }
+            if (var_single_precision_storage[i]){
+                std::cerr << "PRISMS-PF Error: The adaptive time integration schemes can't be used with fields stored in single precision." << std::endl;
+                abort();
+            }
+        }
+        if (nucleation_occurs){
+            std::cerr << "PRISMS-PF Error: The adaptive time integration schemes can't be used with nucleation (the nucleation probabilities assume a fixed time step)." << std::endl;
+            abort();
+        }
+    }
+
+    // Automatic time step
+    automatic_time_step = parameter_handler.get_bool("Automatic time step");
+    time_step_safety_factor = parameter_handler.get_double("Automatic time step safety factor");
+
+    if (automatic_time_step){
+        if (time_step_safety_factor <= 0.0 || time_step_safety_factor > 1.0){
+            std::cerr << "PRISMS-PF Error: The automatic time step safety factor must be greater than zero and no larger than one." << std::endl;
+            abort();
+        }
+        for (unsigned int i=0; i<var_eq_type.size(); i++){
+            if (var_single_precision_storage[i]){
+                std::cerr << "PRISMS-PF Error: The automatic time step can't be used with fields stored in single precision." << std::endl;
+                abort();
+            }
+        }
+        if (nucleation_occurs){
+            std::cerr << "PRISMS-PF Error: The automatic time step can't be used with nucleation (the nucleation probabilities assume a fixed time step)." << std::endl;
+            abort();
+        }
+        if (multistep_order > 0){
+            std::cerr << "PRISMS-PF Error: The Adams-Bashforth schemes need a fixed time step, so they can't be used with the automatic time step." << std::endl;
+            abort();
+        }
+        if (bdf_order > 0 || etd_order > 0){
+            std::cerr << "PRISMS-PF Error: The automatic time step is the forward Euler stability limit, it can't be used with the BDF or ETD schemes." << std::endl;
+            abort();
+        }
+    }
+
+    if (multistep_order > 0){
+        for (unsigned int i=0; i<var_eq_type.size(); i++){
+            if (var_single_precision_storage[i]){
+                std::cerr << "PRISMS-PF Error: The Adams-Bashforth schemes can't be used with fields stored in single precision." << std::endl;
+                abort();
+            }
+        }
+    }
+
+    // Implicit BDF schemes
+    newton_tolerance = parameter_handler.get_double("Newton tolerance");
+    max_newton_iterations = parameter_handler.get_integer("Maximum Newton iterations");
+
+    if (bdf_order > 0){
+        for (unsigned int i=0; i<var_eq_type.size(); i++){
+            if (var_eq_type[i] == ELLIPTIC){
+                std::cerr << "PRISMS-PF Error: The implicit BDF schemes are currently only available if all of the equations are PARABOLIC." << std::endl;
+                abort();
+            }
+            if (var_single_precision_storage[i]){
+                std::cerr << "PRISMS-PF Error: The implicit BDF schemes can't be used with fields stored in single precision." << std::endl;
+                abort();
+            }
+        }
+        if (newton_tolerance <= 0.0){
+            std::cerr << "PRISMS-PF Error: The Newton tolerance must be greater than zero." << std::endl;
+            abort();
+        }
+    }
+
+    // Exponential time differencing schemes
+    krylov_max_dimension = parameter_handler.get_integer("Krylov subspace dimension");
+    krylov_tolerance = parameter_handler.get_double("Krylov tolerance");
+
+    if (etd_order > 0){
+        for (unsigned int i=0; i<var_eq_type.size(); i++){
+            if (var_eq_type[i] == ELLIPTIC){
+                std::cerr << "PRISMS-PF Error: The exponential time differencing schemes are currently only available if all of the equations are PARABOLIC." << std::endl;
+                abort();
+            }
+            if (var_single_precision_storage[i]){
+                std::cerr << "PRISMS-PF Error: The exponential time differencing schemes can't be used with fields stored in single precision." << std::endl;
+                abort();
+            }
+        }
+        if (krylov_max_dimension == 0 || krylov_tolerance <= 0.0){
+            std::cerr << "PRISMS-PF Error: The Krylov subspace dimension and the Krylov tolerance must be greater than zero." << std::endl;
+            abort();
+        }
+    }
+
+    if (imex_time_integration){
+        if ((time_integration_scheme != FORWARD_EULER && etd_order == 0) || automatic_time_step){
+            std::cerr << "PRISMS-PF Error: Equations with implicit linear terms can currently only be used with the forward_euler or ETD time integration schemes and a fixed time step." << std::endl;
+            abort();
+        }
+        for (unsigned int i=0; i<var_eq_type.size(); i++){
+            if (var_implicit_linear_terms[i] && var_single_precision_storage[i]){
+                std::cerr << "PRISMS-PF Error: Fields for equations with implicit linear terms can't be stored in single precision." << std::endl;
+                abort();
+            }
+        }
+    }
+
+    // Local time stepping
+    local_time_stepping_levels = parameter_handler.get_integer("Local time stepping levels");
+
+    if (local_time_stepping_levels == 0 || local_time_stepping_levels > 8){
+        std::cerr << "PRISMS-PF Error: The number of local time stepping levels must be between one and eight." << std::endl;
+        abort();
+    }
+    if (local_time_stepping_levels > 1){
+        if (time_integration_scheme != FORWARD_EULER || automatic_time_step || imex_time_integration){
+            std::cerr << "PRISMS-PF Error: Local time stepping is currently only available with the forward_euler time integration scheme, a fixed time step and no implicit linear terms." << std::endl;
+            abort();
+        }
+        if (single_precision_residual){
+            std::cerr << "PRISMS-PF Error: Local time stepping can't be used with residuals evaluated in single precision." << std::endl;
+            abort();
+        }
+        for (unsigned int i=0; i<var_eq_type.size(); i++){
+            if (var_eq_type[i] == ELLIPTIC){
+                std::cerr << "PRISMS-PF Error: Local time stepping is currently only available if all of the equations are PARABOLIC." << std::endl;
+                abort();
+            }
+            if (var_single_precision_storage[i]){
+                std::cerr << "PRISMS-PF Error: Local time stepping can't be used with fields stored in single precision." << std::endl;
+                abort();
+            }
+        }
+        if (nucleation_occurs){
+            std::cerr << "PRISMS-PF Error: Local time stepping can't be used with nucleation (the mesh can be refined around new nuclei at any time step)." << std::endl;
+            abort();
+        }
+        // All of the DOFs are at the same time when the mesh is changed
+        const unsigned int steps_per_cycle = 1 << (local_time_stepping_levels-1);
+        if (h_adaptivity && skip_remeshing_steps%steps_per_cycle != 0){
+            std::cerr << "PRISMS-PF Error: With local time stepping, the number of steps between remeshing operations must be a multiple of 2^(number of local time stepping levels - 1)." << std::endl;
+            abort();
+        }
+    }
+
+    // Multirate time stepping
+    if (max_subcycling_steps > 1){
+        if (time_integration_scheme != FORWARD_EULER || automatic_time_step || imex_time_integration || local_time_stepping_levels > 1){
+            std::cerr << "PRISMS-PF Error: Fields with subcycling steps can currently only be used with the forward_euler time integration scheme, a fixed time step, no implicit linear terms and no local time stepping." << std::endl;
+            abort();
+        }
+        for (unsigned int i=0; i<var_eq_type.size(); i++){
+            if (var_subcycling_steps[i] > 1 && var_single_precision_storage[i]){
+                std::cerr << "PRISMS-PF Error: Fields with subcycling steps can't be stored in single precision." << std::endl;
+                abort();
+            }
+        }
+    }
+
+    // Operator splitting of the local reaction terms
+    reaction_tolerance = parameter_handler.get_double("Local reaction tolerance");
+
+    if (local_reaction_splitting){
+        if (time_integration_scheme != FORWARD_EULER || local_time_stepping_levels > 1){
+            std::cerr << "PRISMS-PF Error: Equations with local reaction terms can currently only be used with the forward_euler time integration scheme and no local time stepping." << std::endl;
+            abort();
+        }
+        for (unsigned int i=0; i<var_eq_type.size(); i++){
+            if (var_single_precision_storage[i]){
+                std::cerr << "PRISMS-PF Error: Equations with local reaction terms can't be used with fields stored in single precision." << std::endl;
+                abort();
+            }
+        }
+        if (reaction_tolerance <= 0.0){
+            std::cerr << "PRISMS-PF Error: The local reaction tolerance must be greater than zero." << std::endl;
+            abort();
+        }
+    }
+
+    // Whether to use the variable needs found by tracing the residual methods
+    infer_variable_needs = parameter_handler.get_bool("Infer variable needs from residuals");
+
     // Elliptic solver parameters
     solver_type = parameter_handler.get("Linear solver");
     abs_tol = parameter_handler.get_bool("Use absolute convergence tolerance");
     solver_tolerance = parameter_handler.get_double("Solver tolerance value");
     max_solver_iterations = parameter_handler.get_integer("Maximum allowed solver iterations");
 
+    std::string linear_preconditioner_str = parameter_handler.get("Linear solver preconditioner");
+    if (boost::iequals(linear_preconditioner_str,"none")){
+        linear_preconditioner = IDENTITY_PRECONDITIONER;
+    }
+    else if (boost::iequals(linear_preconditioner_str,"Jacobi")){
+        linear_preconditioner = JACOBI_PRECONDITIONER;
+    }
+    else if (boost::iequals(linear_preconditioner_str,"Chebyshev")){
+        #if (DEAL_II_VERSION_MAJOR < 9)
+        std::cerr << "PRISMS-PF Error: The Chebyshev preconditioner requires deal.II version 9.0 or later." << std::endl;
+        abort();
+        #endif
+        linear_preconditioner = CHEBYSHEV_PRECONDITIONER;
+    }
+    else if (boost::iequals(linear_preconditioner_str,"GMG")){
+        #if (DEAL_II_VERSION_MAJOR < 9)
+        std::cerr << "PRISMS-PF Error: The GMG preconditioner requires deal.II version 9.0 or later." << std::endl;
+        abort();
+        #endif
+        linear_preconditioner = GMG_PRECONDITIONER;
+    }
+    else {
+        std::cerr << "PRISMS-PF Error: The linear solver preconditioner must be 'none', 'Jacobi', 'Chebyshev' or 'GMG'." << std::endl;
+        abort();
+    }
+    mg_smoother_degree = parameter_handler.get_integer("Multigrid smoother degree");
+    mg_smoothing_range = parameter_handler.get_double("Multigrid smoothing range");
+    if (linear_preconditioner == GMG_PRECONDITIONER && (mg_smoother_degree == 0 || mg_smoothing_range <= 1.0)){
+        std::cerr << "PRISMS-PF Error: The multigrid smoother degree must be at least one and the multigrid smoothing range larger than one." << std::endl;
+        abort();
+    }
+    chebyshev_degree = parameter_handler.get_integer("Chebyshev preconditioner degree");
+    chebyshev_smoothing_range = parameter_handler.get_double("Chebyshev preconditioner smoothing range");
+    if (linear_preconditioner == CHEBYSHEV_PRECONDITIONER && (chebyshev_degree == 0 || chebyshev_smoothing_range <= 1.0)){
+        std::cerr << "PRISMS-PF Error: The Chebyshev preconditioner degree must be at least one and its smoothing range larger than one." << std::endl;
+        abort();
+    }
+    eigenvalue_estimate_iterations = parameter_handler.get_integer("Eigenvalue estimate iterations");
+    if ((linear_preconditioner == CHEBYSHEV_PRECONDITIONER || linear_preconditioner == GMG_PRECONDITIONER) && eigenvalue_estimate_iterations == 0){
+        std::cerr << "PRISMS-PF Error: The number of eigenvalue estimate iterations must be at least one." << std::endl;
+        abort();
+    }
+    recompute_preconditioner_diagonal = parameter_handler.get_bool("Recompute preconditioner diagonal every solve");
+
+    std::string elliptic_initial_guess_str = parameter_handler.get("Elliptic initial guess");
+    if (boost::iequals(elliptic_initial_guess_str,"zero")){
+        elliptic_initial_guess = ZERO_INITIAL_GUESS;
+    }
+    else if (boost::iequals(elliptic_initial_guess_str,"extrapolation")){
+        elliptic_initial_guess = EXTRAPOLATED_INITIAL_GUESS;
+    }
+    else if (boost::iequals(elliptic_initial_guess_str,"projection")){
+        elliptic_initial_guess = PROJECTED_INITIAL_GUESS;
+    }
+    else {
+        std::cerr << "PRISMS-PF Error: The elliptic initial guess must be 'zero', 'extrapolation' or 'projection'." << std::endl;
+        abort();
+    }
+    initial_guess_history_size = parameter_handler.get_integer("Initial guess history size");
+    if (elliptic_initial_guess == EXTRAPOLATED_INITIAL_GUESS && (initial_guess_history_size < 2 || initial_guess_history_size > 3)){
+        std::cerr << "PRISMS-PF Error: The initial guess history size must be 2 or 3 for an extrapolated initial guess." << std::endl;
+        abort();
+    }
+    if (elliptic_initial_guess == PROJECTED_INITIAL_GUESS && initial_guess_history_size == 0){
+        std::cerr << "PRISMS-PF Error: The initial guess history size must be at least one for a projected initial guess." << std::endl;
+        abort();
+    }
+    recycled_krylov_vectors = parameter_handler.get_integer("Recycled Krylov vectors");
+
     // Output parameters
     std::string output_condition = parameter_handler.get("Output condition");
     unsigned int num_outputs = parameter_handler.get_integer("Number of outputs");
@@ -181,6 +539,157 @@ userInputParameters<dim>::userInputParameters(inputFileReader & input_file_reade
 
     checkpointTimeStepList = setTimeStepList(checkpoint_condition, num_checkpoints,user_given_checkpoint_time_step_list);
 
+    // With local time stepping, the DOFs of the different classes are only at the same time at the multiples of
+    // 2^(number of local time stepping levels - 1)
+    if (local_time_stepping_levels > 1){
+        const unsigned int steps_per_cycle = 1 << (local_time_stepping_levels-1);
+        for (unsigned int i=0; i<outputTimeStepList.size(); i++){
+            if (outputTimeStepList[i] <= totalIncrements && outputTimeStepList[i]%steps_per_cycle != 0){
+                std::cerr << "PRISMS-PF Error: With local time stepping, the outputs must be at time steps that are multiples of 2^(number of local time stepping levels - 1)." << std::endl;
+                std::cerr << outputTimeStepList[i] << std::endl;
+                abort();
+            }
+        }
+    }
+
+    // Parallel-in-time integration with Parareal
+    parareal_time_slices = parameter_handler.get_integer("Parareal time slices");
+    parareal_coarse_factor = parameter_handler.get_integer("Parareal coarse time step factor");
+    parareal_tolerance = parameter_handler.get_double("Parareal tolerance");
+    max_parareal_iterations = parameter_handler.get_integer("Maximum Parareal iterations");
+    std::string parareal_coarse_scheme_str = parameter_handler.get("Parareal coarse time integration scheme");
+    if (boost::iequals(parareal_coarse_scheme_str,"BDF1")){
+        parareal_coarse_bdf = true;
+    }
+    else if (boost::iequals(parareal_coarse_scheme_str,"forward_euler")){
+        parareal_coarse_bdf = false;
+    }
+    else {
+        std::cerr << "PRISMS-PF Error: The Parareal coarse time integration scheme must be 'forward_euler' or 'BDF1'." << std::endl;
+        abort();
+    }
+
+    if (parareal_time_slices == 0 || parareal_coarse_factor == 0){
+        std::cerr << "PRISMS-PF Error: The number of Parareal time slices and the Parareal coarse time step factor must be at least one." << std::endl;
+        abort();
+    }
+    if (parareal_time_slices > 1){
+        // Every slice has the same mesh and the same number of processes, so the processes with the same rank in
+        // neighboring slices own the same DOFs and can exchange their part of the solution directly
+        if (dealii::Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD)%parareal_time_slices != 0){
+            std::cerr << "PRISMS-PF Error: The number of MPI processes must be a multiple of the number of Parareal time slices." << std::endl;
+            abort();
+        }
+        if (totalIncrements < parareal_time_slices){
+            std::cerr << "PRISMS-PF Error: There must be at least as many time steps as Parareal time slices." << std::endl;
+            abort();
+        }
+        if (time_integration_scheme != FORWARD_EULER || automatic_time_step || imex_time_integration || local_time_stepping_levels > 1){
+            std::cerr << "PRISMS-PF Error: Parareal is currently only available with the forward_euler time integration scheme, a fixed time step, no implicit linear terms and no local time stepping." << std::endl;
+            abort();
+        }
+        if (h_adaptivity || nucleation_occurs || resume_from_checkpoint || num_integrated_fields > 0){
+            std::cerr << "PRISMS-PF Error: Parareal can't be used with adaptive meshes, nucleation, checkpoints or integrated postprocessed fields." << std::endl;
+            abort();
+        }
+        for (unsigned int i=0; i<var_eq_type.size(); i++){
+            if (var_single_precision_storage[i]){
+                std::cerr << "PRISMS-PF Error: Parareal can't be used with fields stored in single precision." << std::endl;
+                abort();
+            }
+            if (parareal_coarse_bdf && var_eq_type[i] == ELLIPTIC){
+                std::cerr << "PRISMS-PF Error: The BDF1 coarse Parareal propagator is currently only available if all of the equations are PARABOLIC." << std::endl;
+                abort();
+            }
+        }
+        if (max_parareal_iterations == 0){
+            std::cerr << "PRISMS-PF Error: The maximum number of Parareal iterations must be at least one." << std::endl;
+            abort();
+        }
+    }
+    else {
+        parareal_coarse_bdf = false;
+    }
+
+    // Recovery from a blow-up of the solution
+    blowup_recovery_snapshots = parameter_handler.get_integer("Blow-up recovery snapshots");
+    blowup_snapshot_interval = parameter_handler.get_integer("Blow-up recovery snapshot interval");
+    blowup_step_reduction_factor = parameter_handler.get_integer("Blow-up recovery time step reduction factor");
+    max_blowup_step_reductions = parameter_handler.get_integer("Maximum blow-up recovery time step reductions");
+    blowup_steps_before_increase = parameter_handler.get_integer("Blow-up recovery steps before increase");
+
+    if (blowup_recovery_snapshots > 0){
+        if (blowup_snapshot_interval == 0 || blowup_step_reduction_factor < 2 || blowup_steps_before_increase == 0){
+            std::cerr << "PRISMS-PF Error: The blow-up recovery snapshot interval and the number of steps before the time step is increased must be at least one, and the time step reduction factor at least two." << std::endl;
+            abort();
+        }
+        // The reduced time step is taken as substeps of each increment, through the step ratio of the explicit, multistep
+        // and BDF updates, so the schemes with their own time step control or a time step built into residualLHS can't be used
+        if (adaptive_time_stepping || automatic_time_step || etd_order > 0 || imex_time_integration || local_time_stepping_levels > 1 || parareal_time_slices > 1){
+            std::cerr << "PRISMS-PF Error: Blow-up recovery is currently only available with the forward_euler, AB2, AB3, BDF1 and BDF2 time integration schemes with a fixed time step, no implicit linear terms, no local time stepping and no Parareal." << std::endl;
+            abort();
+        }
+        // The list of nuclei isn't part of the snapshots
+        if (nucleation_occurs){
+            std::cerr << "PRISMS-PF Error: Blow-up recovery can't be used with nucleation." << std::endl;
+            abort();
+        }
+    }
+
+    // Steady state termination
+    steady_state_tolerance = parameter_handler.get_double("Steady state tolerance");
+    steady_state_interval = parameter_handler.get_integer("Steady state check interval");
+    steady_state_step_factor = parameter_handler.get_double("Steady state time step factor");
+    std::string steady_state_norm_str = parameter_handler.get("Steady state norm");
+    if (boost::iequals(steady_state_norm_str,"l2")){
+        steady_state_linfty_norm = false;
+    }
+    else if (boost::iequals(steady_state_norm_str,"linfty")){
+        steady_state_linfty_norm = true;
+    }
+    else {
+        std::cerr << "PRISMS-PF Error: The steady state norm must be 'l2' or 'linfty'." << std::endl;
+        abort();
+    }
+    std::string steady_state_action_str = parameter_handler.get("Steady state action");
+    if (boost::iequals(steady_state_action_str,"stop")){
+        steady_state_increase_time_step = false;
+    }
+    else if (boost::iequals(steady_state_action_str,"increase_time_step")){
+        steady_state_increase_time_step = true;
+    }
+    else {
+        std::cerr << "PRISMS-PF Error: The steady state action must be 'stop' or 'increase_time_step'." << std::endl;
+        abort();
+    }
+
+    if (steady_state_tolerance < 0.0){
+        std::cerr << "PRISMS-PF Error: The steady state tolerance can't be negative." << std::endl;
+        abort();
+    }
+    if (steady_state_tolerance > 0.0){
+        if (steady_state_interval == 0){
+            std::cerr << "PRISMS-PF Error: The steady state check interval must be at least one." << std::endl;
+            abort();
+        }
+        if (parareal_time_slices > 1){
+            std::cerr << "PRISMS-PF Error: The steady state criterion can't be used with Parareal." << std::endl;
+            abort();
+        }
+        // Only the implicit schemes stay stable with a time step beyond the one in the parameters file (the adaptive
+        // schemes increase their time step on their own)
+        if (steady_state_increase_time_step){
+            if (bdf_order == 0 || blowup_recovery_snapshots > 0){
+                std::cerr << "PRISMS-PF Error: The increase_time_step steady state action is currently only available with the BDF1 and BDF2 time integration schemes, without blow-up recovery." << std::endl;
+                abort();
+            }
+            if (steady_state_step_factor <= 1.0){
+                std::cerr << "PRISMS-PF Error: The steady state time step factor must be larger than one." << std::endl;
+                abort();
+            }
+        }
+    }
+
     // Parameters for nucleation
 
     for (unsigned int i=0; i<input_file_reader.var_types.size(); i++){
@@ -265,6 +774,35 @@ userInputParameters<dim>::userInputParameters(inputFileReader & input_file_reade
     // Load the BC information from the strings into a varBCs object
     load_BC_list(list_of_BCs);
 
+    // The levels of the multigrid preconditioner have no periodicity constraints and no constraint fixing the solution
+    // at a point, so every component of the ELLIPTIC fields needs a Dirichlet BC somewhere and no periodic BCs
+    if (linear_preconditioner == GMG_PRECONDITIONER){
+        unsigned int starting_BC_list_index = 0;
+        for (unsigned int i=0; i<number_of_variables; i++){
+            unsigned int num_components = (var_type[i] == SCALAR ? 1 : dim);
+            if (var_eq_type[i] == ELLIPTIC){
+                for (unsigned int component=0; component<num_components; component++){
+                    bool has_dirichlet_BC = false;
+                    for (unsigned int direction=0; direction<2*dim; direction++){
+                        BC_type type = BC_list[starting_BC_list_index+component].var_BC_type[direction];
+                        if (type == PERIODIC){
+                            std::cerr << "PRISMS-PF Error: The GMG preconditioner can't be used with periodic BCs for an ELLIPTIC field." << std::endl;
+                            abort();
+                        }
+                        if (type == DIRICHLET || type == NON_UNIFORM_DIRICHLET){
+                            has_dirichlet_BC = true;
+                        }
+                    }
+                    if (!has_dirichlet_BC){
+                        std::cerr << "PRISMS-PF Error: The GMG preconditioner requires a Dirichlet BC on at least one boundary for each component of the ELLIPTIC fields." << std::endl;
+                        abort();
+                    }
+                }
+            }
+            starting_BC_list_index += num_components;
+        }
+    }
+
     // Load the user-defined constants
     load_user_constants(input_file_reader,parameter_handler);
 }
@@ -3,6 +3,7 @@
 
 // Constructor
 variableAttributeLoader::variableAttributeLoader(){
+    need_q_point_locations = false;
     setting_primary_field_attributes = true;
     loadVariableAttributes();
     setting_primary_field_attributes = false;
@@ -148,3 +149,24 @@ void variableAttributeLoader::set_output_integral(unsigned int index, bool flag)
     var_pair.second = flag;
     output_integral_list.push_back(var_pair);
 }
+void variableAttributeLoader::set_implicit_linear_terms(unsigned int index, bool flag){
+    std::pair<unsigned int, bool> var_pair;
+    var_pair.first = index;
+    var_pair.second = flag;
+    implicit_linear_terms_list.push_back(var_pair);
+}
+void variableAttributeLoader::set_subcycling_steps(unsigned int index, unsigned int steps){
+    std::pair<unsigned int, unsigned int> var_pair;
+    var_pair.first = index;
+    var_pair.second = steps;
+    subcycling_steps_list.push_back(var_pair);
+}
+void variableAttributeLoader::set_local_reaction_terms(unsigned int index, bool flag){
+    std::pair<unsigned int, bool> var_pair;
+    var_pair.first = index;
+    var_pair.second = flag;
+    local_reaction_terms_list.push_back(var_pair);
+}
+void variableAttributeLoader::set_need_q_point_locations(bool flag){
+    need_q_point_locations = flag;
+}
@@ -2,7 +2,7 @@
 #include "../../include/variableContainer.h"
 
 template <int dim, int degree, typename T>
-variableContainer<dim,degree,T>::variableContainer(const dealii::MatrixFree<dim,double> &data, std::vector<variable_info> _varInfoList)
+variableContainer<dim,degree,T>::variableContainer(const dealii::MatrixFree<dim,number> &data, std::vector<variable_info> _varInfoList)
 {
     varInfoList = _varInfoList;
 
@@ -11,17 +11,17 @@ variableContainer<dim,degree,T>::variableContainer(const dealii::MatrixFree<dim,
     for (unsigned int i=0; i < num_var; i++){
         if (varInfoList[i].var_needed){
             if (varInfoList[i].is_scalar){
-                dealii::FEEvaluation<dim,degree,degree+1,1,double> var(data, i);
+                dealii::FEEvaluation<dim,degree,degree+1,1,number> var(data, i);
                 scalar_vars.push_back(var);
             }
             else {
-                dealii::FEEvaluation<dim,degree,degree+1,dim,double> var(data, i);
+                dealii::FEEvaluation<dim,degree,degree+1,dim,number> var(data, i);
                 vector_vars.push_back(var);
             }
         }
     }
 
-    // Generate lists of residual types and indices, and reserve space in the temporary vectors
+    // Generate lists of residual types and indices, and allocate the storage for staged residuals
     unsigned int num_scalar_values = 0;
     unsigned int num_scalar_gradients = 0;
     unsigned int num_vector_values = 0;
@@ -66,16 +66,24 @@ variableContainer<dim,degree,T>::variableContainer(const dealii::MatrixFree<dim,
         }
     }
 
-    scalar_value.reserve(num_scalar_values);
-    scalar_gradient.reserve(num_scalar_gradients);
-    vector_value.reserve(num_vector_values);
-    vector_gradient.reserve(num_vector_gradients);
+    scalar_value.resize(num_scalar_values);
+    scalar_gradient.resize(num_scalar_gradients);
+    vector_value.resize(num_vector_values);
+    vector_gradient.resize(num_vector_gradients);
 
+    staged_scalar_values.reserve(num_scalar_values);
+    staged_scalar_gradients.reserve(num_scalar_gradients);
+    staged_vector_values.reserve(num_vector_values);
+    staged_vector_gradients.reserve(num_vector_gradients);
+
+    setup_lookup_tables();
+
+    collocation = check_collocation(data);
 }
 
 // Variant of the constructor where it reads from a fixed index of "data", used for post-processing
 template <int dim, int degree, typename T>
-variableContainer<dim,degree,T>::variableContainer(const dealii::MatrixFree<dim,double> &data, std::vector<variable_info> _varInfoList, unsigned int fixed_index)
+variableContainer<dim,degree,T>::variableContainer(const dealii::MatrixFree<dim,number> &data, std::vector<variable_info> _varInfoList, unsigned int fixed_index)
 {
     varInfoList = _varInfoList;
 
@@ -84,17 +92,17 @@ variableContainer<dim,degree,T>::variableContainer(const dealii::MatrixFree<dim,
     for (unsigned int i=0; i < num_var; i++){
         if (varInfoList[i].var_needed){
             if (varInfoList[i].is_scalar){
-                dealii::FEEvaluation<dim,degree,degree+1,1,double> var(data, fixed_index);
+                dealii::FEEvaluation<dim,degree,degree+1,1,number> var(data, fixed_index);
                 scalar_vars.push_back(var);
             }
             else {
-                dealii::FEEvaluation<dim,degree,degree+1,dim,double> var(data, fixed_index);
+                dealii::FEEvaluation<dim,degree,degree+1,dim,number> var(data, fixed_index);
                 vector_vars.push_back(var);
             }
         }
     }
 
-    // Generate lists of residual types and indices, and reserve space in the temporary vectors
+    // Generate lists of residual types and indices, and allocate the storage for staged residuals
     unsigned int num_scalar_values = 0;
     unsigned int num_scalar_gradients = 0;
     unsigned int num_vector_values = 0;
@@ -139,11 +147,70 @@ variableContainer<dim,degree,T>::variableContainer(const dealii::MatrixFree<dim,
         }
     }
 
-    scalar_value.reserve(num_scalar_values);
-    scalar_gradient.reserve(num_scalar_gradients);
-    vector_value.reserve(num_vector_values);
-    vector_gradient.reserve(num_vector_gradients);
+    scalar_value.resize(num_scalar_values);
+    scalar_gradient.resize(num_scalar_gradients);
+    vector_value.resize(num_vector_values);
+    vector_gradient.resize(num_vector_gradients);
+
+    staged_scalar_values.reserve(num_scalar_values);
+    staged_scalar_gradients.reserve(num_scalar_gradients);
+    staged_vector_values.reserve(num_vector_values);
+    staged_vector_gradients.reserve(num_vector_gradients);
+
+    setup_lookup_tables();
+
+    // The DOF values aren't read for the variables in this type of container (it only collects residuals for
+    // postprocessing), so the collocation shortcut for the integration can't be used
+    collocation = false;
+}
+
+// Fill the tables from the global variable index to the FEEvaluation objects (must be done after scalar_vars and
+// vector_vars are fully populated, since adding to them can move the objects)
+template <int dim, int degree, typename T>
+void variableContainer<dim,degree,T>::setup_lookup_tables(){
+    scalar_var_ptr.assign(num_var,NULL);
+    vector_var_ptr.assign(num_var,NULL);
+
+    for (unsigned int i=0; i < num_var; i++){
+        if (varInfoList[i].var_needed){
+            if (varInfoList[i].is_scalar){
+                scalar_var_ptr[i] = &scalar_vars[varInfoList[i].scalar_or_vector_index];
+            }
+            else {
+                vector_var_ptr[i] = &vector_vars[varInfoList[i].scalar_or_vector_index];
+            }
+        }
+    }
+}
+
+// Check whether the 1D shape functions evaluated at the 1D quadrature points form the identity matrix, i.e. whether
+// the quadrature points coincide with the nodes of the element
+template <int dim, int degree, typename T>
+bool variableContainer<dim,degree,T>::check_collocation(const dealii::MatrixFree<dim,number> &data) const {
+    const unsigned int n_q_points_1d = data.get_shape_info().n_q_points_1d;
+    if (n_q_points_1d != degree+1){
+        return false;
+    }
+    for (unsigned int i=0; i < degree+1; i++){
+        for (unsigned int q=0; q < n_q_points_1d; q++){
+            double expected_value = (i == q) ? 1.0 : 0.0;
+            if (std::abs(data.get_shape_info().shape_values[i*n_q_points_1d+q][0] - expected_value) > 100.0*std::numeric_limits<number>::epsilon()){
+                return false;
+            }
+        }
+    }
+    return true;
+}
 
+template <int dim, int degree, typename T>
+template <typename FEEvaluationType>
+void variableContainer<dim,degree,T>::integrate_values_collocation(FEEvaluationType & var) const {
+    // submit_value has already multiplied the residual by JxW, so this is the whole integration
+    T * dof_values = var.begin_dof_values();
+    const T * values = var.begin_values();
+    for (unsigned int i=0; i < var.dofs_per_cell; i++){
+        dof_values[i] = values[i];
+    }
 }
 
 template <int dim, int degree, typename T>
@@ -178,18 +245,38 @@ dealii::Point<dim, T> variableContainer<dim,degree,T>::get_q_point_location(){
 
 template <int dim, int degree, typename T>
 void variableContainer<dim,degree,T>::reinit_and_eval(const std::vector<vectorType*> &src, unsigned int cell){
+    reinit_and_eval(src, std::vector<floatVectorType*>(), cell);
+}
+
+template <int dim, int degree, typename T>
+void variableContainer<dim,degree,T>::reinit_and_eval(const std::vector<vectorType*> &src, const std::vector<floatVectorType*> &src_float, unsigned int cell){
 
     for (unsigned int i=0; i<num_var; i++){
         if (varInfoList[i].var_needed){
+            bool read_float = (i < src_float.size()) && (src_float[i] != NULL);
             if (varInfoList[i].is_scalar) {
-                scalar_vars[varInfoList[i].scalar_or_vector_index].reinit(cell);
-                scalar_vars[varInfoList[i].scalar_or_vector_index].read_dof_values(*src[i]);
-                scalar_vars[varInfoList[i].scalar_or_vector_index].evaluate(varInfoList[i].need_value, varInfoList[i].need_gradient, varInfoList[i].need_hessian);
+                scalar_var_ptr[i]->reinit(cell);
+                if (read_float){
+                    scalar_var_ptr[i]->read_dof_values(*src_float[i]);
+                }
+                else {
+                    scalar_var_ptr[i]->read_dof_values(*src[i]);
+                }
+                if (varInfoList[i].need_gradient or varInfoList[i].need_hessian or (varInfoList[i].need_value and !collocation)){
+                    scalar_var_ptr[i]->evaluate(varInfoList[i].need_value and !collocation, varInfoList[i].need_gradient, varInfoList[i].need_hessian);
+                }
             }
             else {
-                vector_vars[varInfoList[i].scalar_or_vector_index].reinit(cell);
-                vector_vars[varInfoList[i].scalar_or_vector_index].read_dof_values(*src[i]);
-                vector_vars[varInfoList[i].scalar_or_vector_index].evaluate(varInfoList[i].need_value, varInfoList[i].need_gradient, varInfoList[i].need_hessian);
+                vector_var_ptr[i]->reinit(cell);
+                if (read_float){
+                    vector_var_ptr[i]->read_dof_values(*src_float[i]);
+                }
+                else {
+                    vector_var_ptr[i]->read_dof_values(*src[i]);
+                }
+                if (varInfoList[i].need_gradient or varInfoList[i].need_hessian or (varInfoList[i].need_value and !collocation)){
+                    vector_var_ptr[i]->evaluate(varInfoList[i].need_value and !collocation, varInfoList[i].need_gradient, varInfoList[i].need_hessian);
+                }
             }
         }
     }
@@ -197,28 +284,61 @@ void variableContainer<dim,degree,T>::reinit_and_eval(const std::vector<vectorTy
 
 template <int dim, int degree, typename T>
 void variableContainer<dim,degree,T>::reinit_and_eval_LHS(const vectorType &src, const std::vector<vectorType*> solutionSet, unsigned int cell, unsigned int var_being_solved){
+    reinit_and_eval_LHS(src, solutionSet, std::vector<floatVectorType*>(), cell, var_being_solved);
+}
+
+template <int dim, int degree, typename T>
+void variableContainer<dim,degree,T>::reinit_and_eval_LHS(const vectorType &src, const std::vector<vectorType*> &solutionSet, const std::vector<floatVectorType*> &solutionSet_float, unsigned int cell, unsigned int var_being_solved){
+    reinit_and_eval_LHS(&src, solutionSet, solutionSet_float, cell, var_being_solved);
+}
+
+template <int dim, int degree, typename T>
+void variableContainer<dim,degree,T>::reinit_LHS_unit_vector(const std::vector<vectorType*> &solutionSet, const std::vector<floatVectorType*> &solutionSet_float, unsigned int cell, unsigned int var_being_solved){
+    reinit_and_eval_LHS(NULL, solutionSet, solutionSet_float, cell, var_being_solved);
+}
+
+// The DOF values of the variable being solved are read from src, or if it is NULL, it is only initialized for the cell
+template <int dim, int degree, typename T>
+void variableContainer<dim,degree,T>::reinit_and_eval_LHS(const vectorType *src, const std::vector<vectorType*> &solutionSet, const std::vector<floatVectorType*> &solutionSet_float, unsigned int cell, unsigned int var_being_solved){
 
     for (unsigned int i=0; i<num_var; i++){
         if (varInfoList[i].var_needed){
+            bool read_float = (i < solutionSet_float.size()) && (solutionSet_float[i] != NULL);
             if (varInfoList[i].is_scalar) {
-                scalar_vars[varInfoList[i].scalar_or_vector_index].reinit(cell);
+                scalar_var_ptr[i]->reinit(cell);
                 if (i == var_being_solved ){
-                    scalar_vars[varInfoList[i].scalar_or_vector_index].read_dof_values(src);
+                    if (src == NULL){
+                        continue;
+                    }
+                    scalar_var_ptr[i]->read_dof_values(*src);
+                }
+                else if (read_float){
+                    scalar_var_ptr[i]->read_dof_values(*solutionSet_float[i]);
                 }
                 else{
-                    scalar_vars[varInfoList[i].scalar_or_vector_index].read_dof_values(*solutionSet[i]);
+                    scalar_var_ptr[i]->read_dof_values(*solutionSet[i]);
+                }
+                if (varInfoList[i].need_gradient or varInfoList[i].need_hessian or (varInfoList[i].need_value and !collocation)){
+                    scalar_var_ptr[i]->evaluate(varInfoList[i].need_value and !collocation, varInfoList[i].need_gradient, varInfoList[i].need_hessian);
                 }
-                scalar_vars[varInfoList[i].scalar_or_vector_index].evaluate(varInfoList[i].need_value, varInfoList[i].need_gradient, varInfoList[i].need_hessian);
             }
             else {
-                vector_vars[varInfoList[i].scalar_or_vector_index].reinit(cell);
+                vector_var_ptr[i]->reinit(cell);
                 if (i == var_being_solved){
-                    vector_vars[varInfoList[i].scalar_or_vector_index].read_dof_values(src);
+                    if (src == NULL){
+                        continue;
+                    }
+                    vector_var_ptr[i]->read_dof_values(*src);
+                }
+                else if (read_float){
+                    vector_var_ptr[i]->read_dof_values(*solutionSet_float[i]);
                 }
                 else {
-                    vector_vars[varInfoList[i].scalar_or_vector_index].read_dof_values(*solutionSet[i]);
+                    vector_var_ptr[i]->read_dof_values(*solutionSet[i]);
+                }
+                if (varInfoList[i].need_gradient or varInfoList[i].need_hessian or (varInfoList[i].need_value and !collocation)){
+                    vector_var_ptr[i]->evaluate(varInfoList[i].need_value and !collocation, varInfoList[i].need_gradient, varInfoList[i].need_hessian);
                 }
-                vector_vars[varInfoList[i].scalar_or_vector_index].evaluate(varInfoList[i].need_value, varInfoList[i].need_gradient, varInfoList[i].need_hessian);
             }
         }
     }
@@ -231,10 +351,10 @@ void variableContainer<dim,degree,T>::reinit(unsigned int cell){
     for (unsigned int i=0; i<num_var; i++){
         if (varInfoList[i].var_needed){
             if (varInfoList[i].is_scalar) {
-                scalar_vars[varInfoList[i].scalar_or_vector_index].reinit(cell);
+                scalar_var_ptr[i]->reinit(cell);
             }
             else {
-                vector_vars[varInfoList[i].scalar_or_vector_index].reinit(cell);
+                vector_var_ptr[i]->reinit(cell);
             }
         }
     }
@@ -242,16 +362,33 @@ void variableContainer<dim,degree,T>::reinit(unsigned int cell){
 
 
 template <int dim, int degree, typename T>
-void variableContainer<dim,degree,T>::integrate_and_distribute(std::vector<vectorType*> &dst){
+void variableContainer<dim,degree,T>::integrate_and_distribute(std::vector<vectorType*> &dst, const std::vector<bool> * var_subset){
 
     for (unsigned int i=0; i<num_var; i++){
+        if (var_subset != NULL && !(*var_subset)[i]){
+            continue;
+        }
+
+        // The collocation shortcut is only used for variables whose DOF values were read for this cell
+        bool value_residual_only = collocation and varInfoList[i].var_needed and varInfoList[i].value_residual and !varInfoList[i].gradient_residual;
+
         if (varInfoList[i].is_scalar) {
-            scalar_vars[varInfoList[i].scalar_or_vector_index].integrate(varInfoList[i].value_residual, varInfoList[i].gradient_residual);
-            scalar_vars[varInfoList[i].scalar_or_vector_index].distribute_local_to_global(*dst[i]);
+            if (value_residual_only){
+                integrate_values_collocation(*scalar_var_ptr[i]);
+            }
+            else {
+                scalar_var_ptr[i]->integrate(varInfoList[i].value_residual, varInfoList[i].gradient_residual);
+            }
+            scalar_var_ptr[i]->distribute_local_to_global(*dst[i]);
         }
         else {
-            vector_vars[varInfoList[i].scalar_or_vector_index].integrate(varInfoList[i].value_residual, varInfoList[i].gradient_residual);
-            vector_vars[varInfoList[i].scalar_or_vector_index].distribute_local_to_global(*dst[i]);
+            if (value_residual_only){
+                integrate_values_collocation(*vector_var_ptr[i]);
+            }
+            else {
+                vector_var_ptr[i]->integrate(varInfoList[i].value_residual, varInfoList[i].gradient_residual);
+            }
+            vector_var_ptr[i]->distribute_local_to_global(*dst[i]);
         }
     }
 
@@ -260,154 +397,128 @@ void variableContainer<dim,degree,T>::integrate_and_distribute(std::vector<vecto
 template <int dim, int degree, typename T>
 void variableContainer<dim,degree,T>::integrate_and_distribute_LHS(vectorType &dst, unsigned int var_being_solved){
 
+    // The collocation shortcut is only used if the DOF values of the variable were read for this cell
+    const variable_info & varInfo = varInfoList[var_being_solved];
+    bool value_residual_only = collocation and varInfo.var_needed and varInfo.value_residual and !varInfo.gradient_residual;
+
     //integrate
-    if (varInfoList[var_being_solved].is_scalar) {
-    	scalar_vars[varInfoList[var_being_solved].scalar_or_vector_index].integrate(varInfoList[var_being_solved].value_residual, varInfoList[var_being_solved].gradient_residual);
-    	scalar_vars[varInfoList[var_being_solved].scalar_or_vector_index].distribute_local_to_global(dst);
+    if (varInfo.is_scalar) {
+    	if (value_residual_only){
+    		integrate_values_collocation(*scalar_var_ptr[var_being_solved]);
+    	}
+    	else {
+    		scalar_var_ptr[var_being_solved]->integrate(varInfo.value_residual, varInfo.gradient_residual);
+    	}
+    	scalar_var_ptr[var_being_solved]->distribute_local_to_global(dst);
     }
     else {
-    	vector_vars[varInfoList[var_being_solved].scalar_or_vector_index].integrate(varInfoList[var_being_solved].value_residual, varInfoList[var_being_solved].gradient_residual);
-    	vector_vars[varInfoList[var_being_solved].scalar_or_vector_index].distribute_local_to_global(dst);
+    	if (value_residual_only){
+    		integrate_values_collocation(*vector_var_ptr[var_being_solved]);
+    	}
+    	else {
+    		vector_var_ptr[var_being_solved]->integrate(varInfo.value_residual, varInfo.gradient_residual);
+    	}
+    	vector_var_ptr[var_being_solved]->distribute_local_to_global(dst);
     }
 }
 
-// Need to add index checking to these functions so that an error is thrown if the index wasn't set
+// Set the DOF values of the variable being solved to the unit vector of one of its DOFs on the cell (in every lane of
+// the cell batch) and evaluate it. The other variables keep the values from reinit_LHS_unit_vector.
 template <int dim, int degree, typename T>
-T variableContainer<dim,degree,T>::get_scalar_value(unsigned int global_variable_index) const
-{
-    if (varInfoList[global_variable_index].need_value){
-        return scalar_vars[varInfoList[global_variable_index].scalar_or_vector_index].get_value(q_point);
-    }
-    else {
-        std::cerr << "PRISMS-PF Error: Attempted access of a variable value that was not marked as needed in 'parameters.in'. Double-check the indices in user functions where a variable value is requested." << std::endl;
-        abort();
-    }
-}
+void variableContainer<dim,degree,T>::eval_LHS_unit_vector(unsigned int var_being_solved, unsigned int dof){
 
-template <int dim, int degree, typename T>
-dealii::Tensor<1, dim, T > variableContainer<dim,degree,T>::get_scalar_gradient(unsigned int global_variable_index) const
-{
-    if (varInfoList[global_variable_index].need_gradient){
-        return scalar_vars[varInfoList[global_variable_index].scalar_or_vector_index].get_gradient(q_point);
-    }
-    else {
-        std::cerr << "PRISMS-PF Error: Attempted access of a variable value that was not marked as needed in 'parameters.in'. Double-check the indices in user functions where a variable value is requested." << std::endl;
-        abort();
-    }
-}
+    const variable_info & varInfo = varInfoList[var_being_solved];
+    bool need_evaluate = varInfo.need_gradient or varInfo.need_hessian or (varInfo.need_value and !collocation);
 
-template <int dim, int degree, typename T>
-dealii::Tensor<2, dim, T > variableContainer<dim,degree,T>::get_scalar_hessian(unsigned int global_variable_index) const
-{
-    if (varInfoList[global_variable_index].need_hessian){
-        return scalar_vars[varInfoList[global_variable_index].scalar_or_vector_index].get_hessian(q_point);
+    if (varInfo.is_scalar) {
+        T * dof_values = scalar_var_ptr[var_being_solved]->begin_dof_values();
+        for (unsigned int i=0; i < scalar_var_ptr[var_being_solved]->dofs_per_cell; i++){
+            dof_values[i] = (i == dof) ? 1.0 : 0.0;
+        }
+        if (need_evaluate){
+            scalar_var_ptr[var_being_solved]->evaluate(varInfo.need_value and !collocation, varInfo.need_gradient, varInfo.need_hessian);
+        }
     }
     else {
-        std::cerr << "PRISMS-PF Error: Attempted access of a variable value that was not marked as needed in 'parameters.in'. Double-check the indices in user functions where a variable value is requested." << std::endl;
-        abort();
+        T * dof_values = vector_var_ptr[var_being_solved]->begin_dof_values();
+        for (unsigned int i=0; i < vector_var_ptr[var_being_solved]->dofs_per_cell; i++){
+            dof_values[i] = (i == dof) ? 1.0 : 0.0;
+        }
+        if (need_evaluate){
+            vector_var_ptr[var_being_solved]->evaluate(varInfo.need_value and !collocation, varInfo.need_gradient, varInfo.need_hessian);
+        }
     }
 }
 
+// Integrate the residual of the unit vector set by eval_LHS_unit_vector and return its entry for the same DOF, the
+// diagonal entry of the cell matrix
 template <int dim, int degree, typename T>
-dealii::Tensor<1, dim, T > variableContainer<dim,degree,T>::get_vector_value(unsigned int global_variable_index) const
-{
-    if (varInfoList[global_variable_index].need_value){
-        return vector_vars[varInfoList[global_variable_index].scalar_or_vector_index].get_value(q_point);
+T variableContainer<dim,degree,T>::integrate_LHS_unit_vector(unsigned int var_being_solved, unsigned int dof){
+
+    const variable_info & varInfo = varInfoList[var_being_solved];
+    bool value_residual_only = collocation and varInfo.value_residual and !varInfo.gradient_residual;
+
+    if (varInfo.is_scalar) {
+        if (value_residual_only){
+            integrate_values_collocation(*scalar_var_ptr[var_being_solved]);
+        }
+        else {
+            scalar_var_ptr[var_being_solved]->integrate(varInfo.value_residual, varInfo.gradient_residual);
+        }
+        return scalar_var_ptr[var_being_solved]->begin_dof_values()[dof];
     }
     else {
-        std::cerr << "PRISMS-PF Error: Attempted access of a variable value that was not marked as needed in 'parameters.in'. Double-check the indices in user functions where a variable value is requested." << std::endl;
-        abort();
+        if (value_residual_only){
+            integrate_values_collocation(*vector_var_ptr[var_being_solved]);
+        }
+        else {
+            vector_var_ptr[var_being_solved]->integrate(varInfo.value_residual, varInfo.gradient_residual);
+        }
+        return vector_var_ptr[var_being_solved]->begin_dof_values()[dof];
     }
 }
 
+// Distribute the diagonal entries of the cell matrix (from integrate_LHS_unit_vector) from local to global
 template <int dim, int degree, typename T>
-dealii::Tensor<2, dim, T > variableContainer<dim,degree,T>::get_vector_gradient(unsigned int global_variable_index) const
-{
-    if (varInfoList[global_variable_index].need_gradient){
-        return vector_vars[varInfoList[global_variable_index].scalar_or_vector_index].get_gradient(q_point);
+void variableContainer<dim,degree,T>::distribute_LHS_diagonal(vectorType &dst, unsigned int var_being_solved, const dealii::AlignedVector<T> &diagonal){
+
+    if (varInfoList[var_being_solved].is_scalar) {
+        T * dof_values = scalar_var_ptr[var_being_solved]->begin_dof_values();
+        for (unsigned int i=0; i < scalar_var_ptr[var_being_solved]->dofs_per_cell; i++){
+            dof_values[i] = diagonal[i];
+        }
+        scalar_var_ptr[var_being_solved]->distribute_local_to_global(dst);
     }
     else {
-        std::cerr << "PRISMS-PF Error: Attempted access of a variable value that was not marked as needed in 'parameters.in'. Double-check the indices in user functions where a variable value is requested." << std::endl;
-        abort();
+        T * dof_values = vector_var_ptr[var_being_solved]->begin_dof_values();
+        for (unsigned int i=0; i < vector_var_ptr[var_being_solved]->dofs_per_cell; i++){
+            dof_values[i] = diagonal[i];
+        }
+        vector_var_ptr[var_being_solved]->distribute_local_to_global(dst);
     }
 }
 
 template <int dim, int degree, typename T>
-dealii::Tensor<3, dim, T > variableContainer<dim,degree,T>::get_vector_hessian(unsigned int global_variable_index) const
-{
-    if (varInfoList[global_variable_index].need_hessian){
-        return vector_vars[varInfoList[global_variable_index].scalar_or_vector_index].get_hessian(q_point);
+unsigned int variableContainer<dim,degree,T>::get_dofs_per_cell(unsigned int global_variable_index) const {
+    if (varInfoList[global_variable_index].is_scalar){
+        return scalar_var_ptr[global_variable_index]->dofs_per_cell;
     }
     else {
-        std::cerr << "PRISMS-PF Error: Attempted access of a variable value that was not marked as needed in 'parameters.in'. Double-check the indices in user functions where a variable value is requested." << std::endl;
-        abort();
+        return vector_var_ptr[global_variable_index]->dofs_per_cell;
     }
 }
 
-template <int dim, int degree, typename T>
-void variableContainer<dim,degree,T>::set_scalar_value_residual_term(unsigned int global_variable_index, T val){
-    scalar_vars[varInfoList[global_variable_index].scalar_or_vector_index].submit_value(val,q_point);
-
-    // Hold-over from previous version that caches the residual terms instead of over-writing what's in scalar_vars.
-    // This approach was abandoned because it caused a 20% decrease in speed.
-    //scalar_value[scalar_value_index[global_variable_index]] = val;
-}
-
-template <int dim, int degree, typename T>
-void variableContainer<dim,degree,T>::set_scalar_gradient_residual_term(unsigned int global_variable_index, dealii::Tensor<1, dim, T > grad){
-    scalar_vars[varInfoList[global_variable_index].scalar_or_vector_index].submit_gradient(grad,q_point);
-
-    // Hold-over from previous version that caches the residual terms instead of over-writing what's in scalar_vars.
-    // This approach was abandoned because it caused a 20% decrease in speed.
-    //scalar_gradient[scalar_gradient_index[global_variable_index]] = grad;
-}
-
-template <int dim, int degree, typename T>
-void variableContainer<dim,degree,T>::set_vector_value_residual_term(unsigned int global_variable_index, dealii::Tensor<1, dim, T > val){
-    vector_vars[varInfoList[global_variable_index].scalar_or_vector_index].submit_value(val,q_point);
-
-    // Hold-over from previous version that caches the residual terms instead of over-writing what's in vector_vars.
-    // This approach was abandoned because it caused a 20% decrease in speed.
-    //vector_value[vector_value_index[global_variable_index]] = val;
-}
-template <int dim, int degree, typename T>
-void variableContainer<dim,degree,T>::set_vector_gradient_residual_term(unsigned int global_variable_index, dealii::Tensor<2, dim, T > grad){
-    vector_vars[varInfoList[global_variable_index].scalar_or_vector_index].submit_gradient(grad,q_point);
-
-    // Hold-over from previous version that caches the residual terms instead of over-writing what's in vector_vars.
-    // This approach was abandoned because it caused a 20% decrease in speed.
-    //vector_gradient[vector_gradient_index[global_variable_index]] = grad;
-}
-
-
-// Hold-over from previous version that caches the residual terms instead of over-writing what's in vector_vars.
-// This approach was abandoned because it caused a 20% decrease in speed.
-// template <int dim, int degree, typename T>
-// void variableContainer<dim,degree,T>::apply_residuals(){
-//
-//     for (unsigned int i=0; i<num_var; i++){
-//         if (varInfoList[i].is_scalar){
-//             if (varInfoList[i].value_residual){
-//                 scalar_vars[varInfoList[i].scalar_or_vector_index].submit_value(scalar_value[scalar_value_index[i]],q_point);
-//             }
-//             if (varInfoList[i].gradient_residual){
-//                 scalar_vars[varInfoList[i].scalar_or_vector_index].submit_gradient(scalar_gradient[scalar_gradient_index[i]],q_point);
-//             }
-//         }
-//         else {
-//             if (varInfoList[i].value_residual){
-//                 vector_vars[varInfoList[i].scalar_or_vector_index].submit_value(vector_value[vector_value_index[i]],q_point);
-//             }
-//             if (varInfoList[i].gradient_residual){
-//                 vector_vars[varInfoList[i].scalar_or_vector_index].submit_gradient(vector_gradient[vector_gradient_index[i]],q_point);
-//             }
-//         }
-//     }
-// }
-
 template class variableContainer<2,1,dealii::VectorizedArray<double> >;
 template class variableContainer<2,2,dealii::VectorizedArray<double> >;
 template class variableContainer<2,3,dealii::VectorizedArray<double> >;
 template class variableContainer<3,1,dealii::VectorizedArray<double> >;
 template class variableContainer<3,2,dealii::VectorizedArray<double> >;
 template class variableContainer<3,3,dealii::VectorizedArray<double> >;
+
+// Single precision instantiations, used for the optional single precision residual evaluation
+template class variableContainer<2,1,dealii::VectorizedArray<float> >;
+template class variableContainer<2,2,dealii::VectorizedArray<float> >;
+template class variableContainer<2,3,dealii::VectorizedArray<float> >;
+template class variableContainer<3,1,dealii::VectorizedArray<float> >;
+template class variableContainer<3,2,dealii::VectorizedArray<float> >;
+template class variableContainer<3,3,dealii::VectorizedArray<float> >;
@@ -58,6 +58,30 @@ int main(int argc, char **argv)
   pass = setOutputTimeSteps_tester_eq.test_setOutputTimeSteps();
   tests_passed += pass;
 
+  // Unit tests for the Butcher tableaus of the adaptive time integration schemes
+  total_tests++;
+  unitTest<2,double> embeddedRungeKuttaTableau_tester;
+  pass = embeddedRungeKuttaTableau_tester.test_embeddedRungeKuttaTableau();
+  tests_passed += pass;
+
+  // Unit tests for the coefficients of the Adams-Bashforth time integration schemes
+  total_tests++;
+  unitTest<2,double> adamsBashforthCoefficients_tester;
+  pass = adamsBashforthCoefficients_tester.test_adamsBashforthCoefficients();
+  tests_passed += pass;
+
+  // Unit tests for the dense matrix functions of the exponential time differencing schemes
+  total_tests++;
+  unitTest<2,double> krylovPhiFunctions_tester;
+  pass = krylovPhiFunctions_tester.test_krylovPhiFunctions();
+  tests_passed += pass;
+
+  // Unit tests for the dense symmetric matrix functions of the ELLIPTIC solves
+  total_tests++;
+  unitTest<2,double> denseSymmetricFunctions_tester;
+  pass = denseSymmetricFunctions_tester.test_denseSymmetricFunctions();
+  tests_passed += pass;
+
   // Unit tests for the method "computeInvM"
   total_tests++;
   unitTest<2,double> computeInvM_tester_2D;
@@ -0,0 +1,45 @@
+// Unit test(s) for the function "adamsBashforthCoefficients"
+
+template <int dim,typename T>
+  bool unitTest<dim,T>::test_adamsBashforthCoefficients(){
+	bool pass = false;
+	char buffer[100];
+
+	std::cout << "\nTesting 'adamsBashforthCoefficients'... " << std::endl;
+
+	const double tol = 1.0e-12;
+	const unsigned int max_order = 3;
+	std::vector<bool> pass_subtest(max_order,true);
+
+	for (unsigned int order=1; order<=max_order; order++){
+		std::vector<double> beta = adamsBashforthCoefficients(order);
+
+		if (beta.size() != order){
+			pass_subtest[order-1] = false;
+		}
+		else {
+			// A method of order p integrates polynomial rates of degree p-1 exactly over a step, which (with the rate
+			// from j steps back at t = -j) gives sum_j beta_j*(-j)^m = 1/(m+1) for m = 0,...,p-1
+			for (unsigned int m=0; m<order; m++){
+				double sum = 0.0;
+				for (unsigned int j=0; j<order; j++){
+					sum += beta[j]*std::pow(-1.0*j,(double)m);
+				}
+				if (std::abs(sum - 1.0/(m+1.0)) > tol){
+					pass_subtest[order-1] = false;
+				}
+			}
+		}
+
+		sprintf (buffer, "Subtest %u result for 'adamsBashforthCoefficients': %u\n", order, (unsigned int)pass_subtest[order-1]);
+		std::cout << buffer;
+	}
+
+	// Check if all subtests passed
+	if (pass_subtest[0]&&pass_subtest[1]&&pass_subtest[2]) {pass=true;}
+
+	sprintf (buffer, "Test result for 'adamsBashforthCoefficients': %u\n", pass);
+	std::cout << buffer;
+
+	return pass;
+}
@@ -0,0 +1,102 @@
+// Unit test(s) for the functions in "denseSymmetricFunctions.h"
+
+template <int dim,typename T>
+  bool unitTest<dim,T>::test_denseSymmetricFunctions(){
+	bool pass = false;
+	char buffer[100];
+
+	std::cout << "\nTesting 'denseSymmetricFunctions'... " << std::endl;
+
+	const double tol = 1.0e-10;
+	std::vector<bool> pass_subtest(3,true);
+
+	// Subtest 1: the eigenvalues of the second difference matrix tridiag(-1,2,-1) of size n are
+	// 2-2*cos(k*pi/(n+1)), and A*v = lambda*v for each eigenvector
+	{
+		const unsigned int n = 6;
+		denseMatrix A(n, std::vector<double>(n,0.0));
+		for (unsigned int i=0; i<n; i++){
+			A[i][i] = 2.0;
+			if (i > 0){
+				A[i][i-1] = -1.0;
+				A[i-1][i] = -1.0;
+			}
+		}
+		std::vector<double> eigenvalues;
+		denseMatrix eigenvectors;
+		denseSymmetricEigen(A, eigenvalues, eigenvectors);
+		for (unsigned int k=0; k<n; k++){
+			if (std::abs(eigenvalues[k] - (2.0 - 2.0*std::cos((k+1)*M_PI/(n+1)))) > tol){
+				pass_subtest[0] = false;
+			}
+			for (unsigned int i=0; i<n; i++){
+				double Av = 0.0;
+				for (unsigned int j=0; j<n; j++){
+					Av += A[i][j]*eigenvectors[j][k];
+				}
+				if (std::abs(Av - eigenvalues[k]*eigenvectors[i][k]) > tol){
+					pass_subtest[0] = false;
+				}
+			}
+		}
+	}
+	sprintf (buffer, "Subtest 1 result for 'denseSymmetricFunctions': %u\n", (unsigned int)pass_subtest[0]);
+	std::cout << buffer;
+
+	// Subtest 2: the Cholesky factor of [[4,2,-2],[2,10,2],[-2,2,6]] is [[2,0,0],[1,3,0],[-1,1,2]], and the solve
+	// recovers x = (1,-1,2) from A*x
+	{
+		denseMatrix A(3, std::vector<double>(3,0.0));
+		A[0][0] = 4.0; A[0][1] = 2.0; A[0][2] = -2.0;
+		A[1][0] = 2.0; A[1][1] = 10.0; A[1][2] = 2.0;
+		A[2][0] = -2.0; A[2][1] = 2.0; A[2][2] = 6.0;
+		denseMatrix L = A;
+		const double L_expected[3][3] = {{2.0,0.0,0.0},{1.0,3.0,0.0},{-1.0,1.0,2.0}};
+		if (!denseCholesky(L)){
+			pass_subtest[1] = false;
+		}
+		else {
+			for (unsigned int i=0; i<3; i++){
+				for (unsigned int j=0; j<3; j++){
+					if (std::abs(L[i][j] - L_expected[i][j]) > tol){
+						pass_subtest[1] = false;
+					}
+				}
+			}
+			const double x_expected[3] = {1.0,-1.0,2.0};
+			std::vector<double> b(3,0.0);
+			for (unsigned int i=0; i<3; i++){
+				for (unsigned int j=0; j<3; j++){
+					b[i] += A[i][j]*x_expected[j];
+				}
+			}
+			std::vector<double> x = denseCholeskySolve(L, b);
+			for (unsigned int i=0; i<3; i++){
+				if (std::abs(x[i] - x_expected[i]) > tol){
+					pass_subtest[1] = false;
+				}
+			}
+		}
+	}
+	sprintf (buffer, "Subtest 2 result for 'denseSymmetricFunctions': %u\n", (unsigned int)pass_subtest[1]);
+	std::cout << buffer;
+
+	// Subtest 3: an indefinite matrix has no Cholesky factor
+	{
+		denseMatrix A(2, std::vector<double>(2,1.0));
+		A[1][1] = 0.5;
+		if (denseCholesky(A)){
+			pass_subtest[2] = false;
+		}
+	}
+	sprintf (buffer, "Subtest 3 result for 'denseSymmetricFunctions': %u\n", (unsigned int)pass_subtest[2]);
+	std::cout << buffer;
+
+	// Check if all subtests passed
+	if (pass_subtest[0]&&pass_subtest[1]&&pass_subtest[2]) {pass=true;}
+
+	sprintf (buffer, "Test result for 'denseSymmetricFunctions': %u\n", pass);
+	std::cout << buffer;
+
+	return pass;
+}
@@ -0,0 +1,92 @@
+// Unit test(s) for the class "embeddedRungeKuttaTableau"
+
+template <int dim,typename T>
+  bool unitTest<dim,T>::test_embeddedRungeKuttaTableau(){
+	bool pass = false;
+	char buffer[100];
+
+	std::cout << "\nTesting 'embeddedRungeKuttaTableau'... " << std::endl;
+
+	std::vector<timeIntegrationScheme> schemes;
+	schemes.push_back(BOGACKI_SHAMPINE_32);
+	schemes.push_back(DORMAND_PRINCE_54);
+
+	const double tol = 1.0e-12;
+	std::vector<bool> pass_subtest(schemes.size(),true);
+
+	for (unsigned int s=0; s<schemes.size(); s++){
+		embeddedRungeKuttaTableau tableau(schemes[s]);
+		const unsigned int order = tableau.embedded_order+1;
+
+		// The stages are explicit and the rows of a add up to c
+		for (unsigned int i=0; i<tableau.num_stages; i++){
+			double row_sum = 0.0;
+			for (unsigned int j=0; j<tableau.num_stages; j++){
+				if (j >= i && tableau.a[i][j] != 0.0){
+					pass_subtest[s] = false;
+				}
+				row_sum += tableau.a[i][j];
+			}
+			if (std::abs(row_sum - tableau.c[i]) > tol){
+				pass_subtest[s] = false;
+			}
+		}
+
+		// First same as last: the last row of a is b and the last stage is at the end of the step
+		for (unsigned int j=0; j<tableau.num_stages; j++){
+			if (std::abs(tableau.a[tableau.num_stages-1][j] - tableau.b[j]) > tol){
+				pass_subtest[s] = false;
+			}
+		}
+		if (std::abs(tableau.c[tableau.num_stages-1] - 1.0) > tol){
+			pass_subtest[s] = false;
+		}
+
+		// Quadrature order conditions, sum_i b_i c_i^(k-1) = 1/k, for the solution and for the embedded solution
+		for (unsigned int k=1; k<=order; k++){
+			double sum_b = 0.0;
+			double sum_b_hat = 0.0;
+			for (unsigned int i=0; i<tableau.num_stages; i++){
+				sum_b += tableau.b[i]*std::pow(tableau.c[i],k-1.0);
+				sum_b_hat += tableau.b_hat[i]*std::pow(tableau.c[i],k-1.0);
+			}
+			if (std::abs(sum_b - 1.0/k) > tol){
+				pass_subtest[s] = false;
+			}
+			if (k <= tableau.embedded_order && std::abs(sum_b_hat - 1.0/k) > tol){
+				pass_subtest[s] = false;
+			}
+		}
+
+		// Third order condition that isn't a quadrature condition, sum_ij b_i a_ij c_j = 1/6
+		double sum_bac = 0.0;
+		for (unsigned int i=0; i<tableau.num_stages; i++){
+			for (unsigned int j=0; j<tableau.num_stages; j++){
+				sum_bac += tableau.b[i]*tableau.a[i][j]*tableau.c[j];
+			}
+		}
+		if (std::abs(sum_bac - 1.0/6.0) > tol){
+			pass_subtest[s] = false;
+		}
+
+		// The embedded solution is a different solution, otherwise the error estimate would be zero
+		double diff = 0.0;
+		for (unsigned int i=0; i<tableau.num_stages; i++){
+			diff += std::abs(tableau.b[i] - tableau.b_hat[i]);
+		}
+		if (diff < tol){
+			pass_subtest[s] = false;
+		}
+
+		sprintf (buffer, "Subtest %u result for 'embeddedRungeKuttaTableau': %u\n", s+1, (unsigned int)pass_subtest[s]);
+		std::cout << buffer;
+	}
+
+	// Check if all subtests passed
+	if (pass_subtest[0]&&pass_subtest[1]) {pass=true;}
+
+	sprintf (buffer, "Test result for 'embeddedRungeKuttaTableau': %u\n", pass);
+	std::cout << buffer;
+
+	return pass;
+}
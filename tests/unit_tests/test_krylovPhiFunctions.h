@@ -0,0 +1,73 @@
+// Unit test(s) for the functions in "krylovPhiFunctions.h"
+
+template <int dim,typename T>
+  bool unitTest<dim,T>::test_krylovPhiFunctions(){
+	bool pass = false;
+	char buffer[100];
+
+	std::cout << "\nTesting 'krylovPhiFunctions'... " << std::endl;
+
+	const double tol = 1.0e-10;
+	std::vector<bool> pass_subtest(3,true);
+
+	// Subtest 1: the exponential of a defective matrix [[a,1],[0,a]] is exp(a)*[[1,1],[0,1]], with a large enough
+	// norm that scaling and squaring is needed
+	{
+		const double a = -20.0;
+		denseMatrix A(2, std::vector<double>(2,0.0));
+		A[0][0] = a; A[0][1] = 1.0; A[1][1] = a;
+		denseMatrix E = denseMatrixExponential(A);
+		const double scale = std::exp(a);
+		if (std::abs(E[0][0]/scale - 1.0) > tol || std::abs(E[0][1]/scale - 1.0) > tol || std::abs(E[1][0]) > tol*scale || std::abs(E[1][1]/scale - 1.0) > tol){
+			pass_subtest[0] = false;
+		}
+	}
+	sprintf (buffer, "Subtest 1 result for 'krylovPhiFunctions': %u\n", (unsigned int)pass_subtest[0]);
+	std::cout << buffer;
+
+	// Subtest 2: phi_1 and phi_2 of a scalar, compared with the closed forms (exp(z)-1)/z and (exp(z)-1-z)/z^2 (and
+	// their limits 1 and 1/2 at zero)
+	{
+		const double z_values[] = {-50.0, -1.0, -1.0e-3, 0.0, 0.5, 3.0};
+		for (unsigned int i=0; i<6; i++){
+			const double z = z_values[i];
+			denseMatrix B(1, std::vector<double>(1,z));
+			std::vector<std::vector<double> > phi = phiFunctionsTimesFirstUnitVector(B, 2);
+			double phi_1 = 1.0;
+			double phi_2 = 0.5;
+			if (std::abs(z) > 1.0e-2){
+				phi_1 = (std::exp(z)-1.0)/z;
+				phi_2 = (std::exp(z)-1.0-z)/(z*z);
+			}
+			else {
+				phi_1 = 1.0 + z/2.0 + z*z/6.0 + z*z*z/24.0;
+				phi_2 = 0.5 + z/6.0 + z*z/24.0 + z*z*z/120.0;
+			}
+			if (std::abs(phi[0][0] - phi_1) > tol*std::max(1.0,std::abs(phi_1)) || std::abs(phi[1][0] - phi_2) > tol*std::max(1.0,std::abs(phi_2))){
+				pass_subtest[1] = false;
+			}
+		}
+	}
+	sprintf (buffer, "Subtest 2 result for 'krylovPhiFunctions': %u\n", (unsigned int)pass_subtest[1]);
+	std::cout << buffer;
+
+	// Subtest 3: for a diagonal matrix only the first entry of phi_k(B)*e_1 is nonzero
+	{
+		denseMatrix B(3, std::vector<double>(3,0.0));
+		B[0][0] = -2.0; B[1][1] = -7.0; B[2][2] = 1.0;
+		std::vector<std::vector<double> > phi = phiFunctionsTimesFirstUnitVector(B, 1);
+		if (std::abs(phi[0][0] - (std::exp(-2.0)-1.0)/(-2.0)) > tol || std::abs(phi[0][1]) > tol || std::abs(phi[0][2]) > tol){
+			pass_subtest[2] = false;
+		}
+	}
+	sprintf (buffer, "Subtest 3 result for 'krylovPhiFunctions': %u\n", (unsigned int)pass_subtest[2]);
+	std::cout << buffer;
+
+	// Check if all subtests passed
+	if (pass_subtest[0]&&pass_subtest[1]&&pass_subtest[2]) {pass=true;}
+
+	sprintf (buffer, "Test result for 'krylovPhiFunctions': %u\n", pass);
+	std::cout << buffer;
+
+	return pass;
+}
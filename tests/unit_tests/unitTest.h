@@ -66,6 +66,23 @@ void computeStress(const dealii::Table<2, double>& CIJ, const dealii::Vectorized
 #include "../../src/matrixfree/computeIntegral.cc"
 #include "../../src/matrixfree/nucleation.cc"
 #include "../../src/matrixfree/checkpoint.cc"
+#include "../../src/matrixfree/explicitUpdate.cc"
+#include "../../src/matrixfree/singlePrecisionFields.cc"
+#include "../../src/matrixfree/traceVariableNeeds.cc"
+#include "../../src/matrixfree/timeIntegration.cc"
+#include "../../src/matrixfree/adaptiveTimeStepping.cc"
+#include "../../src/matrixfree/semiImplicitUpdate.cc"
+#include "../../src/matrixfree/implicitTimeStepping.cc"
+#include "../../src/matrixfree/localTimeStepping.cc"
+#include "../../src/matrixfree/multirateTimeStepping.cc"
+#include "../../src/matrixfree/exponentialTimeDifferencing.cc"
+#include "../../src/matrixfree/localReactions.cc"
+#include "../../src/matrixfree/parareal.cc"
+#include "../../src/matrixfree/blowUpRecovery.cc"
+#include "../../src/matrixfree/steadyState.cc"
+#include "../../src/matrixfree/multigrid.cc"
+#include "../../src/matrixfree/diagonalPreconditioner.cc"
+#include "../../src/matrixfree/ellipticInitialGuess.cc"
 
 #include "../../src/inputFileReader/inputFileReader.cc"
 #include "../../src/parallelNucleationList/parallelNucleationList.cc"
@@ -99,6 +116,10 @@ class unitTest
 	bool test_get_entry_name_ending_list();
 	bool test_load_BC_list();
 	bool test_setOutputTimeSteps();
+	bool test_embeddedRungeKuttaTableau();
+	bool test_adamsBashforthCoefficients();
+	bool test_krylovPhiFunctions();
+	bool test_denseSymmetricFunctions();
 };
 
 #include "variableAttributeLoader_test.cc"
@@ -111,3 +132,7 @@ class unitTest
 #include "test_get_subsection_entry_list.h"
 #include "test_get_entry_name_ending_list.h"
 #include "test_load_BC_list.h"
+#include "test_embeddedRungeKuttaTableau.h"
+#include "test_adamsBashforthCoefficients.h"
+#include "test_krylovPhiFunctions.h"
+#include "test_denseSymmetricFunctions.h"